@@ -0,0 +1,359 @@
+#include "AllocationTracker.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h> // _aligned_malloc: в MSVC нет std::aligned_alloc
+#endif
+
+namespace AllocationTracker {
+namespace {
+
+constexpr uint64_t MAX_LOGGED_FRAMES = 20; // Дальше кадры сверх бюджета только считаются
+constexpr int MAX_LEAK_GROUPS = 32;
+
+// Заголовок перед каждым блоком: живые блоки связаны в список, чтобы найти утечки
+struct BlockHeader {
+    BlockHeader* prev;
+    BlockHeader* next;
+    void* base; // Начало выделения, см. systemAllocate
+    size_t size;
+    const char* phase; // nullptr - вне фаз
+    uint32_t frame;
+    uint32_t overAligned; // Блок выделен функцией для выравнивания больше max_align_t
+};
+static_assert(sizeof(BlockHeader) % alignof(std::max_align_t) == 0, "заголовок ломает выравнивание блока");
+
+// Только POD: operator new вызывается и до, и после конструкторов статических объектов
+struct ThreadState {
+    int phase; // Номер фазы + 1, 0 - вне фаз
+    int phaseCount;
+    const char* phaseNames[MAX_PHASES];
+    uint64_t phaseAllocations[MAX_PHASES];
+    uint64_t phaseBytes[MAX_PHASES];
+    uint64_t allocations;
+    uint64_t bytes;
+    uint64_t frame;
+};
+
+thread_local ThreadState threadState;
+thread_local FrameReport lastFrame;
+
+std::mutex mutex; // Список блоков и общая статистика
+BlockHeader* liveBlocks = nullptr;
+Stats stats;
+bool started = false;
+uint64_t budget = 0;
+uint64_t framesToSkip = 0;
+uint64_t loggedFrames = 0;
+std::FILE* log = nullptr;
+
+size_t roundUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void* systemAllocate(size_t size, size_t alignment, bool overAligned) {
+    if (!overAligned) {
+        return std::malloc(size);
+    }
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    return std::aligned_alloc(alignment, roundUp(size, alignment));
+#endif
+}
+
+void systemFree(void* base, bool overAligned) {
+#ifdef _WIN32
+    if (overAligned) {
+        _aligned_free(base);
+        return;
+    }
+#else
+    (void)overAligned;
+#endif
+    std::free(base);
+}
+
+void* allocate(size_t size, size_t alignment) {
+    alignment = std::max(alignment, alignof(std::max_align_t));
+    const size_t headerSpace = roundUp(sizeof(BlockHeader), alignment);
+    if (size > SIZE_MAX - headerSpace - alignment) {
+        throw std::bad_alloc();
+    }
+    const bool overAligned = alignment > alignof(std::max_align_t);
+    void* base;
+    while (true) {
+        base = systemAllocate(headerSpace + size, alignment, overAligned);
+        if (base) {
+            break;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+
+    char* user = static_cast<char*>(base) + headerSpace;
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(user) - 1;
+    ThreadState& state = threadState;
+    header->base = base;
+    header->size = size;
+    header->phase = state.phase ? state.phaseNames[state.phase - 1] : nullptr;
+    header->frame = static_cast<uint32_t>(state.frame);
+    header->overAligned = overAligned ? 1 : 0;
+    ++state.allocations;
+    state.bytes += size;
+    if (state.phase) {
+        ++state.phaseAllocations[state.phase - 1];
+        state.phaseBytes[state.phase - 1] += size;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    header->prev = nullptr;
+    header->next = liveBlocks;
+    if (liveBlocks) {
+        liveBlocks->prev = header;
+    }
+    liveBlocks = header;
+    ++stats.liveBlocks;
+    stats.liveBytes += size;
+    ++stats.total.allocations;
+    stats.total.bytes += size;
+    return user;
+}
+
+void* allocateNothrow(size_t size, size_t alignment) noexcept {
+    try {
+        return allocate(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void deallocate(void* ptr) noexcept {
+    if (!ptr) {
+        return;
+    }
+    BlockHeader* header = static_cast<BlockHeader*>(ptr) - 1;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (header->prev) {
+            header->prev->next = header->next;
+        } else {
+            liveBlocks = header->next;
+        }
+        if (header->next) {
+            header->next->prev = header->prev;
+        }
+        --stats.liveBlocks;
+        stats.liveBytes -= header->size;
+    }
+    systemFree(header->base, header->overAligned != 0);
+}
+
+void reportAtExit() {
+    report(log);
+}
+
+} // namespace
+
+void start(uint64_t allocationBudget, uint64_t warmupFrames, std::FILE* out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    budget = allocationBudget;
+    framesToSkip = warmupFrames;
+    log = out;
+    if (!started) {
+        started = true;
+        std::atexit(reportAtExit);
+    }
+}
+
+void skipFrames(uint64_t count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    framesToSkip = std::max(framesToSkip, count);
+}
+
+void endFrame() {
+    ThreadState& state = threadState;
+    FrameReport frame;
+    frame.frame = state.frame;
+    frame.total = Usage{state.allocations, state.bytes};
+    frame.phaseCount = state.phaseCount;
+    for (int i = 0; i < state.phaseCount; ++i) {
+        frame.phaseNames[i] = state.phaseNames[i];
+        frame.phases[i] = Usage{state.phaseAllocations[i], state.phaseBytes[i]};
+        state.phaseAllocations[i] = 0;
+        state.phaseBytes[i] = 0;
+    }
+    state.allocations = 0;
+    state.bytes = 0;
+    ++state.frame;
+    lastFrame = frame;
+
+    bool print = false;
+    std::FILE* out;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!started) {
+            return;
+        }
+        if (framesToSkip > 0) {
+            --framesToSkip;
+            return;
+        }
+        ++stats.frames;
+        if (frame.total.allocations > stats.worstFrame.allocations) {
+            stats.worstFrame = frame.total;
+        }
+        if (frame.total.allocations > budget) {
+            ++stats.overBudgetFrames;
+            print = loggedFrames < MAX_LOGGED_FRAMES;
+            loggedFrames += print ? 1 : 0;
+        }
+        out = log;
+    }
+    if (print && out) {
+        std::fprintf(out, "alloc: frame %llu over budget: %llu allocations, %llu bytes",
+                     static_cast<unsigned long long>(frame.frame),
+                     static_cast<unsigned long long>(frame.total.allocations),
+                     static_cast<unsigned long long>(frame.total.bytes));
+        for (int i = 0; i < frame.phaseCount; ++i) {
+            if (frame.phases[i].allocations > 0) {
+                std::fprintf(out, " [%s: %llu, %llu B]", frame.phaseNames[i],
+                             static_cast<unsigned long long>(frame.phases[i].allocations),
+                             static_cast<unsigned long long>(frame.phases[i].bytes));
+            }
+        }
+        std::fputc('\n', out);
+    }
+}
+
+FrameReport getLastFrame() {
+    return lastFrame;
+}
+
+Stats getStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void report(std::FILE* out) {
+    if (!out) {
+        return;
+    }
+    struct LeakGroup {
+        const char* phase;
+        uint64_t blocks;
+        uint64_t bytes;
+        uint64_t firstFrame;
+    };
+    LeakGroup groups[MAX_LEAK_GROUPS];
+    int groupCount = 0;
+    uint64_t outsideBlocks = 0;
+    uint64_t outsideBytes = 0;
+    Stats snapshot;
+    uint64_t frameBudget;
+    {
+        // Под блокировкой ничего не выделяем: только массив на стеке
+        std::lock_guard<std::mutex> lock(mutex);
+        snapshot = stats;
+        frameBudget = budget;
+        for (BlockHeader* block = liveBlocks; block; block = block->next) {
+            if (!block->phase) {
+                ++outsideBlocks;
+                outsideBytes += block->size;
+                continue;
+            }
+            int g = 0;
+            while (g < groupCount && std::strcmp(groups[g].phase, block->phase) != 0) {
+                ++g;
+            }
+            if (g == groupCount) {
+                if (groupCount == MAX_LEAK_GROUPS) {
+                    continue;
+                }
+                groups[groupCount++] = LeakGroup{block->phase, 0, 0, block->frame};
+            }
+            ++groups[g].blocks;
+            groups[g].bytes += block->size;
+            groups[g].firstFrame = std::min<uint64_t>(groups[g].firstFrame, block->frame);
+        }
+    }
+
+    auto u = [](uint64_t value) { return static_cast<unsigned long long>(value); };
+    std::fprintf(out, "alloc: %llu frames checked, %llu over budget of %llu allocations, worst %llu allocations / %llu bytes\n",
+                 u(snapshot.frames), u(snapshot.overBudgetFrames), u(frameBudget),
+                 u(snapshot.worstFrame.allocations), u(snapshot.worstFrame.bytes));
+    std::fprintf(out, "alloc: %llu allocations, %llu bytes in total; %llu blocks, %llu bytes still live\n",
+                 u(snapshot.total.allocations), u(snapshot.total.bytes), u(snapshot.liveBlocks), u(snapshot.liveBytes));
+    for (int g = 0; g < groupCount; ++g) {
+        std::fprintf(out, "alloc: leaked in phase \"%s\": %llu blocks, %llu bytes (earliest from frame %llu)\n",
+                     groups[g].phase, u(groups[g].blocks), u(groups[g].bytes), u(groups[g].firstFrame));
+    }
+    std::fprintf(out, "alloc: outside phases (startup, static objects): %llu blocks, %llu bytes\n",
+                 u(outsideBlocks), u(outsideBytes));
+}
+
+Phase::Phase(const char* name) {
+    ThreadState& state = threadState;
+    previous = state.phase;
+    int index = 0;
+    while (index < state.phaseCount && state.phaseNames[index] != name &&
+           std::strcmp(state.phaseNames[index], name) != 0) {
+        ++index;
+    }
+    if (index == state.phaseCount) {
+        if (state.phaseCount == MAX_PHASES) {
+            return; // Таблица полна: выделения идут в фазу, открытую раньше
+        }
+        state.phaseNames[state.phaseCount++] = name;
+    }
+    state.phase = index + 1;
+}
+
+Phase::~Phase() {
+    threadState.phase = previous;
+}
+
+} // namespace AllocationTracker
+
+// Замена глобальных операторов: все варианты сходятся в allocate / deallocate
+
+void* operator new(size_t size) { return AllocationTracker::allocate(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size) { return AllocationTracker::allocate(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, std::align_val_t alignment) {
+    return AllocationTracker::allocate(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return AllocationTracker::allocate(size, static_cast<size_t>(alignment));
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return AllocationTracker::allocateNothrow(size, alignof(std::max_align_t));
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return AllocationTracker::allocateNothrow(size, alignof(std::max_align_t));
+}
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return AllocationTracker::allocateNothrow(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return AllocationTracker::allocateNothrow(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept { AllocationTracker::deallocate(ptr); }
+void operator delete[](void* ptr) noexcept { AllocationTracker::deallocate(ptr); }
+void operator delete(void* ptr, size_t) noexcept { AllocationTracker::deallocate(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { AllocationTracker::deallocate(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { AllocationTracker::deallocate(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { AllocationTracker::deallocate(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { AllocationTracker::deallocate(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { AllocationTracker::deallocate(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { AllocationTracker::deallocate(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { AllocationTracker::deallocate(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { AllocationTracker::deallocate(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { AllocationTracker::deallocate(ptr); }
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// Учет выделений памяти через замену глобальных operator new/delete (опция сборки
+// TRACK_ALLOCATIONS). Счетчики кадра ведутся в каждом потоке свои и раскладываются
+// по фазам (ARCADE_ALLOC_PHASE); кадр с числом выделений больше бюджета попадает в лог.
+// При выходе печатаются блоки, выделенные внутри фаз и так и не освобожденные.
+// Без опции AllocationTracker.cpp не собирается, а макрос раскрывается в пустоту
+namespace AllocationTracker {
+
+inline constexpr int MAX_PHASES = 16; // Фаз на поток; выделения сверх - только в итог кадра
+
+struct Usage {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
+struct FrameReport {
+    uint64_t frame = 0;
+    Usage total;
+    int phaseCount = 0;
+    const char* phaseNames[MAX_PHASES] = {};
+    Usage phases[MAX_PHASES];
+};
+
+struct Stats {
+    uint64_t frames = 0;           // Проверенных кадров
+    uint64_t overBudgetFrames = 0;
+    Usage worstFrame;
+    Usage total;                   // Все потоки с начала программы
+    uint64_t liveBlocks = 0;
+    uint64_t liveBytes = 0;
+};
+
+// Бюджет - выделений за кадр (0 - игра без выделений). Первые warmupFrames кадров
+// не проверяются: в них растут буферы. При выходе печатает итог и утечки в log
+void start(uint64_t allocationBudget, uint64_t warmupFrames = 120, std::FILE* log = stderr);
+void skipFrames(uint64_t count); // Например, с начала новой партии
+// Конец кадра текущего потока: выделения с прошлого вызова сверяются с бюджетом
+void endFrame();
+FrameReport getLastFrame(); // Последний законченный кадр текущего потока
+Stats getStats();
+void report(std::FILE* out); // Итог и блоки, выделенные в фазах и еще живые
+
+// Выделения текущего потока до конца области относятся к фазе name (строковый литерал)
+class Phase {
+public:
+    explicit Phase(const char* name);
+    ~Phase();
+    Phase(const Phase&) = delete;
+    Phase& operator=(const Phase&) = delete;
+
+private:
+    int previous;
+};
+
+} // namespace AllocationTracker
+
+#ifdef ARCADE_TRACK_ALLOCATIONS
+#define ARCADE_ALLOC_CONCAT_IMPL(a, b) a##b
+#define ARCADE_ALLOC_CONCAT(a, b) ARCADE_ALLOC_CONCAT_IMPL(a, b)
+#define ARCADE_ALLOC_PHASE(name) ::AllocationTracker::Phase ARCADE_ALLOC_CONCAT(allocPhase, __LINE__)(name)
+#else
+#define ARCADE_ALLOC_PHASE(name) ((void)0)
+#endif
@@ -0,0 +1,135 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+// Запись и чтение двоичных данных: числа фиксированной длины в little-endian
+// и целые переменной длины (varint, zigzag для знаковых).
+// Используется форматом сохранений, дельтами снимков и сетевыми пакетами
+
+class ByteWriter {
+public:
+    explicit ByteWriter(std::vector<uint8_t>& out) : out(out) {}
+
+    void u8(uint8_t value) { out.push_back(value); }
+    void u16(uint16_t value) {
+        out.push_back(static_cast<uint8_t>(value));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+    }
+    void u32(uint32_t value) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            out.push_back(static_cast<uint8_t>(value >> shift));
+        }
+    }
+    void u64(uint64_t value) {
+        u32(static_cast<uint32_t>(value));
+        u32(static_cast<uint32_t>(value >> 32));
+    }
+    void i32(int32_t value) { u32(static_cast<uint32_t>(value)); }
+    void f32(float value) { u32(std::bit_cast<uint32_t>(value)); }
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+    void zigzag(int64_t value) {
+        varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+    void bytes(const void* data, size_t size) {
+        const uint8_t* begin = static_cast<const uint8_t*>(data);
+        out.insert(out.end(), begin, begin + size);
+    }
+
+private:
+    std::vector<uint8_t>& out;
+};
+
+// Чтение с проверкой границ: после первой ошибки все чтения возвращают нули, а ok() - false
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+    bool ok() const { return !failed; }
+    bool atEnd() const { return pos == size; }
+    size_t remaining() const { return size - pos; }
+    const uint8_t* current() const { return data + pos; }
+
+    uint8_t u8() {
+        if (!require(1)) return 0;
+        return data[pos++];
+    }
+    uint16_t u16() {
+        if (!require(2)) return 0;
+        uint16_t value = static_cast<uint16_t>(data[pos] | (data[pos + 1] << 8));
+        pos += 2;
+        return value;
+    }
+    uint32_t u32() {
+        if (!require(4)) return 0;
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value |= static_cast<uint32_t>(data[pos + i]) << (8 * i);
+        }
+        pos += 4;
+        return value;
+    }
+    uint64_t u64() {
+        uint64_t low = u32();
+        return low | (static_cast<uint64_t>(u32()) << 32);
+    }
+    int32_t i32() { return static_cast<int32_t>(u32()); }
+    float f32() { return std::bit_cast<float>(u32()); }
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (!require(1)) return 0;
+            uint8_t byte = data[pos++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        failed = true;
+        return 0;
+    }
+    int64_t zigzag() {
+        uint64_t value = varint();
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+    bool bytes(void* dest, size_t count) {
+        if (!require(count)) return false;
+        std::memcpy(dest, data + pos, count);
+        pos += count;
+        return true;
+    }
+    bool skip(size_t count) {
+        if (!require(count)) return false;
+        pos += count;
+        return true;
+    }
+    // Число элементов, не превышающее то, что физически может поместиться в остатке данных
+    bool count(uint32_t& outCount, size_t minRecordSize) {
+        outCount = u32();
+        if (failed || outCount > remaining() / minRecordSize) {
+            failed = true;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    bool require(size_t count) {
+        if (failed || count > size - pos) {
+            failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    const uint8_t* data;
+    size_t size;
+    size_t pos = 0;
+    bool failed = false;
+};
@@ -0,0 +1,84 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+
+FrameArena::FrameArena(size_t initialCapacity) {
+    blocks.reserve(8);
+    addBlock(std::max<size_t>(initialCapacity, 256));
+    current = FrameStats{};
+    totalHeapAllocations = 0; // Начальный блок не считается обращением кадра к куче
+}
+
+void FrameArena::addBlock(size_t minSize) {
+    // Каждый следующий блок не меньше всех предыдущих вместе: число блоков за кадр растет как логарифм
+    size_t size = std::max(minSize, getCapacity());
+    blocks.push_back(Block{std::make_unique<std::byte[]>(size), size});
+    ++current.heapAllocations;
+    ++totalHeapAllocations;
+}
+
+size_t FrameArena::getCapacity() const {
+    size_t total = 0;
+    for (const auto& block : blocks) {
+        total += block.size;
+    }
+    return total;
+}
+
+void FrameArena::reset() {
+    last = current;
+    current = FrameStats{};
+    if (blocks.size() > 1) {
+        // Кадр не уместился в один блок: заменяем все одним, которого хватит на такой же кадр
+        size_t capacity = getCapacity();
+        blocks.clear();
+        blocks.push_back(Block{std::make_unique<std::byte[]>(capacity), capacity});
+        ++last.heapAllocations;
+        ++totalHeapAllocations;
+    }
+    blockIndex = 0;
+    offset = 0;
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment) {
+    size = std::max<size_t>(size, 1);
+    while (true) {
+        Block& block = blocks[blockIndex];
+        uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+        size_t aligned = static_cast<size_t>(((base + offset + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base);
+        if (aligned + size <= block.size) {
+            current.bytes += aligned + size - offset;
+            ++current.allocations;
+            peakBytes = std::max(peakBytes, current.bytes);
+            offset = aligned + size;
+            return block.data.get() + aligned;
+        }
+        if (blockIndex + 1 == blocks.size()) {
+            addBlock(size + alignment);
+        }
+        ++blockIndex;
+        offset = 0;
+    }
+}
+
+const char* FrameArena::format(const char* pattern, ...) {
+    char probe[128];
+    va_list args;
+    va_start(args, pattern);
+    int length = std::vsnprintf(probe, sizeof(probe), pattern, args);
+    va_end(args);
+    if (length < 0) {
+        length = 0;
+        probe[0] = '\0';
+    }
+    char* text = static_cast<char*>(allocate(static_cast<size_t>(length) + 1, 1));
+    if (static_cast<size_t>(length) < sizeof(probe)) {
+        std::copy(probe, probe + length + 1, text);
+    } else {
+        va_start(args, pattern);
+        std::vsnprintf(text, static_cast<size_t>(length) + 1, pattern, args);
+        va_end(args);
+    }
+    return text;
+}
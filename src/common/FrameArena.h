@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Арена одного кадра (тика модели или перерисовки окна). Выделение - сдвиг указателя,
+// поштучного освобождения нет: reset() в начале следующего кадра возвращает все разом.
+// Для временных буферов, списков кандидатов и строк HUD, которые не переживают кадр.
+// Если блока не хватило, из кучи берется еще один, а reset() сливает блоки в один
+// размером с пик, поэтому в установившемся режиме арена к куче не обращается
+class FrameArena {
+public:
+    struct FrameStats {
+        size_t allocations = 0;     // Выделений из арены
+        size_t bytes = 0;           // Занято байт, с учетом выравнивания
+        size_t heapAllocations = 0; // Блоков, взятых из кучи
+    };
+
+    explicit FrameArena(size_t initialCapacity = 64 * 1024);
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Начало кадра: все выделенное раньше становится недействительным
+    void reset();
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    template <typename T>
+    T* allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "arena never runs destructors");
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+    // Строка по формату printf, живет до конца кадра
+    const char* format(const char* pattern, ...)
+#if defined(__GNUC__) || defined(__clang__)
+        __attribute__((format(printf, 2, 3)))
+#endif
+        ;
+
+    const FrameStats& getCurrentFrame() const { return current; }
+    const FrameStats& getLastFrame() const { return last; } // Последний завершенный кадр
+    size_t getPeakBytes() const { return peakBytes; }
+    size_t getCapacity() const;
+    size_t getTotalHeapAllocations() const { return totalHeapAllocations; }
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    void addBlock(size_t minSize);
+
+    std::vector<Block> blocks;
+    size_t blockIndex = 0; // Текущий блок; предыдущие заполнены
+    size_t offset = 0;     // Занято в текущем блоке
+    FrameStats current;
+    FrameStats last;
+    size_t peakBytes = 0;
+    size_t totalHeapAllocations = 0;
+};
+
+// Аллокатор контейнеров поверх арены: deallocate ничего не делает, память вернется в reset().
+// Контейнер не должен пережить кадр; reserve() избавляет от брошенных при росте буферов
+template <typename T>
+class FrameAllocator {
+public:
+    using value_type = T;
+
+    explicit FrameAllocator(FrameArena& arena) : arena(&arena) {}
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U>& other) : arena(other.getArena()) {}
+
+    T* allocate(size_t count) { return static_cast<T*>(arena->allocate(sizeof(T) * count, alignof(T))); }
+    void deallocate(T*, size_t) {}
+
+    FrameArena* getArena() const { return arena; }
+    template <typename U>
+    bool operator==(const FrameAllocator<U>& other) const { return arena == other.getArena(); }
+
+private:
+    FrameArena* arena;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
@@ -0,0 +1,73 @@
+#include "LatencyTracker.h"
+#include <algorithm>
+#include <fstream>
+
+void LatencyTracker::record(Clock::time_point eventTime, Clock::time_point tickTime, Clock::time_point drawTime) {
+    using Ms = std::chrono::duration<float, std::milli>;
+    if (samples.size() < CAPACITY) {
+        samples.resize(CAPACITY);
+    }
+    samples[next] = {Ms(tickTime - eventTime).count(), Ms(drawTime - tickTime).count()};
+    next = (next + 1) % CAPACITY;
+    count = std::min(count + 1, CAPACITY);
+}
+
+void LatencyTracker::clear() {
+    next = 0;
+    count = 0;
+}
+
+float LatencyTracker::stageValue(const Sample& sample, Stage stage) {
+    switch (stage) {
+        case Stage::InputToTick: return sample.inputToTickMs;
+        case Stage::TickToDraw:  return sample.tickToDrawMs;
+        case Stage::Total:       return sample.inputToTickMs + sample.tickToDrawMs;
+    }
+    return 0.0f;
+}
+
+LatencyTracker::Percentiles LatencyTracker::getPercentiles(Stage stage) const {
+    Percentiles result;
+    if (count == 0) {
+        return result;
+    }
+    scratch.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        scratch[i] = stageValue(samples[i], stage);
+    }
+    auto at = [&](double fraction) {
+        size_t index = std::min(count - 1, static_cast<size_t>(fraction * (count - 1) + 0.5));
+        std::nth_element(scratch.begin(), scratch.begin() + index, scratch.end());
+        return static_cast<double>(scratch[index]);
+    };
+    result.p50 = at(0.50);
+    result.p95 = at(0.95);
+    result.p99 = at(0.99);
+    result.max = *std::max_element(scratch.begin(), scratch.end());
+    return result;
+}
+
+bool LatencyTracker::dumpToFile(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    const Stage stages[] = {Stage::InputToTick, Stage::TickToDraw, Stage::Total};
+    const char* names[] = {"input_to_tick", "tick_to_draw", "total"};
+    file << "# samples: " << count << "\n";
+    for (int i = 0; i < 3; ++i) {
+        Percentiles p = getPercentiles(stages[i]);
+        file << "# " << names[i] << " ms: p50 " << p.p50 << ", p95 " << p.p95
+             << ", p99 " << p.p99 << ", max " << p.max << "\n";
+    }
+
+    // Замеры в хронологическом порядке
+    file << "input_to_tick_ms,tick_to_draw_ms,total_ms\n";
+    size_t first = (count < CAPACITY) ? 0 : next;
+    for (size_t i = 0; i < count; ++i) {
+        const Sample& s = samples[(first + i) % CAPACITY];
+        file << s.inputToTickMs << "," << s.tickToDrawMs << "," << (s.inputToTickMs + s.tickToDrawMs) << "\n";
+    }
+    return file.good();
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstddef>
+
+// Замер задержки "ввод -> кадр": событие клавиатуры получено окном,
+// применено тиком модели и впервые показано отрисовкой.
+// Хранит последние CAPACITY замеров и считает по ним перцентили.
+class LatencyTracker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Stage {
+        InputToTick, // От события до тика модели, который его применил
+        TickToDraw,  // От тика до первой отрисовки результата
+        Total
+    };
+
+    struct Percentiles {
+        double p50 = 0;
+        double p95 = 0;
+        double p99 = 0;
+        double max = 0;
+    };
+
+    static constexpr size_t CAPACITY = 1024;
+
+    void record(Clock::time_point eventTime, Clock::time_point tickTime, Clock::time_point drawTime);
+    void clear();
+
+    size_t getSampleCount() const { return count; }
+    Percentiles getPercentiles(Stage stage) const; // В миллисекундах
+
+    bool dumpToFile(const std::string& filename) const;
+
+private:
+    struct Sample {
+        float inputToTickMs;
+        float tickToDrawMs;
+    };
+
+    static float stageValue(const Sample& sample, Stage stage);
+
+    std::vector<Sample> samples; // Кольцевой буфер
+    size_t next = 0;
+    size_t count = 0;
+    mutable std::vector<float> scratch;
+};
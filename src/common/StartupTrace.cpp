@@ -0,0 +1,87 @@
+#include "StartupTrace.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+StartupTrace::Phase::Phase(StartupTrace* trace, const char* name)
+    : trace(trace), name(name), start(Clock::now()) {}
+
+StartupTrace::Phase::Phase(Phase&& other) noexcept
+    : trace(other.trace), name(other.name), start(other.start) {
+    other.trace = nullptr;
+}
+
+void StartupTrace::Phase::end() {
+    if (trace) {
+        trace->add(name, start, Clock::now());
+        trace = nullptr;
+    }
+}
+
+StartupTrace::StartupTrace() : origin(Clock::now()), mainThread(std::this_thread::get_id()) {}
+
+double StartupTrace::toMs(Clock::time_point time) const {
+    return std::chrono::duration<double, std::milli>(time - origin).count();
+}
+
+double StartupTrace::getElapsedMs() const {
+    return toMs(Clock::now());
+}
+
+void StartupTrace::add(const char* name, Clock::time_point start, Clock::time_point end) {
+    bool isMain = std::this_thread::get_id() == mainThread;
+    std::lock_guard<std::mutex> lock(mutex);
+    records.push_back(Record{name, toMs(start), toMs(end) - toMs(start), isMain});
+}
+
+void StartupTrace::mark(const char* name) {
+    auto now = Clock::now();
+    add(name, now, now);
+}
+
+void StartupTrace::markFirstFrame() {
+    auto now = Clock::now();
+    add("first frame", now, now);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (firstFrameMs < 0) {
+        firstFrameMs = toMs(now);
+    }
+}
+
+bool StartupTrace::hasFirstFrame() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return firstFrameMs >= 0;
+}
+
+void StartupTrace::report(std::ostream& out) const {
+    std::vector<Record> sorted;
+    double firstFrame;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sorted = records;
+        firstFrame = firstFrameMs;
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const Record& a, const Record& b) { return a.startMs < b.startMs; });
+    out << std::fixed << std::setprecision(2);
+    out << "# startup trace, ms since main()\n";
+    if (firstFrame >= 0) {
+        out << "# first interactive frame: " << firstFrame << " ms\n";
+    }
+    // deferred - этап начат после первого кадра и его не задерживал
+    out << "phase,start_ms,duration_ms,thread,deferred\n";
+    for (const auto& record : sorted) {
+        bool deferred = firstFrame >= 0 && record.startMs > firstFrame;
+        out << record.name << "," << record.startMs << "," << record.durationMs << ","
+            << (record.mainThread ? "main" : "background") << "," << (deferred ? "yes" : "no") << "\n";
+    }
+}
+
+bool StartupTrace::writeToFile(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+    report(file);
+    return file.good();
+}
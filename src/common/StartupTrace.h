@@ -0,0 +1,63 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Трасса запуска приложения: длительность этапов (окно, сцены, загрузка карты...)
+// от старта процесса до первого интерактивного кадра. Этапы могут идти в фоновых
+// потоках и вкладываться друг в друга. Запись дешевая, поэтому ведется всегда;
+// отчет пишется по запросу (--startup-trace)
+class StartupTrace {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Этап длится до разрушения объекта (или до end())
+    class Phase {
+    public:
+        Phase(StartupTrace* trace, const char* name);
+        ~Phase() { end(); }
+        Phase(Phase&& other) noexcept;
+        Phase(const Phase&) = delete;
+        Phase& operator=(const Phase&) = delete;
+        Phase& operator=(Phase&&) = delete;
+        void end();
+
+    private:
+        StartupTrace* trace;
+        const char* name;
+        Clock::time_point start;
+    };
+
+    StartupTrace();
+
+    Phase phase(const char* name) { return Phase(this, name); }
+    void mark(const char* name); // Мгновенное событие
+    // Первый показанный кадр. Этапы, начатые позже, в отчете помечены как отложенные
+    void markFirstFrame();
+    bool hasFirstFrame() const;
+
+    double getElapsedMs() const; // С создания трассы
+    void report(std::ostream& out) const;
+    bool writeToFile(const std::string& filename) const;
+
+private:
+    struct Record {
+        const char* name;
+        double startMs;
+        double durationMs; // 0 у мгновенных событий
+        bool mainThread;
+    };
+
+    void add(const char* name, Clock::time_point start, Clock::time_point end);
+    double toMs(Clock::time_point time) const;
+
+    Clock::time_point origin;
+    std::thread::id mainThread;
+    mutable std::mutex mutex;
+    std::vector<Record> records;
+    double firstFrameMs = -1; // < 0, пока кадра не было
+};
@@ -0,0 +1,138 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+thread_local int currentWorkerIndex = -1;
+
+bool pinToCore(std::thread& thread, int core) {
+#if defined(_WIN32)
+    return SetThreadAffinityMask(thread.native_handle(), DWORD_PTR(1) << (core % (8 * sizeof(DWORD_PTR)))) != 0;
+#elif defined(__linux__)
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(core % CPU_SETSIZE, &cpus);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus) == 0;
+#else
+    (void)thread;
+    (void)core;
+    return false; // Закрепление не поддерживается: планировщик ОС решает сам
+#endif
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(int threadCount, bool pinThreads) {
+    int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    if (threadCount <= 0) {
+        threadCount = cores;
+    }
+    workers.resize(threadCount);
+    threads.reserve(threadCount);
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&ThreadPool::workerLoop, this, i);
+        if (pinThreads && threadCount <= cores) {
+            workers[i].pinned = pinToCore(threads.back(), i);
+        }
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        allDone.wait(lock, [this] { return pendingTasks == 0; });
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(int worker, Task task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        workers[worker % workers.size()].queue.push_back(std::move(task));
+        ++pendingTasks;
+    }
+    workAvailable.notify_all();
+}
+
+void ThreadPool::submit(Task task) {
+    int worker;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        worker = nextWorker;
+        nextWorker = (nextWorker + 1) % static_cast<int>(workers.size());
+    }
+    submit(worker, std::move(task));
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    allDone.wait(lock, [this] { return pendingTasks == 0; });
+}
+
+void ThreadPool::runOnAll(const std::function<void(int)>& job) {
+    std::unique_lock<std::mutex> lock(mutex);
+    broadcastJob = &job;
+    broadcastRemaining = static_cast<int>(workers.size());
+    ++broadcastGeneration;
+    workAvailable.notify_all();
+    allDone.wait(lock, [this] { return broadcastRemaining == 0; });
+    broadcastJob = nullptr;
+}
+
+int ThreadPool::currentWorker() {
+    return currentWorkerIndex;
+}
+
+void ThreadPool::workerLoop(int index) {
+    currentWorkerIndex = index;
+    uint64_t seenGeneration = 0;
+    while (true) {
+        Task task;
+        const std::function<void(int)>* job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workAvailable.wait(lock, [&] {
+                return stopping || !workers[index].queue.empty() || broadcastGeneration != seenGeneration;
+            });
+            if (broadcastGeneration != seenGeneration) {
+                seenGeneration = broadcastGeneration;
+                job = broadcastJob;
+            } else if (!workers[index].queue.empty()) {
+                task = std::move(workers[index].queue.front());
+                workers[index].queue.pop_front();
+            } else {
+                return; // stopping и задач не осталось
+            }
+        }
+        if (job) {
+            (*job)(index);
+            bool last;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                last = --broadcastRemaining == 0;
+            }
+            if (last) {
+                allDone.notify_all();
+            }
+            continue;
+        }
+        task();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --pendingTasks;
+        }
+        allDone.notify_all();
+    }
+}
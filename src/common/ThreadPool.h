@@ -0,0 +1,57 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул потоков с собственной очередью у каждого потока. Задачу можно отдать конкретному
+// потоку: так связанные данные (например, один матч) всегда обрабатываются на одном ядре.
+// Потоки по возможности закрепляются за ядрами (Linux, Windows)
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(int threadCount = 0, bool pinThreads = true); // 0 - по числу ядер
+    ~ThreadPool(); // Дожидается всех задач
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int getThreadCount() const { return static_cast<int>(workers.size()); }
+    bool isPinned(int worker) const { return workers[worker].pinned; }
+
+    void submit(int worker, Task task);
+    void submit(Task task); // Потоки по кругу
+    void wait();            // Пока все очереди не опустеют и задачи не завершатся
+
+    // Выполняет job(номер потока) на каждом потоке пула и ждет завершения.
+    // Без очередей и копирования job - для частых коротких шагов без выделения памяти.
+    // Вызывать с одного потока за раз
+    void runOnAll(const std::function<void(int)>& job);
+
+    // Номер потока пула, выполняющего вызов, или -1 вне пула
+    static int currentWorker();
+
+private:
+    struct Worker {
+        std::deque<Task> queue;
+        bool pinned = false;
+    };
+
+    void workerLoop(int index);
+
+    std::vector<Worker> workers;
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    int pendingTasks = 0; // В очередях и выполняющиеся
+    int nextWorker = 0;
+    bool stopping = false;
+    const std::function<void(int)>* broadcastJob = nullptr;
+    uint64_t broadcastGeneration = 0;
+    int broadcastRemaining = 0;
+    std::vector<std::thread> threads; // Последним: потоки стартуют, когда остальное готово
+};
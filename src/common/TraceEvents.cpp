@@ -0,0 +1,204 @@
+#include "TraceEvents.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace TraceEvents {
+namespace {
+
+constexpr size_t BUFFER_CAPACITY = 64 * 1024; // Событий между сбросами на диск
+constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(200);
+
+struct Event {
+    const char* name;
+    uint32_t thread;
+    int64_t startNs;    // От начала записи
+    int64_t durationNs; // < 0 - имя потока (метаданные)
+};
+
+// Два буфера: в один пишут зоны, второй фоновый поток переводит в JSON
+class Recorder {
+public:
+    ~Recorder() { stop(); }
+
+    bool start(const std::string& filename) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (file || stopping) {
+            return false; // Уже пишем или прошлая запись еще дописывается
+        }
+        file = std::fopen(filename.c_str(), "w");
+        if (!file) {
+            return false;
+        }
+        // Формат "массив событий": закрывающая скобка необязательна, поэтому
+        // трасса оборванной сессии тоже открывается
+        std::fputs("[\n", file);
+        firstEvent = true;
+        origin = Clock::now();
+        active.clear();
+        active.reserve(BUFFER_CAPACITY);
+        spare.reserve(BUFFER_CAPACITY);
+        stats = Stats{};
+        // Поток записи получает файл сам: в stop() поле file обнуляется раньше,
+        // чем он допишет последний буфер
+        writer = std::thread([this, out = file]() { run(out); });
+        recording.store(true, std::memory_order_release);
+        return true;
+    }
+
+    void stop() {
+        std::FILE* out;
+        {
+            // file обнуляется под блокировкой: add() на других потоках после этого
+            // просто отбрасывает события
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!file) {
+                return;
+            }
+            recording.store(false, std::memory_order_relaxed);
+            stopping = true;
+            out = file;
+            file = nullptr;
+        }
+        wakeWriter.notify_one();
+        writer.join();
+        std::fputs("\n]\n", out);
+        std::fclose(out);
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = false;
+    }
+
+    void add(const char* name, int64_t startNs, int64_t durationNs) {
+        uint32_t thread = threadId();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!file) {
+            return;
+        }
+        if (active.size() >= BUFFER_CAPACITY) {
+            ++stats.dropped; // Поток записи отстал: теряем событие, но не ждем диска
+            return;
+        }
+        active.push_back(Event{name, thread, startNs, durationNs});
+        if (active.size() == BUFFER_CAPACITY / 2) {
+            wakeWriter.notify_one();
+        }
+    }
+
+    int64_t sinceOrigin(Clock::time_point time) const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time - origin).count();
+    }
+
+    Stats getStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+
+private:
+    static uint32_t threadId() {
+        static std::atomic<uint32_t> nextId{1};
+        thread_local uint32_t id = nextId.fetch_add(1);
+        return id;
+    }
+
+    void run(std::FILE* out) {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wakeWriter.wait_for(lock, FLUSH_INTERVAL, [this]() {
+                return stopping || active.size() >= BUFFER_CAPACITY / 2;
+            });
+            active.swap(spare);
+            bool done = stopping;
+            lock.unlock();
+
+            writeEvents(spare, out);
+            spare.clear();
+
+            lock.lock();
+            stats.written += written;
+            written = 0;
+            if (done && active.empty()) {
+                return;
+            }
+        }
+    }
+
+    void writeEvents(const std::vector<Event>& events, std::FILE* out) {
+        char line[256];
+        for (const auto& event : events) {
+            int length;
+            if (event.durationNs < 0) {
+                length = std::snprintf(line, sizeof(line),
+                    "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                    firstEvent ? "" : ",\n", event.thread, event.name);
+            } else {
+                length = std::snprintf(line, sizeof(line),
+                    "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    firstEvent ? "" : ",\n", event.name, event.thread,
+                    event.startNs / 1000.0, event.durationNs / 1000.0);
+            }
+            if (length > 0) {
+                std::fwrite(line, 1, std::min(static_cast<size_t>(length), sizeof(line) - 1), out);
+                firstEvent = false;
+                ++written;
+            }
+        }
+        std::fflush(out);
+    }
+
+    std::mutex mutex;
+    std::condition_variable wakeWriter;
+    std::vector<Event> active;
+    std::vector<Event> spare; // Только у потока записи, пока mutex отпущен
+    std::FILE* file = nullptr;
+    bool firstEvent = true;
+    bool stopping = false;
+    uint64_t written = 0;
+    Stats stats;
+    Clock::time_point origin;
+    std::thread writer;
+};
+
+Recorder& recorder() {
+    static Recorder instance;
+    return instance;
+}
+
+} // namespace
+
+bool start(const std::string& filename) {
+    Recorder& instance = recorder();
+    if (!instance.start(filename)) {
+        return false;
+    }
+    static bool exitHandlerSet = false;
+    if (!exitHandlerSet) {
+        // Выход через std::exit не должен оставлять трассу недописанной
+        std::atexit([]() { recorder().stop(); });
+        exitHandlerSet = true;
+    }
+    return true;
+}
+
+void stop() {
+    recorder().stop();
+}
+
+void setThreadName(const char* name) {
+    recorder().add(name, 0, -1);
+}
+
+void record(const char* name, Clock::time_point start, Clock::time_point end) {
+    Recorder& instance = recorder();
+    int64_t startNs = instance.sinceOrigin(start);
+    instance.add(name, startNs, instance.sinceOrigin(end) - startNs);
+}
+
+Stats getStats() {
+    return recorder().getStats();
+}
+
+} // namespace TraceEvents
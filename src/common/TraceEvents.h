@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Запись длительностей участков кода в формате Chrome trace-event JSON
+// (chrome://tracing, ui.perfetto.dev). Участок отмечается ARCADE_TRACE_ZONE("имя") -
+// зона длится до конца блока. События копятся в буфере фиксированного размера и пишутся
+// в файл фоновым потоком; если поток не успевает, лишние события отбрасываются и считаются.
+// Без опции сборки TRACE_EVENTS макросы раскрываются в пустоту
+namespace TraceEvents {
+
+using Clock = std::chrono::steady_clock;
+
+// Начинает запись; false, если файл не открылся или запись уже идет
+bool start(const std::string& filename);
+void stop(); // Дописывает буфер и закрывает файл; вызывается и при выходе из программы
+
+inline std::atomic<bool> recording{false};
+inline bool isRecording() { return recording.load(std::memory_order_acquire); }
+
+// Имя текущего потока в просмотрщике. name и имена зон - строковые литералы:
+// хранится только указатель
+void setThreadName(const char* name);
+void record(const char* name, Clock::time_point start, Clock::time_point end);
+
+struct Stats {
+    uint64_t written = 0;
+    uint64_t dropped = 0; // Буфер был полон
+};
+Stats getStats();
+
+class Zone {
+public:
+    explicit Zone(const char* name) : name(name) {
+        if (isRecording()) {
+            start = Clock::now();
+        }
+    }
+    ~Zone() {
+        if (start != Clock::time_point{}) {
+            record(name, start, Clock::now());
+        }
+    }
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+
+private:
+    const char* name;
+    Clock::time_point start{}; // Пустое значение - запись не шла при входе в зону
+};
+
+} // namespace TraceEvents
+
+#ifdef ARCADE_TRACE_EVENTS
+#define ARCADE_TRACE_CONCAT_IMPL(a, b) a##b
+#define ARCADE_TRACE_CONCAT(a, b) ARCADE_TRACE_CONCAT_IMPL(a, b)
+#define ARCADE_TRACE_ZONE(name) ::TraceEvents::Zone ARCADE_TRACE_CONCAT(traceZone, __LINE__)(name)
+#define ARCADE_TRACE_THREAD(name) ::TraceEvents::setThreadName(name)
+#else
+#define ARCADE_TRACE_ZONE(name) ((void)0)
+#define ARCADE_TRACE_THREAD(name) ((void)0)
+#endif
@@ -1,11 +1,11 @@
 #include "AboutController.h"
 
-AboutController::AboutController() {
+AboutController::AboutController(SceneManager& scenes) {
     model = std::make_unique<AboutModel>();
     view = std::make_unique<AboutView>();
     
-    // Представление настраивает себя самостоятельно
-    view->setupUI();
+    // Представление создает свою сцену в общем окне
+    view->setupUI(scenes);
     
     // Устанавливаем обработчики событий
     view->setBackCallback([this]() {
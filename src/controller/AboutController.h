@@ -6,7 +6,7 @@
 
 class AboutController : public BaseController {
 public:
-    AboutController();
+    explicit AboutController(SceneManager& scenes);
     ~AboutController();
     
     void show() override;
@@ -2,15 +2,59 @@
 #include "MenuController.h"
 #include "GameController.h"
 #include "AboutController.h"
+#include "../model/GameModel.h"
+#include "../model/MapLayout.h"
+#ifdef ARCADE_EMBED_MAPS
+#include "../model/EmbeddedMaps.h"
+#endif
+#include "../view/GameView.h"
+#include "../common/TraceEvents.h"
 #include <FL/Fl.H>
-#include <cstdlib>
+#include <chrono>
+#include <iostream>
 
-ApplicationController::ApplicationController() 
-    : currentController(nullptr), previousController(nullptr) {
+namespace {
+const char* const MAP_FILE = "../resources/map.txt";
+}
+
+ApplicationController::ApplicationController(const std::string& serverAddress, StartupTrace& startupTrace,
+                                             const std::string& traceFile)
+    : serverAddress(serverAddress), startupTrace(startupTrace), traceFile(traceFile) {
+#ifdef ARCADE_EMBED_MAPS
+    mapLayout = EmbeddedMaps::getDefault(); // Вшита в программу: файл не нужен
+#endif
+    // Карта и модель первой партии готовятся в фоне с самого начала: на медленном диске это самое долгое
+    prepareNextGame();
+
+    {
+        auto phase = startupTrace.phase("window");
+        scenes = std::make_unique<SceneManager>();
+    }
+    {
+        auto phase = startupTrace.phase("menu scene");
+        menuController = std::make_unique<MenuController>(*scenes);
+        menuController->setNewGameCallback([this]() { 
+            showGame();
+        });
+        menuController->setAboutCallback([this]() { 
+            showAbout();
+        });
+        menuController->setExitCallback([this]() { 
+            // Закрытие окна завершает Fl::run: деструкторы отработают до отчета об утечках
+            scenes->getWindow()->hide();
+        });
+    }
+
+    // Все остальное - после первого показанного кадра меню
+    scenes->setFirstDrawHandler([this]() {
+        this->startupTrace.markFirstFrame();
+        Fl::add_timeout(0.0, continueStartup, this);
+    });
     showMenu();
 }
 
 ApplicationController::~ApplicationController() {
+    Fl::remove_timeout(continueStartup, this);
     cleanup();
 }
 
@@ -18,97 +62,131 @@ void ApplicationController::run() {
     Fl::run();
 }
 
-void ApplicationController::showMenu() {
-    // Создаем новый контроллер меню
-    auto menuController = std::make_unique<MenuController>();
-    
-    // Настраиваем обработчики
-    menuController->setNewGameCallback([this]() { 
-        showGame();
-    });
-    
-    menuController->setAboutCallback([this]() { 
-        showAbout();
-    });
-    
-    menuController->setExitCallback([this]() { 
-        std::exit(0); 
-    });
-    
-    // Показываем новый контроллер
-    menuController->show();
-    
-    // Сохраняем текущий контроллер как предыдущий
-    previousController = std::move(currentController);
-    
-    // Устанавливаем новый контроллер как текущий
-    currentController = std::move(menuController);
-    
-    // Удаляем предыдущий контроллер через отложенный вызов
-    Fl::add_timeout(0.1, [](void* data) {
-        ApplicationController* app = static_cast<ApplicationController*>(data);
-        if (app) {
-            app->previousController.reset();
+void ApplicationController::continueStartup(void* data) {
+    ARCADE_TRACE_ZONE("continueStartup");
+    ApplicationController* app = static_cast<ApplicationController*>(data);
+    // По одному шагу за вызов, чтобы между шагами обрабатывались события
+    switch (app->startupStep++) {
+        case 0: {
+            auto phase = app->startupTrace.phase("fonts");
+            GameView::preloadFonts();
+            break;
+        }
+        case 1:
+            app->ensureGameController();
+            break;
+        case 2:
+            app->ensureAboutController();
+            break;
+        default: {
+            // Отчет пишется, когда готова и фоновая загрузка первой партии
+            bool prepared = !app->nextGame.valid() ||
+                            app->nextGame.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            if (!prepared) {
+                --app->startupStep;
+                Fl::repeat_timeout(0.05, continueStartup, data);
+                return;
+            }
+            if (!app->traceFile.empty() && !app->startupTrace.writeToFile(app->traceFile)) {
+                std::cerr << "Не удалось записать трассу запуска в " << app->traceFile << "\n";
+            }
+            return;
         }
-    }, this);
+    }
+    Fl::repeat_timeout(0.0, continueStartup, data);
 }
 
-void ApplicationController::showGame() {
-    // Создаем новый контроллер игры
-    auto gameController = std::make_unique<GameController>();
-    
-    // Настраиваем обработчики
-    gameController->setBackToMenuCallback([this]() { 
-        showMenu();
-    });
-    
-    // Показываем новый контроллер
-    gameController->show();
-    
-    // Сохраняем текущий контроллер как предыдущий
-    previousController = std::move(currentController);
-    
-    // Устанавливаем новый контроллер как текущий
-    currentController = std::move(gameController);
-    
-    // Удаляем предыдущий контроллер через отложенный вызов
-    Fl::add_timeout(0.1, [](void* data) {
-        ApplicationController* app = static_cast<ApplicationController*>(data);
-        if (app) {
-            app->previousController.reset();
+void ApplicationController::prepareNextGame() {
+    // Разбор карты и построение графа путей не задерживают интерфейс
+    std::shared_ptr<const MapLayout> layout = mapLayout;
+    StartupTrace* trace = startupTrace.hasFirstFrame() ? nullptr : &startupTrace; // Трассируется только запуск
+    nextGame = std::async(std::launch::async, [layout, trace]() {
+        PreparedGame prepared;
+        if (layout) {
+            prepared.layout = layout;
+        } else {
+            StartupTrace::Phase phase = trace ? trace->phase("map load") : StartupTrace::Phase(nullptr, nullptr);
+            prepared.layout = MapLayout::fromFile(MAP_FILE);
         }
-    }, this);
+        if (prepared.layout) {
+            StartupTrace::Phase phase = trace ? trace->phase("game model") : StartupTrace::Phase(nullptr, nullptr);
+            auto model = std::make_unique<GameModel>();
+            if (model->init(prepared.layout)) {
+                model->preparePathfinding();
+                prepared.model = std::move(model);
+            }
+        }
+        return prepared;
+    });
+}
+
+GameController* ApplicationController::ensureGameController() {
+    if (!gameController) {
+        auto phase = startupTrace.phase("game scene");
+        gameController = std::make_unique<GameController>(*scenes, serverAddress);
+        gameController->setBackToMenuCallback([this]() { 
+            showMenu();
+        });
+    }
+    return gameController.get();
+}
+
+AboutController* ApplicationController::ensureAboutController() {
+    if (!aboutController) {
+        auto phase = startupTrace.phase("about scene");
+        aboutController = std::make_unique<AboutController>(*scenes);
+        aboutController->setBackCallback([this]() { 
+            showMenu();
+        });
+    }
+    return aboutController.get();
+}
+
+void ApplicationController::switchTo(BaseController* controller) {
+    if (currentController && currentController != controller) {
+        currentController->hide();
+    }
+    currentController = controller;
+    currentController->show();
+}
+
+void ApplicationController::showMenu() {
+    switchTo(menuController.get());
+}
+
+void ApplicationController::showGame() {
+    GameController* game = ensureGameController();
+
+    // Обычно модель уже готова; если игрок успел раньше, ждем фоновую загрузку
+    PreparedGame prepared = nextGame.valid() ? nextGame.get() : PreparedGame{};
+    if (prepared.layout) {
+        mapLayout = prepared.layout;
+    }
+    if (!prepared.model) {
+        std::cerr << "Не удалось загрузить карту " << MAP_FILE << "\n";
+        prepareNextGame(); // Файл могли вернуть на место - попробуем к следующему нажатию
+        return;
+    }
+    game->setModel(std::move(prepared.model));
+    switchTo(game);
+
+    // Следующая партия начнется с новой модели, ее строим, пока идет эта
+    prepareNextGame();
 }
 
 void ApplicationController::showAbout() {
-    // Создаем новый контроллер "О программе"
-    auto aboutController = std::make_unique<AboutController>();
-    
-    // Настраиваем обработчики
-    aboutController->setBackCallback([this]() { 
-        showMenu();
-    });
-    
-    // Показываем новый контроллер
-    aboutController->show();
-    
-    // Сохраняем текущий контроллер как предыдущий
-    previousController = std::move(currentController);
-    
-    // Устанавливаем новый контроллер как текущий
-    currentController = std::move(aboutController);
-    
-    // Удаляем предыдущий контроллер через отложенный вызов
-    Fl::add_timeout(0.1, [](void* data) {
-        ApplicationController* app = static_cast<ApplicationController*>(data);
-        if (app) {
-            app->previousController.reset();
-        }
-    }, this);
+    switchTo(ensureAboutController());
 }
 
 void ApplicationController::cleanup() {
-    // Очищаем все контроллеры
-    currentController.reset();
-    previousController.reset();
+    // Фоновая подготовка модели должна завершиться до разрушения контроллеров
+    if (nextGame.valid()) {
+        nextGame.wait();
+    }
+    // Контроллеры удаляются раньше окна, в котором живут их сцены
+    currentController = nullptr;
+    gameController.reset();
+    aboutController.reset();
+    menuController.reset();
+    scenes.reset();
 }
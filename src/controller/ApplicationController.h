@@ -1,15 +1,23 @@
 #pragma once
+#include <future>
 #include <memory>
+#include <string>
 #include "BaseController.h"
-
+#include "../common/StartupTrace.h"
+#include "../view/SceneManager.h"
 
 class MenuController;
 class GameController;
 class AboutController;
+class GameModel;
+struct MapLayout;
 
 class ApplicationController {
 public:
-    ApplicationController();
+    // serverAddress непустой - "Новая игра" подключается к серверу сетевой игры.
+    // startupTrace - трасса запуска из main; traceFile непустой - куда записать отчет о запуске
+    ApplicationController(const std::string& serverAddress, StartupTrace& startupTrace,
+                          const std::string& traceFile = "");
     ~ApplicationController();
     
     void run();
@@ -18,8 +26,33 @@ public:
     void showAbout();
 
 private:
+    // Готовая модель для следующей партии: карта разбирается один раз,
+    // модель строится в фоновом потоке, пока игрок в меню
+    struct PreparedGame {
+        std::shared_ptr<const MapLayout> layout;
+        std::unique_ptr<GameModel> model; // nullptr, если карту не удалось загрузить
+    };
+
+    void prepareNextGame();
+    void switchTo(BaseController* controller);
+    // Экраны, не нужные для первого кадра, создаются после него или по первому обращению
+    GameController* ensureGameController();
+    AboutController* ensureAboutController();
+    static void continueStartup(void* data); // Отложенная инициализация по шагу за вызов
     void cleanup();
     
-    std::unique_ptr<BaseController> currentController;
-    std::unique_ptr<BaseController> previousController; // Добавляем это поле
+    // Окно создается первым: сцены контроллеров живут в нем и удаляются последними
+    std::unique_ptr<SceneManager> scenes;
+    std::unique_ptr<MenuController> menuController;
+    std::unique_ptr<AboutController> aboutController;
+    std::unique_ptr<GameController> gameController;
+    BaseController* currentController = nullptr;
+
+    std::shared_ptr<const MapLayout> mapLayout;
+    std::future<PreparedGame> nextGame;
+    std::string serverAddress;
+
+    StartupTrace& startupTrace;
+    std::string traceFile;
+    int startupStep = 0;
 };
@@ -1,23 +1,39 @@
 #include "GameController.h"
+#include "../model/SaveGame.h"
+#include <algorithm>
+#include <iostream>
 
-GameController::GameController() {
-    model = std::make_unique<GameModel>();
+namespace {
+const char* const QUICKSAVE_FILE = "quicksave.sav";
+const char* const AUTOSAVE_FILE = "autosave.sav";
+constexpr std::chrono::seconds AUTOSAVE_INTERVAL(30);
+constexpr int AI_BUDGET_MICROSECONDS = 4000; // Четверть кадра при 60 Гц
+}
+
+GameController::GameController(SceneManager& scenes, const std::string& serverAddress)
+    : serverAddress(serverAddress) {
     view = std::make_unique<GameView>();
     
-    // Инициализируем модель
-    if (!model->init("../resources/map.txt")) {
-        // Обработка ошибки загрузки карты
-        return;
-    }
-    
-    // Настраиваем представление
-    view->setupUI();
-    view->setModel(model.get());
+    // Настраиваем представление; модель придет позже через setModel
+    view->setupUI(scenes);
     
     // Устанавливаем обработчики событий
     view->setKeyPressCallback([this](int key) -> bool {
         return handleKeyPress(key);
     });
+
+    view->setKeyReleaseCallback([this](int key) -> bool {
+        return handleKeyRelease(key);
+    });
+
+    view->setFocusLostCallback([this]() {
+        keyboard.releaseAll();
+    });
+
+    view->setTickCallback([this]() {
+        sampleInput();
+        autosaveIfDue();
+    });
     
     view->setGameOverCallback([this]() {
         if (backToMenuCallback) {
@@ -29,6 +45,11 @@ GameController::GameController() {
 GameController::~GameController() {
     // Очищаем callback перед удалением
     backToMenuCallback = nullptr;
+
+    // Незаконченная партия не теряется при выходе; деструктор saveWriter дождется записи
+    if (model && !client && (model->getState() == GameState::PLAYING || model->getState() == GameState::PAUSED)) {
+        saveGame(AUTOSAVE_FILE);
+    }
     
     if (view) {
         view->stopGame();
@@ -37,9 +58,48 @@ GameController::~GameController() {
     }
 }
 
+void GameController::setModel(std::unique_ptr<GameModel> newModel) {
+    if (view) {
+        view->stopGame();
+        view->setModel(nullptr);
+    }
+    saveWriter.flush(); // Прошлая партия могла еще записываться
+    client.reset();
+    model = std::move(newModel);
+    if (!model) {
+        return;
+    }
+
+    // Сетевая игра: модель только отображает состояние сервера
+    if (!serverAddress.empty()) {
+        NetAddress address;
+        client = std::make_unique<GameClient>();
+        if (!NetAddress::parse(serverAddress, address) || !client->connect(address, model->getMap())) {
+            std::cerr << "Не удалось подключиться к " << serverAddress << ", запускается обычная игра\n";
+            client.reset();
+        } else {
+            model->setRewindWindow(0);
+            model->clearPlayers();
+        }
+    }
+    if (!client) {
+        // Локальной игре не нужно совпадать ни с кем: лучше отложить часть ИИ, чем пропустить кадр
+        model->setAiBudget(AI_BUDGET_MICROSECONDS);
+    }
+
+    if (view) {
+        view->setModel(model.get());
+        view->setSimulationEnabled(!client);
+    }
+}
+
 void GameController::show() {
     if (view && model) {
-        model->reset();
+        keyboard.releaseAll();
+        if (!client) {
+            model->reset();
+        }
+        lastAutosave = std::chrono::steady_clock::now();
         view->show();
         view->startGame();
     }
@@ -51,6 +111,7 @@ void GameController::hide() {
         view->stopResultsTimer();
         view->hide();
     }
+    client.reset(); // Сервер освобождает место игрока сразу, а не по таймауту
 }
 
 void GameController::scheduleCleanup(CleanupFunc cleanup) {
@@ -68,8 +129,11 @@ bool GameController::handleKeyPress(int key) {
         return false;
     }
     
+    // Пауза, сохранения и перемотка - только в обычной игре: в сетевой состоянием владеет сервер
+    bool localGame = !client;
+
     // Пауза
-    if (key == 'p' || key == 'P') {
+    if (localGame && (key == 'p' || key == 'P')) {
         if (model->getState() == GameState::PLAYING) {
             model->setState(GameState::PAUSED);
         } else if (model->getState() == GameState::PAUSED) {
@@ -78,25 +142,126 @@ bool GameController::handleKeyPress(int key) {
         return true;
     }
 
-    if (model->getState() != GameState::PLAYING) return false;
+    // Профилировщик: F3 - оверлей, F4 - сохранить замеры задержки ввода
+    if (key == 65472) { // FL_F + 3
+        view->toggleProfilerOverlay();
+        return true;
+    }
+    if (key == 65473) { // FL_F + 4
+        view->dumpLatencyReport("latency_report.csv");
+        return true;
+    }
+
+    // Сохранения: F5 - быстрое сохранение, F9 - загрузить его, F10 - загрузить автосохранение
+    if (localGame && key == 65474) { // FL_F + 5
+        saveGame(QUICKSAVE_FILE);
+        return true;
+    }
+    if (localGame && key == 65478) { // FL_F + 9
+        loadGame(QUICKSAVE_FILE);
+        return true;
+    }
+    if (localGame && key == 65479) { // FL_F + 10
+        loadGame(AUTOSAVE_FILE);
+        return true;
+    }
+
+    // F7 - перемотка на несколько секунд назад (в пределах буфера модели)
+    if (localGame && key == 65476) { // FL_F + 7
+        const uint64_t rewindTicks = 5 * 60;
+        uint64_t tick = model->getTick();
+        uint64_t target = tick > rewindTicks ? tick - rewindTicks : 0;
+        model->rewindTo(std::max(target, model->getRewindBuffer().getOldestTick()));
+        keyboard.releaseAll();
+        return true;
+    }
 
+    // Движение и стрельба только отмечаются в состоянии клавиатуры,
+    // а применяются моделью один раз за тик (см. sampleInput)
     switch (key) {
         case 65362: // FL_Up
-            model->playerMove(Direction::UP);
-            return true;
         case 65364: // FL_Down
-            model->playerMove(Direction::DOWN);
-            return true;
         case 65361: // FL_Left
-            model->playerMove(Direction::LEFT);
-            return true;
         case 65363: // FL_Right
-            model->playerMove(Direction::RIGHT);
+        case ' ':
+            keyboard.keyDown(key, view->getEventTime());
             return true;
+        default:
+            return false;
+    }
+}
+
+bool GameController::handleKeyRelease(int key) {
+    switch (key) {
+        case 65362: // FL_Up
+        case 65364: // FL_Down
+        case 65361: // FL_Left
+        case 65363: // FL_Right
         case ' ':
-            model->playerFire();
+            keyboard.keyUp(key, view->getEventTime());
             return true;
         default:
             return false;
     }
 }
+
+void GameController::sampleInput() {
+    if (!model) {
+        return;
+    }
+    PlayerInput input;
+    input.move = keyboard.getMovementDirection(input.moveDirection);
+    input.fire = keyboard.isDown(' ');
+    input.hasEvent = keyboard.takePendingEvent(input.eventTime);
+    if (client) {
+        syncWithServer(input);
+    } else {
+        model->setPlayerInput(input);
+    }
+}
+
+void GameController::syncWithServer(const PlayerInput& input) {
+    client->sendInput(input);
+    client->poll();
+    if (!client->isConnected()) {
+        model->setState(GameState::GAME_OVER); // Сервер пропал: показываем итог и выходим в меню
+        return;
+    }
+    if (client->getInterpolatedState(replicatedState)) {
+        model->applyReplicatedState(replicatedState, client->getPlayerSlot());
+    }
+}
+
+void GameController::saveGame(const std::string& filename) {
+    if (!model) {
+        return;
+    }
+    GameSnapshot snapshot;
+    model->captureSnapshot(snapshot);
+    saveWriter.save(std::move(snapshot), filename);
+}
+
+bool GameController::loadGame(const std::string& filename) {
+    if (!model) {
+        return false;
+    }
+    saveWriter.flush(); // Файл мог еще записываться в фоне
+    GameSnapshot snapshot;
+    if (!SaveGame::readFile(filename, snapshot) || !model->restoreSnapshot(snapshot)) {
+        return false;
+    }
+    keyboard.releaseAll();
+    lastAutosave = std::chrono::steady_clock::now();
+    return true;
+}
+
+void GameController::autosaveIfDue() {
+    if (!model || client || model->getState() != GameState::PLAYING) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastAutosave >= AUTOSAVE_INTERVAL) {
+        lastAutosave = now;
+        saveGame(AUTOSAVE_FILE);
+    }
+}
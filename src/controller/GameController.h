@@ -1,14 +1,24 @@
 #pragma once
 #include "BaseController.h"
 #include "../model/GameModel.h"
+#include "../model/AsyncSaveWriter.h"
+#include "../net/GameClient.h"
 #include "../view/GameView.h"
+#include "KeyboardState.h"
 #include <memory>
+#include <chrono>
+#include <string>
 
 class GameController : public BaseController {
 public:
-    GameController();
+    // serverAddress "хост:порт" - сетевая игра на сервере, пустая строка - обычная
+    explicit GameController(SceneManager& scenes, const std::string& serverAddress = "");
     ~GameController();
     
+    // Модель для следующей партии, уже загруженная с картой (готовится в фоне, см. ApplicationController)
+    void setModel(std::unique_ptr<GameModel> newModel);
+    bool hasModel() const { return model != nullptr; }
+
     void show() override;
     void hide() override;
     void scheduleCleanup(CleanupFunc cleanup) override;
@@ -17,9 +27,21 @@ public:
 
 private:
     bool handleKeyPress(int key);
+    bool handleKeyRelease(int key);
+    void sampleInput(); // Снимает состояние клавиатуры и передает его модели
+    void saveGame(const std::string& filename); // Снимок сейчас, запись в фоне
+    bool loadGame(const std::string& filename);
+    void autosaveIfDue();
+    void syncWithServer(const PlayerInput& input); // Отправка управления и прием состояния
     
     std::unique_ptr<GameModel> model;
     std::unique_ptr<GameView> view;
+    KeyboardState keyboard;
+    AsyncSaveWriter saveWriter;
+    std::chrono::steady_clock::time_point lastAutosave;
+    std::unique_ptr<GameClient> client; // Только в сетевой игре
+    GameSnapshot replicatedState;
+    std::string serverAddress;
     
     CallbackFunc backToMenuCallback;
 };
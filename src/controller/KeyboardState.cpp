@@ -0,0 +1,96 @@
+#include "KeyboardState.h"
+
+void KeyboardState::keyDown(int key, TimePoint eventTime) {
+    int slot = slotOf(key);
+    if (slot < 0 || keys.test(slot)) {
+        return; // Автоповтор уже нажатой клавиши ничего не меняет
+    }
+    keys.set(slot);
+    markEvent(eventTime);
+
+    Direction dir;
+    if (directionOf(key, dir)) {
+        forgetDirection(dir);
+        directionOrder[directionCount++] = dir;
+    }
+}
+
+void KeyboardState::keyUp(int key, TimePoint eventTime) {
+    int slot = slotOf(key);
+    if (slot < 0 || !keys.test(slot)) {
+        return;
+    }
+    keys.reset(slot);
+    markEvent(eventTime);
+
+    Direction dir;
+    if (directionOf(key, dir)) {
+        forgetDirection(dir);
+    }
+}
+
+void KeyboardState::releaseAll() {
+    keys.reset();
+    directionCount = 0;
+    hasPendingEvent = false;
+}
+
+bool KeyboardState::takePendingEvent(TimePoint& outEventTime) {
+    if (!hasPendingEvent) {
+        return false;
+    }
+    outEventTime = pendingEventTime;
+    hasPendingEvent = false;
+    return true;
+}
+
+void KeyboardState::markEvent(TimePoint eventTime) {
+    if (!hasPendingEvent) {
+        hasPendingEvent = true;
+        pendingEventTime = eventTime;
+    }
+}
+
+bool KeyboardState::isDown(int key) const {
+    int slot = slotOf(key);
+    return slot >= 0 && keys.test(slot);
+}
+
+bool KeyboardState::getMovementDirection(Direction& outDir) const {
+    if (directionCount == 0) {
+        return false;
+    }
+    outDir = directionOrder[directionCount - 1];
+    return true;
+}
+
+int KeyboardState::slotOf(int key) {
+    // Обычные символы занимают первые 256 ячеек, специальные клавиши FLTK (0xff00+) - следующие
+    if (key >= 0 && key < 256) {
+        return key;
+    }
+    if (key >= 0xff00 && key <= 0xffff) {
+        return 256 + (key - 0xff00);
+    }
+    return -1;
+}
+
+bool KeyboardState::directionOf(int key, Direction& outDir) {
+    switch (key) {
+        case 65362: outDir = Direction::UP; return true;    // FL_Up
+        case 65364: outDir = Direction::DOWN; return true;  // FL_Down
+        case 65361: outDir = Direction::LEFT; return true;  // FL_Left
+        case 65363: outDir = Direction::RIGHT; return true; // FL_Right
+        default: return false;
+    }
+}
+
+void KeyboardState::forgetDirection(Direction dir) {
+    int kept = 0;
+    for (int i = 0; i < directionCount; ++i) {
+        if (directionOrder[i] != dir) {
+            directionOrder[kept++] = directionOrder[i];
+        }
+    }
+    directionCount = kept;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "../common/Direction.h"
+#include <bitset>
+#include <array>
+#include <chrono>
+
+// Битовая карта нажатых клавиш. Обновляется по событиям нажатия/отпускания,
+// а игровой цикл опрашивает ее один раз за тик, поэтому движение не зависит
+// от задержки и частоты автоповтора клавиатуры в ОС.
+class KeyboardState {
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    void keyDown(int key, TimePoint eventTime);
+    void keyUp(int key, TimePoint eventTime);
+    void releaseAll(); // Например, при потере фокуса окном
+
+    // Время самого раннего изменения с прошлого опроса; false, если изменений не было
+    bool takePendingEvent(TimePoint& outEventTime);
+
+    bool isDown(int key) const;
+    // Последняя нажатая из удерживаемых стрелок
+    bool getMovementDirection(Direction& outDir) const;
+
+private:
+    static int slotOf(int key);
+    static bool directionOf(int key, Direction& outDir);
+    void forgetDirection(Direction dir);
+    void markEvent(TimePoint eventTime);
+
+    std::bitset<512> keys;
+    std::array<Direction, 4> directionOrder{}; // Удерживаемые стрелки в порядке нажатия
+    int directionCount = 0;
+
+    bool hasPendingEvent = false;
+    TimePoint pendingEventTime;
+};
@@ -2,12 +2,12 @@
 #include "../view/MenuView.h"
 #include "../model/MenuModel.h"
 
-MenuController::MenuController() {
+MenuController::MenuController(SceneManager& scenes) {
     model = std::make_unique<MenuModel>();
     view = std::make_unique<MenuView>();
     
-    // Представление настраивает себя самостоятельно
-    view->setupUI();
+    // Представление создает свою сцену в общем окне
+    view->setupUI(scenes);
     
     // Устанавливаем обработчики событий
     view->setNewGameCallback([this]() {
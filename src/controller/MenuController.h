@@ -6,7 +6,7 @@
 
 class MenuController : public BaseController {
 public:
-    MenuController();
+    explicit MenuController(SceneManager& scenes);
     ~MenuController();
     
     void show() override;
@@ -1,7 +1,69 @@
 #include "controller/ApplicationController.h"
+#include "common/AllocationTracker.h"
+#include "common/StartupTrace.h"
+#include "common/TraceEvents.h"
+#include <FL/Fl.H>
+#include <FL/Enumerations.H>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
 
-int main() {
-    ApplicationController app;
+int main(int argc, char** argv) {
+    StartupTrace startupTrace; // Отсчет времени запуска - с начала main
+
+    // --connect хост:порт - сетевая игра на выделенном сервере (game-server)
+    // --startup-trace файл - записать длительности этапов запуска (CSV)
+    // --trace-events файл - записывать тики и кадры для chrome://tracing (сборка с TRACE_EVENTS)
+    // --alloc-budget N - сообщать о кадрах больше чем с N выделениями и об утечках (сборка с TRACK_ALLOCATIONS)
+    std::string serverAddress;
+    std::string traceFile;
+    std::string traceEventsFile;
+    const char* allocationBudget = nullptr;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--connect") == 0) {
+            serverAddress = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--startup-trace") == 0) {
+            traceFile = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--trace-events") == 0) {
+            traceEventsFile = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--alloc-budget") == 0) {
+            allocationBudget = argv[i + 1];
+        }
+    }
+#ifdef ARCADE_TRACK_ALLOCATIONS
+    if (allocationBudget) {
+        AllocationTracker::start(std::strtoull(allocationBudget, nullptr, 10));
+    }
+#else
+    if (allocationBudget) {
+        std::cerr << "--alloc-budget: программа собрана без TRACK_ALLOCATIONS\n";
+    }
+#endif
+#ifdef ARCADE_TRACE_EVENTS
+    if (!traceEventsFile.empty()) {
+        if (TraceEvents::start(traceEventsFile)) {
+            ARCADE_TRACE_THREAD("main");
+        } else {
+            std::cerr << "Не удалось открыть файл трассировки " << traceEventsFile << "\n";
+        }
+    }
+#else
+    if (!traceEventsFile.empty()) {
+        std::cerr << "--trace-events: программа собрана без TRACE_EVENTS\n";
+    }
+#endif
+
+    {
+        // Подключение к дисплею и выбор визуала для окон с двойной буферизацией
+        auto phase = startupTrace.phase("fltk init");
+        Fl::visual(FL_DOUBLE | FL_RGB);
+    }
+
+    ApplicationController app(serverAddress, startupTrace, traceFile);
     app.run();
+#ifdef ARCADE_TRACE_EVENTS
+    TraceEvents::stop();
+#endif
     return 0;
 }
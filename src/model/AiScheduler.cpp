@@ -0,0 +1,97 @@
+#include "AiScheduler.h"
+
+void AiScheduler::setBudget(int microseconds) {
+    budget = std::chrono::microseconds(std::max(0, microseconds));
+    reset();
+}
+
+void AiScheduler::reset() {
+    cursorId = 0;
+    nextCursorId = 0;
+    pathCursorId = 0;
+    stats = Stats{};
+}
+
+size_t AiScheduler::firstIndex(const std::vector<std::unique_ptr<GameObject>>& objects) const {
+    if (cursorId == 0) {
+        return 0;
+    }
+    auto it = std::lower_bound(objects.begin(), objects.end(), cursorId,
+                               [](const std::unique_ptr<GameObject>& obj, uint32_t id) { return obj->getId() < id; });
+    return it == objects.end() ? 0 : static_cast<size_t>(it - objects.begin());
+}
+
+void AiScheduler::beginTick(uint64_t currentTick) {
+    tick = currentTick;
+    admitted = 0;
+    exhausted = false;
+    nextCursorId = 0;
+    stalenessSum = 0;
+    stats.thought = 0;
+    stats.deferred = 0;
+    stats.pathQueries = 0;
+    stats.maxStaleness = 0;
+    if (budget.count() > 0) {
+        tickStart = Clock::now();
+    }
+}
+
+bool AiScheduler::admit() {
+    if (budget.count() == 0) {
+        return true;
+    }
+    if (!exhausted && admitted % CLOCK_CHECK_INTERVAL == 0 && admitted > 0) {
+        exhausted = Clock::now() - tickStart >= budget;
+    }
+    if (exhausted) {
+        return false;
+    }
+    ++admitted;
+    return true;
+}
+
+bool AiScheduler::admitPathQuery(const Tank& tank) {
+    // Запрос стоит десятков решений, поэтому часы проверяются перед каждым
+    if (!exhausted && budget.count() > 0) {
+        exhausted = Clock::now() - tickStart >= budget;
+    }
+    if (exhausted || stats.pathQueries >= pathQueryLimit || tank.getId() < pathCursorId) {
+        return false;
+    }
+    ++stats.pathQueries;
+    lastPathId = tank.getId();
+    return true;
+}
+
+void AiScheduler::account(const Tank& tank) {
+    const uint64_t staleness = tick - std::min(tick, tank.getAiTick());
+    stats.maxStaleness = std::max(stats.maxStaleness, staleness);
+    stalenessSum += staleness;
+}
+
+void AiScheduler::thought(Tank& tank) {
+    account(tank);
+    tank.setAiState(tick, false);
+    ++stats.thought;
+}
+
+void AiScheduler::defer(Tank& tank) {
+    account(tank);
+    tank.setAiState(tank.getAiTick(), true);
+    if (stats.deferred == 0) {
+        nextCursorId = tank.getId(); // Следующий тик начнется с него
+    }
+    ++stats.deferred;
+}
+
+void AiScheduler::endTick() {
+    cursorId = nextCursorId;
+    // Лимит не исчерпан - очередь дошла до конца, следующий круг снова с начала
+    pathCursorId = stats.pathQueries >= pathQueryLimit && pathQueryLimit > 0 ? lastPathId + 1 : 0;
+    const int counted = stats.thought + stats.deferred;
+    stats.meanStaleness = counted > 0 ? static_cast<double>(stalenessSum) / counted : 0.0;
+    stats.elapsedMicroseconds =
+        budget.count() > 0
+            ? std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - tickStart).count()
+            : 0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "Tank.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Бюджет времени на ИИ врагов в одном тике. Враги обходятся по кругу в порядке id:
+// проход начинается с первого врага, которому в прошлом тике не хватило времени,
+// поэтому при нехватке бюджета все по очереди получают ход. Отложенный враг помечается
+// в самом танке и думает в следующем тике, даже если LOD его бы пропустил.
+// Без бюджета (по умолчанию) проход всегда с начала - решения не зависят от скорости
+// машины, что нужно серверу, ботам и сетевой игре.
+// Поиск пути дороже обычного решения, поэтому запросы к графу путей ограничены
+// еще и числом за тик: лимит детерминирован, а при исчерпанном бюджете времени
+// запросов в этом тике больше нет. Запросы тоже раздаются по кругу: если лимит
+// исчерпан, следующий тик отдает их врагам с id больше последнего получившего
+class AiScheduler {
+public:
+    struct Stats {
+        int thought = 0;            // Врагов, подумавших в последнем тике
+        int deferred = 0;           // Не успели: бюджет кончился, ждут следующего тика
+        int pathQueries = 0;        // Запросов пути в последнем тике
+        uint64_t maxStaleness = 0;  // Тиков с прошлого решения: наибольшее среди думавших и отложенных
+        double meanStaleness = 0.0;
+        int64_t elapsedMicroseconds = 0;
+    };
+
+    void setBudget(int microseconds); // 0 - без ограничения
+    int getBudget() const { return static_cast<int>(budget.count()); }
+    void setPathQueryLimit(int queries) { pathQueryLimit = std::max(0, queries); }
+    int getPathQueryLimit() const { return pathQueryLimit; }
+    void reset(); // Новая партия или загруженное состояние: проход снова с начала
+
+    // Индекс, с которого начинается проход по objects (объекты идут по возрастанию id)
+    size_t firstIndex(const std::vector<std::unique_ptr<GameObject>>& objects) const;
+
+    void beginTick(uint64_t tick);
+    // Подумать ли еще одному врагу в этом тике; false - бюджет исчерпан, врага нужно отложить
+    bool admit();
+    // Можно ли подумавшему врагу запросить путь; false - идти без пути
+    bool admitPathQuery(const Tank& tank);
+    void thought(Tank& tank);
+    void defer(Tank& tank);
+    void endTick();
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr int CLOCK_CHECK_INTERVAL = 8; // Часы читаются раз на столько решений
+    static constexpr int DEFAULT_PATH_QUERY_LIMIT = 2;
+
+    void account(const Tank& tank);
+
+    std::chrono::microseconds budget{0};
+    int pathQueryLimit = DEFAULT_PATH_QUERY_LIMIT;
+    uint32_t pathCursorId = 0; // Запросы пути получают враги с id не меньше этого
+    uint32_t lastPathId = 0;   // Последний враг, получивший запрос в текущем тике
+    uint32_t cursorId = 0;     // С кого начинается проход, 0 - сначала
+    uint32_t nextCursorId = 0; // Первый враг, отложенный в текущем тике
+    uint64_t tick = 0;
+    Clock::time_point tickStart;
+    int admitted = 0;
+    bool exhausted = false;
+    uint64_t stalenessSum = 0;
+    Stats stats;
+};
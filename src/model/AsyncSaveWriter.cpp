@@ -0,0 +1,83 @@
+#include "AsyncSaveWriter.h"
+#include "SaveGame.h"
+#include <chrono>
+
+AsyncSaveWriter::AsyncSaveWriter() : worker([this]() { run(); }) {}
+
+AsyncSaveWriter::~AsyncSaveWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeWorker.notify_one();
+    worker.join();
+}
+
+void AsyncSaveWriter::save(GameSnapshot snapshot, const std::string& filename) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        bool replaced = false;
+        for (auto& entry : pending) {
+            if (entry.first == filename) {
+                entry.second = std::move(snapshot); // Старый снимок в тот же файл уже не нужен
+                replaced = true;
+                break;
+            }
+        }
+        if (!replaced) {
+            pending.emplace_back(filename, std::move(snapshot));
+        }
+    }
+    wakeWorker.notify_one();
+}
+
+void AsyncSaveWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    queueDrained.wait(lock, [this]() { return pending.empty() && !writing; });
+}
+
+int AsyncSaveWriter::getCompletedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return completed;
+}
+
+int AsyncSaveWriter::getFailedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return failed;
+}
+
+double AsyncSaveWriter::getLastWriteMs() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastWriteMs;
+}
+
+void AsyncSaveWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wakeWorker.wait(lock, [this]() { return stopping || !pending.empty(); });
+        if (pending.empty()) {
+            return; // stopping и очередь уже пуста
+        }
+        auto job = std::move(pending.front());
+        pending.pop_front();
+        writing = true;
+        lock.unlock();
+
+        auto start = std::chrono::steady_clock::now();
+        bool ok = SaveGame::writeFile(job.first, job.second);
+        double elapsedMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        lock.lock();
+        writing = false;
+        lastWriteMs = elapsedMs;
+        if (ok) {
+            ++completed;
+        } else {
+            ++failed;
+        }
+        if (pending.empty()) {
+            queueDrained.notify_all();
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "GameSnapshot.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+// Фоновая запись сохранений. Игровой поток только снимает GameSnapshot и отдает его сюда,
+// кодирование, сжатие и запись на диск идут в отдельном потоке.
+// Несколько ожидающих сохранений в один файл схлопываются в последнее
+class AsyncSaveWriter {
+public:
+    AsyncSaveWriter();
+    ~AsyncSaveWriter(); // Дописывает очередь и останавливает поток
+    AsyncSaveWriter(const AsyncSaveWriter&) = delete;
+    AsyncSaveWriter& operator=(const AsyncSaveWriter&) = delete;
+
+    void save(GameSnapshot snapshot, const std::string& filename);
+    void flush(); // Ждет, пока все поставленные сохранения не будут записаны
+
+    int getCompletedCount() const;
+    int getFailedCount() const;
+    double getLastWriteMs() const;
+
+private:
+    void run();
+
+    mutable std::mutex mutex;
+    std::condition_variable wakeWorker;
+    std::condition_variable queueDrained;
+    std::deque<std::pair<std::string, GameSnapshot>> pending;
+    bool writing = false;
+    bool stopping = false;
+    int completed = 0;
+    int failed = 0;
+    double lastWriteMs = 0;
+    std::thread worker; // Последним: поток стартует, когда остальные поля уже созданы
+};
@@ -0,0 +1,279 @@
+#include "BulletArray.h"
+#include "SimdTarget.h"
+#include <algorithm>
+
+namespace {
+
+struct WallGrid {
+    const TileType* tiles;
+    int width;
+    int height;
+    float invTileSize; // Деление на размер тайла заменено умножением во всех ядрах одинаково
+};
+
+// Центр пули в стене или вне карты. Сравнения записаны так, чтобы NaN тоже считался попаданием
+inline bool hitsWall(float px, float py, const WallGrid& grid) {
+    float fx = px * grid.invTileSize;
+    float fy = py * grid.invTileSize;
+    if (!(px >= 0.0f && py >= 0.0f && fx < static_cast<float>(grid.width) && fy < static_cast<float>(grid.height))) {
+        return true;
+    }
+    int tx = static_cast<int>(fx);
+    int ty = static_cast<int>(fy);
+    return grid.tiles[ty * grid.width + tx] == TileType::Wall;
+}
+
+void integrateScalar(float* x, float* y, const float* vx, const float* vy, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        x[i] += vx[i];
+        y[i] += vy[i];
+    }
+}
+
+void markWallsScalar(const float* x, const float* y, uint8_t* destroyed, size_t begin, size_t count,
+                     const WallGrid& grid) {
+    for (size_t i = begin; i < count; ++i) {
+        if (hitsWall(x[i], y[i], grid)) {
+            destroyed[i] = 1;
+        }
+    }
+}
+
+#ifdef ARCADE_X86
+
+// SSE2: движение и индексы тайлов по 4 пули; выборка тайлов поштучная (gather в SSE нет)
+void integrateSse2(float* x, float* y, const float* vx, const float* vy, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(vx + i)));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_loadu_ps(vy + i)));
+    }
+    integrateScalar(x + i, y + i, vx + i, vy + i, count - i);
+}
+
+void markWallsSse2(const float* x, const float* y, uint8_t* destroyed, size_t count, const WallGrid& grid) {
+    const __m128 inv = _mm_set1_ps(grid.invTileSize);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 width = _mm_set1_ps(static_cast<float>(grid.width));
+    const __m128 height = _mm_set1_ps(static_cast<float>(grid.height));
+    alignas(16) int32_t tx[4];
+    alignas(16) int32_t ty[4];
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 px = _mm_loadu_ps(x + i);
+        __m128 py = _mm_loadu_ps(y + i);
+        __m128 fx = _mm_mul_ps(px, inv);
+        __m128 fy = _mm_mul_ps(py, inv);
+        __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(px, zero), _mm_cmpge_ps(py, zero)),
+                                   _mm_and_ps(_mm_cmplt_ps(fx, width), _mm_cmplt_ps(fy, height)));
+        int insideBits = _mm_movemask_ps(inside);
+        // Индексы вне карты обнуляются, чтобы не читать за пределами массива
+        _mm_store_si128(reinterpret_cast<__m128i*>(tx), _mm_and_si128(_mm_cvttps_epi32(fx), _mm_castps_si128(inside)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(ty), _mm_and_si128(_mm_cvttps_epi32(fy), _mm_castps_si128(inside)));
+        for (int k = 0; k < 4; ++k) {
+            bool outside = !(insideBits & (1 << k));
+            if (outside || grid.tiles[ty[k] * grid.width + tx[k]] == TileType::Wall) {
+                destroyed[i + k] = 1;
+            }
+        }
+    }
+    markWallsScalar(x, y, destroyed, i, count, grid);
+}
+
+// AVX2: по 8 пуль, тайлы собираются одной инструкцией gather
+ARCADE_TARGET_AVX2
+void integrateAvx2(float* x, float* y, const float* vx, const float* vy, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(vx + i)));
+        _mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_loadu_ps(vy + i)));
+    }
+    integrateScalar(x + i, y + i, vx + i, vy + i, count - i);
+}
+
+ARCADE_TARGET_AVX2
+void markWallsAvx2(const float* x, const float* y, uint8_t* destroyed, size_t count, const WallGrid& grid) {
+    static_assert(sizeof(TileType) == sizeof(int32_t), "gather reads tiles as 32-bit values");
+    const __m256 inv = _mm256_set1_ps(grid.invTileSize);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 width = _mm256_set1_ps(static_cast<float>(grid.width));
+    const __m256 height = _mm256_set1_ps(static_cast<float>(grid.height));
+    const __m256i rowStride = _mm256_set1_epi32(grid.width);
+    const __m256i wall = _mm256_set1_epi32(static_cast<int32_t>(TileType::Wall));
+    const int* tiles = reinterpret_cast<const int*>(grid.tiles);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 px = _mm256_loadu_ps(x + i);
+        __m256 py = _mm256_loadu_ps(y + i);
+        __m256 fx = _mm256_mul_ps(px, inv);
+        __m256 fy = _mm256_mul_ps(py, inv);
+        __m256 inside = _mm256_and_ps(
+            _mm256_and_ps(_mm256_cmp_ps(px, zero, _CMP_GE_OQ), _mm256_cmp_ps(py, zero, _CMP_GE_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(fx, width, _CMP_LT_OQ), _mm256_cmp_ps(fy, height, _CMP_LT_OQ)));
+        __m256i insideMask = _mm256_castps_si256(inside);
+        __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_cvttps_epi32(fy), rowStride),
+                                         _mm256_cvttps_epi32(fx));
+        // Дорожки вне карты не читаются: маскированный gather оставляет для них 0
+        __m256i tile = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), tiles, index, insideMask, 4);
+        __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi32(tile, wall), _mm256_xor_si256(insideMask, _mm256_set1_epi32(-1)));
+        int hitBits = _mm256_movemask_ps(_mm256_castsi256_ps(hit));
+        for (int k = 0; hitBits; ++k, hitBits >>= 1) {
+            if (hitBits & 1) {
+                destroyed[i + k] = 1;
+            }
+        }
+    }
+    markWallsScalar(x, y, destroyed, i, count, grid);
+}
+
+bool cpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && ((_xgetbv(0) & 6) == 6);
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5));
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // ARCADE_X86
+
+} // namespace
+
+BulletArray::BulletArray() : kernel(getBestKernel()) {}
+
+BulletArray::Kernel BulletArray::getBestKernel() {
+#ifdef ARCADE_X86
+    static const Kernel best = cpuHasAvx2() ? Kernel::AVX2 : Kernel::SSE2;
+    return best;
+#else
+    return Kernel::Scalar;
+#endif
+}
+
+const char* BulletArray::getKernelName(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::AVX2: return "AVX2";
+        case Kernel::SSE2: return "SSE2";
+        default: return "scalar";
+    }
+}
+
+void BulletArray::setKernel(Kernel newKernel) {
+    Kernel best = getBestKernel();
+    kernel = static_cast<int>(newKernel) <= static_cast<int>(best) ? newKernel : best;
+}
+
+void BulletArray::clear() {
+    x.clear();
+    y.clear();
+    vx.clear();
+    vy.clear();
+    speeds.clear();
+    damages.clear();
+    ids.clear();
+    directions.clear();
+    fromPlayer.clear();
+    destroyed.clear();
+}
+
+void BulletArray::reserve(size_t count) {
+    x.reserve(count);
+    y.reserve(count);
+    vx.reserve(count);
+    vy.reserve(count);
+    speeds.reserve(count);
+    damages.reserve(count);
+    ids.reserve(count);
+    directions.reserve(count);
+    fromPlayer.reserve(count);
+    destroyed.reserve(count);
+}
+
+size_t BulletArray::add(uint32_t id, float startX, float startY, Direction dir, bool player, float speed, int damage) {
+    x.push_back(FixedPoint::quantize(startX));
+    y.push_back(FixedPoint::quantize(startY));
+    vx.push_back(0);
+    vy.push_back(0);
+    speeds.push_back(0);
+    damages.push_back(0);
+    ids.push_back(id);
+    directions.push_back(static_cast<uint8_t>(dir));
+    fromPlayer.push_back(player ? 1 : 0);
+    destroyed.push_back(0);
+    setStats(x.size() - 1, speed, damage);
+    return x.size() - 1;
+}
+
+void BulletArray::setStats(size_t i, float speed, int damage) {
+    speed = FixedPoint::quantize(speed); // На сетке шаг пули складывается точно
+    speeds[i] = speed;
+    damages[i] = damage;
+    // x - speed и x + (-speed) дают один и тот же результат, поэтому шаг - всегда сложение
+    switch (static_cast<Direction>(directions[i])) {
+        case Direction::UP:    vx[i] = 0; vy[i] = -speed; break;
+        case Direction::DOWN:  vx[i] = 0; vy[i] = speed; break;
+        case Direction::LEFT:  vx[i] = -speed; vy[i] = 0; break;
+        case Direction::RIGHT: vx[i] = speed; vy[i] = 0; break;
+    }
+}
+
+void BulletArray::integrate() {
+    switch (kernel) {
+#ifdef ARCADE_X86
+        case Kernel::AVX2: integrateAvx2(x.data(), y.data(), vx.data(), vy.data(), size()); break;
+        case Kernel::SSE2: integrateSse2(x.data(), y.data(), vx.data(), vy.data(), size()); break;
+#endif
+        default: integrateScalar(x.data(), y.data(), vx.data(), vy.data(), size()); break;
+    }
+}
+
+void BulletArray::markWallHits(const TileType* tiles, int mapWidth, int mapHeight, float tileSize) {
+    if (empty() || !tiles) {
+        return;
+    }
+    WallGrid grid{tiles, mapWidth, mapHeight, 1.0f / tileSize};
+    switch (kernel) {
+#ifdef ARCADE_X86
+        case Kernel::AVX2: markWallsAvx2(x.data(), y.data(), destroyed.data(), size(), grid); break;
+        case Kernel::SSE2: markWallsSse2(x.data(), y.data(), destroyed.data(), size(), grid); break;
+#endif
+        default: markWallsScalar(x.data(), y.data(), destroyed.data(), 0, size(), grid); break;
+    }
+}
+
+void BulletArray::removeDestroyed() {
+    size_t out = 0;
+    for (size_t i = 0; i < size(); ++i) {
+        if (destroyed[i]) {
+            continue;
+        }
+        if (out != i) {
+            x[out] = x[i];
+            y[out] = y[i];
+            vx[out] = vx[i];
+            vy[out] = vy[i];
+            speeds[out] = speeds[i];
+            damages[out] = damages[i];
+            ids[out] = ids[i];
+            directions[out] = directions[i];
+            fromPlayer[out] = fromPlayer[i];
+            destroyed[out] = 0;
+        }
+        ++out;
+    }
+    x.resize(out);
+    y.resize(out);
+    vx.resize(out);
+    vy.resize(out);
+    speeds.resize(out);
+    damages.resize(out);
+    ids.resize(out);
+    directions.resize(out);
+    fromPlayer.resize(out);
+    destroyed.resize(out);
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "TileType.h"
+#include "../common/Direction.h"
+#include "FixedPoint.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Все пули модели в виде отдельных массивов полей (structure of arrays).
+// Движение и проверка стен идут одним проходом по массивам векторными ядрами:
+// AVX2 или SSE2 на x86, скалярный вариант везде. Ядро выбирается при запуске по
+// возможностям процессора; все варианты дают побитно одинаковый результат.
+// Порядок пуль - порядок добавления (по возрастанию id), удаление его сохраняет
+class BulletArray {
+public:
+    static constexpr float DEFAULT_SPEED = 8.0f; // Увеличена скорость с 5.0f до 8.0f
+    static constexpr int DEFAULT_DAMAGE = 25;
+    static constexpr float RADIUS = 3.0f;
+
+    enum class Kernel { Scalar, SSE2, AVX2 };
+
+    BulletArray();
+
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+    void clear();
+    void reserve(size_t count);
+
+    // Номер новой пули
+    size_t add(uint32_t id, float startX, float startY, Direction dir, bool fromPlayer,
+               float speed = DEFAULT_SPEED, int damage = DEFAULT_DAMAGE);
+
+    uint32_t getId(size_t i) const { return ids[i]; }
+    float getX(size_t i) const { return x[i]; }
+    float getY(size_t i) const { return y[i]; }
+    Direction getDirection(size_t i) const { return static_cast<Direction>(directions[i]); }
+    bool isFromPlayer(size_t i) const { return fromPlayer[i] != 0; }
+    float getSpeed(size_t i) const { return speeds[i]; }
+    int getDamage(size_t i) const { return damages[i]; }
+    bool isDestroyed(size_t i) const { return destroyed[i] != 0; }
+    void destroy(size_t i) { destroyed[i] = 1; }
+    void setPosition(size_t i, float newX, float newY) {
+        x[i] = FixedPoint::quantize(newX);
+        y[i] = FixedPoint::quantize(newY);
+    }
+    void setStats(size_t i, float speed, int damage); // Для загрузки сохранений и сетевой игры
+
+    // Сдвигает все пули на один шаг по направлению
+    void integrate();
+    // Помечает уничтоженными пули, центр которых в стене или за краем карты.
+    // tiles - тайлы карты по строкам (GameMap::getTileData)
+    void markWallHits(const TileType* tiles, int mapWidth, int mapHeight, float tileSize);
+    // Убирает уничтоженные пули, сохраняя порядок остальных
+    void removeDestroyed();
+
+    Kernel getKernel() const { return kernel; }
+    void setKernel(Kernel newKernel); // Недоступное процессору ядро заменяется лучшим доступным
+    static Kernel getBestKernel();
+    static const char* getKernelName(Kernel kernel);
+
+private:
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> vx; // Смещение за шаг: speed вдоль направления, 0 по другой оси
+    std::vector<float> vy;
+    std::vector<float> speeds;
+    std::vector<int32_t> damages;
+    std::vector<uint32_t> ids;
+    std::vector<uint8_t> directions;
+    std::vector<uint8_t> fromPlayer;
+    std::vector<uint8_t> destroyed;
+    Kernel kernel;
+};
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+
+// Генератор случайных чисел, считающий выданные значения.
+// Состояние на любом шаге восстанавливается по сохраненному состоянию и разнице счетчиков
+// через discard(), поэтому буферу перемотки не нужно хранить состояние генератора в каждом тике
+template <typename Engine>
+class CountingRandom {
+public:
+    using result_type = typename Engine::result_type;
+
+    explicit CountingRandom(result_type seed = Engine::default_seed) : engine(seed) {}
+
+    static constexpr result_type min() { return Engine::min(); }
+    static constexpr result_type max() { return Engine::max(); }
+
+    result_type operator()() {
+        ++draws;
+        return engine();
+    }
+
+    const Engine& getEngine() const { return engine; }
+    uint64_t getDraws() const { return draws; }
+    void restore(const Engine& newEngine, uint64_t newDraws) {
+        engine = newEngine;
+        draws = newDraws;
+    }
+
+private:
+    Engine engine;
+    uint64_t draws = 0;
+};
@@ -0,0 +1,61 @@
+#include "DestructibleWalls.h"
+#include <algorithm>
+
+void DestructibleWalls::build(int mapWidth, int mapHeight) {
+    width = mapWidth;
+    height = mapHeight;
+    damageGrid.assign(static_cast<size_t>(width) * height, 0);
+    damagedTiles.clear();
+}
+
+void DestructibleWalls::clear() {
+    for (const auto& pos : damagedTiles) {
+        damageGrid[static_cast<size_t>(pos.second) * width + pos.first] = 0;
+    }
+    damagedTiles.clear();
+}
+
+void DestructibleWalls::setWallHealth(int health) {
+    wallHealth = std::clamp(health, 0, MAX_HEALTH);
+    clear();
+}
+
+bool DestructibleWalls::isDestructible(const GameMap& map, int x, int y) const {
+    return isEnabled() && x > 0 && y > 0 && x < width - 1 && y < height - 1 &&
+           map.getTile(x, y) == TileType::Wall;
+}
+
+bool DestructibleWalls::damage(const GameMap& map, int x, int y, int amount) {
+    if (amount <= 0 || !isDestructible(map, x, y)) {
+        return false;
+    }
+    const int total = getDamage(x, y) + amount;
+    if (total >= wallHealth) {
+        setDamage(x, y, 0);
+        return true;
+    }
+    setDamage(x, y, total);
+    return false;
+}
+
+int DestructibleWalls::getDamage(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) {
+        return 0;
+    }
+    return damageGrid[static_cast<size_t>(y) * width + x];
+}
+
+void DestructibleWalls::setDamage(int x, int y, int amount) {
+    if (x < 0 || y < 0 || x >= width || y >= height) {
+        return;
+    }
+    uint8_t& cell = damageGrid[static_cast<size_t>(y) * width + x];
+    if (cell == 0 && amount > 0) {
+        damagedTiles.push_back({x, y}); // Повтор возможен, только если тайл успел смениться
+    }
+    cell = static_cast<uint8_t>(std::clamp(amount, 0, MAX_HEALTH - 1));
+}
+
+void DestructibleWalls::tileChanged(int x, int y) {
+    setDamage(x, y, 0);
+}
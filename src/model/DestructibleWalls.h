@@ -0,0 +1,40 @@
+#pragma once
+#include "GameMap.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Прочность разрушаемых стен. Разрушаемы все стены, кроме крайних строк и столбцов карты:
+// они держат танки и пули внутри. Урон хранится байтом на тайл, а список поврежденных
+// тайлов позволяет сохранить и сбросить урон, не обходя всю сетку.
+// Разрушенную стену модель убирает через GameMap::setTile; наблюдатели карты (граф путей,
+// видимость, точки появления) перестраивают только этот тайл в том же тике
+class DestructibleWalls {
+public:
+    static constexpr int DEFAULT_HEALTH = 100;
+    static constexpr int MAX_HEALTH = 250; // Урон хранится в коде тайла снимка, см. GameSnapshot
+
+    void build(int mapWidth, int mapHeight);
+    void clear();
+
+    void setWallHealth(int health); // 0 - стены неразрушимы
+    int getWallHealth() const { return wallHealth; }
+    bool isEnabled() const { return wallHealth > 0; }
+
+    bool isDestructible(const GameMap& map, int x, int y) const;
+    // Урон стене (x, y); true - стена разрушена и ее нужно убрать с карты
+    bool damage(const GameMap& map, int x, int y, int amount);
+    int getDamage(int x, int y) const;
+    void setDamage(int x, int y, int amount); // Восстановление из снимка
+    void tileChanged(int x, int y);           // Наблюдатель карты: у нового тайла урона нет
+
+    // Тайлы, получавшие урон (могут повторяться и уже не иметь урона - проверяйте getDamage)
+    const std::vector<std::pair<int, int>>& getDamagedTiles() const { return damagedTiles; }
+
+private:
+    std::vector<uint8_t> damageGrid; // По строкам, width * height
+    std::vector<std::pair<int, int>> damagedTiles;
+    int width = 0;
+    int height = 0;
+    int wallHealth = DEFAULT_HEALTH;
+};
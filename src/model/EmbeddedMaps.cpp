@@ -0,0 +1,22 @@
+#include "EmbeddedMaps.h"
+
+namespace EmbeddedMaps {
+namespace {
+
+// Текст генерируется CMake из resources/map.txt (опция EMBED_MAPS)
+constexpr std::string_view DEFAULT_MAP_TEXT =
+#include "DefaultMap.inc"
+    ;
+
+constexpr MapShape DEFAULT_MAP_SHAPE = measure(DEFAULT_MAP_TEXT);
+constexpr MapData<DEFAULT_MAP_SHAPE> DEFAULT_MAP_DATA = parse<DEFAULT_MAP_SHAPE>(DEFAULT_MAP_TEXT);
+constinit const MapLayout DEFAULT_LAYOUT = makeLayout(DEFAULT_MAP_DATA);
+
+} // namespace
+
+std::shared_ptr<const MapLayout> getDefault() {
+    // Указатель без владельца: карта живет до конца программы
+    return std::shared_ptr<const MapLayout>(std::shared_ptr<const MapLayout>(), &DEFAULT_LAYOUT);
+}
+
+} // namespace EmbeddedMaps
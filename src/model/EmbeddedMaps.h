@@ -0,0 +1,119 @@
+#pragma once
+#include "MapLayout.h"
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+// Карты, вшитые в программу при сборке (опция EMBED_MAPS). Текст карты разбирается
+// во время компиляции в статические массивы тайлов и точек появления, ошибка в карте
+// останавливает сборку. Во время работы нет ни чтения файла, ни разбора, ни пути отказа
+namespace EmbeddedMaps {
+
+// Размеры карты, найденные первым проходом по тексту
+struct MapShape {
+    int width = 0;
+    int height = 0;
+    int playerCount = 0;
+    int enemyCount = 0;
+    bool valid = false; // Те же правила, что у MapLayout::fromStream
+};
+
+template <MapShape Shape>
+struct MapData {
+    std::array<TileType, static_cast<size_t>(Shape.width) * Shape.height> tiles{};
+    std::array<MapLayout::Position, Shape.playerCount> playerStarts{};
+    std::array<MapLayout::Position, Shape.enemyCount> enemyStarts{};
+};
+
+// Строки текста по одной, как их читает std::getline
+class LineReader {
+public:
+    constexpr explicit LineReader(std::string_view text) : text(text) {}
+
+    constexpr bool next(std::string_view& outLine) {
+        if (pos >= text.size()) {
+            return false;
+        }
+        size_t end = text.find('\n', pos);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        outLine = text.substr(pos, end - pos);
+        atEnd = end >= text.size();
+        pos = end + 1;
+        return true;
+    }
+    constexpr bool isAtEnd() const { return atEnd; } // Последняя строка без перевода строки
+
+private:
+    std::string_view text;
+    size_t pos = 0;
+    bool atEnd = false;
+};
+
+constexpr MapShape measure(std::string_view text) {
+    MapShape shape;
+    LineReader reader(text);
+    std::string_view line;
+    bool hasPlayer = false;
+    while (reader.next(line)) {
+        if (line.empty() && reader.isAtEnd()) {
+            break;
+        }
+        if (shape.height == 0) {
+            shape.width = static_cast<int>(line.size());
+            if (shape.width == 0) {
+                return MapShape{};
+            }
+        } else if (static_cast<int>(line.size()) != shape.width) {
+            return MapShape{};
+        }
+        for (char c : line) {
+            if (c == 'P') {
+                ++shape.playerCount;
+                hasPlayer = true;
+            } else if (c == 'E') {
+                ++shape.enemyCount;
+            }
+        }
+        ++shape.height;
+    }
+    shape.valid = shape.height > 0 && hasPlayer;
+    return shape;
+}
+
+// Второй проход: text должен быть тем же, по которому посчитан Shape
+template <MapShape Shape>
+constexpr MapData<Shape> parse(std::string_view text) {
+    static_assert(Shape.valid, "встроенная карта пустая, строки разной длины или нет 'P'");
+    MapData<Shape> data;
+    LineReader reader(text);
+    std::string_view line;
+    size_t tile = 0;
+    size_t player = 0;
+    size_t enemy = 0;
+    for (int row = 0; row < Shape.height && reader.next(line); ++row) {
+        for (int col = 0; col < Shape.width; ++col) {
+            char c = line[col];
+            data.tiles[tile++] = c == '#' ? TileType::Wall : TileType::Empty;
+            if (c == 'P') {
+                data.playerStarts[player++] = {col, row};
+            } else if (c == 'E') {
+                data.enemyStarts[enemy++] = {col, row};
+            }
+        }
+    }
+    return data;
+}
+
+// Готовая карта из вшитых данных; разделять ее можно сколько угодно - она статическая
+template <MapShape Shape>
+constexpr MapLayout makeLayout(const MapData<Shape>& data) {
+    return MapLayout(Shape.width, Shape.height, data.tiles, data.playerStarts, data.enemyStarts);
+}
+
+// resources/map.txt - карта по умолчанию
+std::shared_ptr<const MapLayout> getDefault();
+
+} // namespace EmbeddedMaps
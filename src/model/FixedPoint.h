@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+
+// Мировые координаты с фиксированной точкой (опция сборки FIXED_POINT_COORDS).
+// Позиции и скорости танков и пуль лежат на сетке 1/256 пикселя, а там, где в float
+// появилось бы округление (номер тайла, расталкивание танков), считается в целых.
+// Значения по-прежнему хранятся во float: целые до 2^24 он представляет точно, поэтому
+// сложение и сравнение таких координат тоже точные и не зависят от компилятора и флагов
+namespace FixedPoint {
+
+#ifdef ARCADE_FIXED_POINT
+inline constexpr bool ENABLED = true;
+#else
+inline constexpr bool ENABLED = false;
+#endif
+
+using Units = int32_t; // Координата в долях пикселя
+inline constexpr int FRACTION_BITS = 8;
+inline constexpr Units ONE = 1 << FRACTION_BITS;
+inline constexpr Units MAX_UNITS = 1 << 24; // Дальше float теряет точность
+inline constexpr float MAX_COORD = static_cast<float>(MAX_UNITS >> FRACTION_BITS);
+
+// Ближайшая точка сетки, половина округляется от нуля. Умножение на ONE во float точное
+constexpr Units fromFloat(float value) {
+    double scaled = static_cast<double>(value) * ONE;
+    return static_cast<Units>(scaled >= 0 ? scaled + 0.5 : scaled - 0.5);
+}
+
+constexpr float toFloat(Units units) {
+    return static_cast<float>(units) * (1.0f / ONE);
+}
+
+// Координата, которую хранит модель: в режиме фиксированной точки - привязанная к сетке
+constexpr float quantize(float value) {
+    if constexpr (ENABLED) {
+        return toFloat(fromFloat(value));
+    } else {
+        return value;
+    }
+}
+
+// Целый квадратный корень с округлением вниз
+constexpr uint32_t isqrt(uint64_t value) {
+    uint64_t result = 0;
+    uint64_t bit = uint64_t(1) << 62;
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return static_cast<uint32_t>(result);
+}
+
+} // namespace FixedPoint
@@ -1,105 +1,128 @@
 #include "GameMap.h"
-#include <fstream>
-#include <stdexcept> // Для std::runtime_error
+#include <algorithm>
 
-bool GameMap::loadFromFile(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        return false;
-    }
-
-    enemyStarts.clear();
-    playerStart = {-1, -1}; // Инициализируем в недопустимое состояние
-
-    grid.clear();
-    std::string line;
-    int firstLineWidth = -1;
-    int currentLineNumber = 0;
-
-    while (std::getline(file, line)) {
-        if (line.empty() && file.eof()) { // Разрешаем одну завершающую пустую строку, если это самый конец
-            break;
-        }
-        if (currentLineNumber == 0) {
-            firstLineWidth = static_cast<int>(line.length());
-            if (firstLineWidth == 0) {
-                file.close();
-                return false;
-            }
-        } else {
-            if (static_cast<int>(line.length()) != firstLineWidth) {
-                file.close();
-                return false;
-            }
-        }
+// Наблюдатели не копируются: они привязаны к производным данным владельца исходной карты
+GameMap::GameMap(const GameMap& other)
+    : enemyStarts(other.enemyStarts), playerStart(other.playerStart), playerStarts(other.playerStarts),
+      layout(other.layout), ownTiles(other.ownTiles), width(other.width), height(other.height),
+      modifiedTiles(other.modifiedTiles) {
+    bindTiles();
+}
 
-        std::vector<TileType> row;
-        for (int col = 0; col < static_cast<int>(line.length()); ++col) {
-            char c = line[col];
-            if (c == '#') {
-                row.push_back(TileType::Wall);
-            } else if (c == 'P') {
-                if (playerStart.first == -1) { // Устанавливаем только для первого найденного 'P'
-                    playerStart = {col, currentLineNumber};
-                }
-                row.push_back(TileType::Empty);
-            } else if (c == 'E') {
-                enemyStarts.push_back({col, currentLineNumber});
-                row.push_back(TileType::Empty);
-            } else {
-                row.push_back(TileType::Empty);
-            }
-        }
-        grid.push_back(row);
-        currentLineNumber++;
+GameMap& GameMap::operator=(const GameMap& other) {
+    if (this != &other) {
+        enemyStarts = other.enemyStarts;
+        playerStart = other.playerStart;
+        playerStarts = other.playerStarts;
+        modifiedTiles = other.modifiedTiles;
+        layout = other.layout;
+        ownTiles = other.ownTiles;
+        width = other.width;
+        height = other.height;
+        bindTiles();
     }
-    file.close();
+    return *this;
+}
 
-    if (grid.empty()) {
-        return false;
-    }
+bool GameMap::loadFromFile(const std::string& filename) {
+    return load(MapLayout::fromFile(filename));
+}
 
-    // Проверяем стартовую позицию игрока
-    if (playerStart.first < 0 || playerStart.first >= getWidth() || 
-        playerStart.second < 0 || playerStart.second >= getHeight()) {
-        return false;
-    }
+bool GameMap::loadFromStream(std::istream& file) {
+    return load(MapLayout::fromStream(file));
+}
 
-    // Проверяем стартовые позиции врагов
-    for (const auto& pos : enemyStarts) {
-        if (pos.second >= static_cast<int>(grid.size()) || pos.first >= static_cast<int>(grid[0].size())) {
-            return false; // Или удалить эту конкретную стартовую позицию врага и продолжить
-        }
+bool GameMap::load(std::shared_ptr<const MapLayout> newLayout) {
+    if (!newLayout) {
+        return false;
     }
-
-    originalGrid = grid;
+    layout = std::move(newLayout);
+    enemyStarts.assign(layout->enemyStarts.begin(), layout->enemyStarts.end());
+    playerStarts.assign(layout->playerStarts.begin(), layout->playerStarts.end());
+    playerStart = layout->playerStart;
+    width = layout->width;
+    height = layout->height;
+    modifiedTiles.clear();
+    ownTiles.clear();
+    bindTiles();
     return true;
 }
 
+void GameMap::bindTiles() {
+    tiles = !ownTiles.empty() ? ownTiles.data() : layout ? layout->tiles.data() : nullptr;
+}
+
 TileType GameMap::getTile(int x, int y) const {
-    if (y >= 0 && y < static_cast<int>(grid.size()) && 
-        x >= 0 && x < static_cast<int>(grid[y].size())) {
-        return grid[y][x];
+    if (y >= 0 && y < height && x >= 0 && x < width) {
+        return tiles[y * width + x];
     }
     // Не должно происходить, если координаты проверены, но как запасной вариант:
     return TileType::Wall; // Считаем за пределами как стену для безопасности
 }
 
+TileType GameMap::getInitialTile(int x, int y) const {
+    if (y >= 0 && y < height && x >= 0 && x < width) {
+        return layout->tiles[static_cast<size_t>(y) * width + x];
+    }
+    return TileType::Wall;
+}
+
 int GameMap::getWidth() const {
-    return grid.empty() ? 0 : static_cast<int>(grid[0].size());
+    return width;
 }
 
 int GameMap::getHeight() const {
-    return static_cast<int>(grid.size());
+    return height;
 }
 
 void GameMap::setTile(int x, int y, TileType tile) {
-    if (y >= 0 && y < static_cast<int>(grid.size()) && 
-        x >= 0 && x < static_cast<int>(grid[y].size())) {
-        grid[y][x] = tile;
+    if (y >= 0 && y < height && x >= 0 && x < width) {
+        if (tiles[y * width + x] == tile) {
+            return; // Ничего не изменилось, наблюдателей не беспокоим
+        }
+        if (ownTiles.empty()) {
+            ownTiles.assign(layout->tiles.begin(), layout->tiles.end()); // Первое изменение: отделяемся от общей карты
+            bindTiles();
+        }
+        ownTiles[y * width + x] = tile;
+        modifiedTiles.push_back({x, y});
+        notifyTileChanged(x, y, tile);
     }
 }
 
 void GameMap::resetToInitialState() {
-    grid = originalGrid;
+    // Восстанавливаем только измененные тайлы, чтобы на больших картах
+    // не копировать сетку целиком и не перестраивать производные данные
+    for (const auto& pos : modifiedTiles) {
+        size_t index = static_cast<size_t>(pos.second) * width + pos.first;
+        TileType original = layout->tiles[index];
+        if (ownTiles[index] != original) {
+            ownTiles[index] = original;
+            notifyTileChanged(pos.first, pos.second, original);
+        }
+    }
+    modifiedTiles.clear();
+}
+
+void GameMap::getChangedTiles(std::vector<std::pair<int, int>>& outTiles) const {
+    outTiles.clear();
+    for (const auto& pos : modifiedTiles) {
+        size_t index = static_cast<size_t>(pos.second) * width + pos.first;
+        if (ownTiles[index] != layout->tiles[index]) {
+            outTiles.push_back(pos);
+        }
+    }
+    // Тайл мог меняться несколько раз - оставляем одну запись
+    std::sort(outTiles.begin(), outTiles.end());
+    outTiles.erase(std::unique(outTiles.begin(), outTiles.end()), outTiles.end());
+}
+
+void GameMap::addTileObserver(TileObserver observer) {
+    tileObservers.push_back(std::move(observer));
+}
+
+void GameMap::notifyTileChanged(int x, int y, TileType tile) {
+    for (const auto& observer : tileObservers) {
+        observer(x, y, tile);
+    }
 }
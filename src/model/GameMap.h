@@ -1,21 +1,55 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <istream>
+#include <functional>
+#include <memory>
+#include "MapLayout.h"
 #include "TileType.h"
 
 class GameMap {
 public:
+    // Вызывается при каждом фактическом изменении тайла (setTile, сброс карты)
+    using TileObserver = std::function<void(int x, int y, TileType tile)>;
+
+    GameMap() = default;
+    GameMap(const GameMap& other);            // Копия начинает без наблюдателей
+    GameMap& operator=(const GameMap& other); // Наблюдатели этой карты остаются прежними
+
     bool loadFromFile(const std::string& filename);
+    bool loadFromStream(std::istream& input);
+    // Карта поверх уже разобранной: исходные тайлы не копируются, пока карта не изменится
+    bool load(std::shared_ptr<const MapLayout> layout);
+    const std::shared_ptr<const MapLayout>& getLayout() const { return layout; }
     TileType getTile(int x, int y) const;
     int getWidth() const;
     int getHeight() const;
+    const TileType* getTileData() const { return tiles; } // По строкам, width * height
     void setTile(int x, int y, TileType tile);
     void resetToInitialState();
+    // Тайлы, которые сейчас отличаются от исходной карты (без повторов)
+    void getChangedTiles(std::vector<std::pair<int, int>>& outTiles) const;
+    // Все тайлы, менявшиеся с загрузки или сброса: с повторами и, возможно, уже исходные
+    const std::vector<std::pair<int, int>>& getModifiedTiles() const { return modifiedTiles; }
+    TileType getInitialTile(int x, int y) const; // Тайл исходной карты
+
+    void addTileObserver(TileObserver observer);
 
     std::vector<std::pair<int, int>> enemyStarts;
     std::pair<int, int> playerStart;
+    std::vector<std::pair<int, int>> playerStarts; // Все 'P' карты, первая совпадает с playerStart
 
 private:
-    std::vector<std::vector<TileType>> grid;
-    std::vector<std::vector<TileType>> originalGrid;
+    void notifyTileChanged(int x, int y, TileType tile);
+    void bindTiles();
+
+    // Копирование при записи: пока тайлы не менялись, tiles указывает на layout->tiles,
+    // после первого setTile - на собственную копию ownTiles
+    std::shared_ptr<const MapLayout> layout;
+    std::vector<TileType> ownTiles;
+    const TileType* tiles = nullptr;
+    int width = 0;
+    int height = 0;
+    std::vector<std::pair<int, int>> modifiedTiles; // Тайлы, отличающиеся от исходной карты
+    std::vector<TileObserver> tileObservers;
 };
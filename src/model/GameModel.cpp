@@ -1,29 +1,71 @@
 #include "GameModel.h"
-#include "../model/Bullet.h"
 #include "../model/Tank.h"
-#include <algorithm> // Для std::shuffle, std::remove_if
+#include "../common/AllocationTracker.h"
+#include "../common/TraceEvents.h"
+#include <algorithm> // Для std::remove_if
 #include <cmath>
-#include <cstdlib> // Для rand, srand
-#include <ctime>   // Для time
-#include <random>  // Для std::mt19937, std::shuffle
+#include <limits>
+#include <sstream>
 
-GameModel::GameModel() : playerTank(nullptr) {
+static_assert(GameModel::Geometry::BULLET_RADIUS == BulletArray::RADIUS, "радиус пули задан в двух местах");
+
+GameModel::GameModel()
+    : tankBroadphase(TANK_SIZE), tankHits(TANK_SIZE), rng(std::random_device{}()) {
     lastUpdateTime = std::chrono::steady_clock::now();
-    // Инициализируем генератор случайных чисел один раз
-    srand(static_cast<unsigned int>(time(nullptr)));
+    players.resize(1);
+    players[0].active = true; // Одиночная игра: один локальный игрок
+    bullets.reserve(512); // Обычная перестрелка укладывается без роста массивов во время игры
+
+    // Изменения тайлов (разрушенные стены, загрузка, сброс) перестраивают только
+    // затронутые кластеры графа путей, биты видимости и точку появления этого тайла
+    gameMap.addTileObserver([this](int x, int y, TileType tile) {
+        pathfinder.invalidateTile(x, y);
+        lineOfSight.updateTile(x, y, tile);
+        spawnSlots.tileChanged(x, y, tile);
+        walls.tileChanged(x, y);
+    });
 }
 
 bool GameModel::init(const std::string& mapFile) {
-    if (!gameMap.loadFromFile(mapFile)) {
+    return init(MapLayout::fromFile(mapFile));
+}
+
+bool GameModel::init(std::shared_ptr<const MapLayout> layout) {
+    if (!gameMap.load(std::move(layout))) {
         return false;
     }
+    if (FixedPoint::ENABLED && (gameMap.getWidth() * TILE_SIZE > FixedPoint::MAX_COORD ||
+                                gameMap.getHeight() * TILE_SIZE > FixedPoint::MAX_COORD)) {
+        return false; // Координаты такой карты не помещаются в сетку фиксированной точки
+    }
+    pathfinder.build(gameMap); // Сам граф построится при первом запросе пути, общий для всех моделей на карте
+    lineOfSight.build(gameMap);
+    spawnSlots.build(gameMap, TILE_SIZE, TANK_SIZE);
+    simulationLod.build(gameMap.getWidth(), gameMap.getHeight(), TILE_SIZE);
+    walls.build(gameMap.getWidth(), gameMap.getHeight());
     reset();
     return true;
 }
 
+void GameModel::setSeed(uint32_t seed) {
+    rng.restore(std::mt19937(seed), 0);
+}
+
 void GameModel::reset() {
     gameObjects.clear();
-    playerTank = nullptr; // Явно обнуляем перед переназначением
+    bullets.clear();
+    tankBroadphase.clear();
+    spawnSlots.resetOccupancy();
+    aiScheduler.reset();
+    pendingEnemySpawns = 0;
+    for (auto& player : players) {
+        player.tank = nullptr; // Явно обнуляем перед переназначением
+        player.input = PlayerInput{};
+    }
+    nextObjectId = 1;
+    gameMap.resetToInitialState(); // Сбрасываем тайлы карты, если они могут быть изменены
+    walls.clear();
+    replicatedTiles.clear();
 
     // Проверяем координаты стартовой позиции игрока относительно текущих размеров карты
     if (gameMap.playerStart.first < 0 || gameMap.playerStart.first >= gameMap.getWidth() ||
@@ -33,25 +75,12 @@ void GameModel::reset() {
         return;
     }
 
-    float playerPixelX = gameMap.playerStart.first * TILE_SIZE;
-    float playerPixelY = gameMap.playerStart.second * TILE_SIZE;
-
-    // Дополнительная проверка
-    if (playerPixelX < 0 || playerPixelY < 0 ||
-        playerPixelX + TANK_SIZE > gameMap.getWidth() * TILE_SIZE ||
-        playerPixelY + TANK_SIZE > gameMap.getHeight() * TILE_SIZE) {
-        return;
+    for (int slot = 0; slot < static_cast<int>(players.size()); ++slot) {
+        if (players[slot].active) {
+            spawnPlayerTank(slot);
+        }
     }
 
-    auto player = std::make_unique<Tank>(
-        playerPixelX,
-        playerPixelY,
-        Direction::UP,
-        true
-    );
-    playerTank = player.get(); // Получаем указатель на танк игрока
-    gameObjects.push_back(std::move(player));
-
     // Создаем вражеские танки
     for (const auto& pos : gameMap.enemyStarts) {
         // Проверяем координаты стартовых позиций врагов
@@ -62,10 +91,10 @@ void GameModel::reset() {
         float enemyPixelX = pos.first * TILE_SIZE + (TILE_SIZE - TANK_SIZE) / 2.0f;
         float enemyPixelY = pos.second * TILE_SIZE + (TILE_SIZE - TANK_SIZE) / 2.0f;
 
-        gameObjects.push_back(std::make_unique<Tank>(
+        addTank(std::make_unique<Tank>(
             enemyPixelX,
             enemyPixelY,
-            static_cast<Direction>(rand() % 4), // Случайное начальное направление
+            static_cast<Direction>(rng() % 4), // Случайное начальное направление
             false
         ));
     }
@@ -73,60 +102,31 @@ void GameModel::reset() {
     state = GameState::PLAYING; // Явно устанавливаем состояние PLAYING при сбросе
     score = 0;
     gameTime = 0;
-    gameMap.resetToInitialState(); // Сбрасываем тайлы карты, если они могут быть изменены
     lastUpdateTime = std::chrono::steady_clock::now(); // Сбрасываем время для расчета deltaTime
+
+    tickCount = 0;
+    rewindBuffer.clear();
+    recordRewindTick();
 }
 
 bool GameModel::checkWallCollision(float x, float y, float width, float height) const {
-    const float mapWidth = gameMap.getWidth() * TILE_SIZE;
-    const float mapHeight = gameMap.getHeight() * TILE_SIZE;
-
-    // Проверяем границы карты
-    if (x < 0 || y < 0 || (x + width) > mapWidth || (y + height) > mapHeight) {
-        return true;
-    }
+    return GeometryKernels<Geometry>::boxHitsWall(wallGrid(), x, y, width, height);
+}
 
-    // Вычисляем диапазон покрываемых тайлов с безопасным эпсилоном
-    const int startTileX = static_cast<int>(x / TILE_SIZE);
-    const int startTileY = static_cast<int>(y / TILE_SIZE);
-    const int endTileX = static_cast<int>((x + width - 0.001f) / TILE_SIZE);
-    const int endTileY = static_cast<int>((y + height - 0.001f) / TILE_SIZE);
-
-    // Проверяем все тайлы в вычисленном диапазоне
-    for (int ty = startTileY; ty <= endTileY; ++ty) {
-        for (int tx = startTileX; tx <= endTileX; ++tx) {
-            // Защита от потенциальных ошибок округления
-            if (tx < 0 || tx >= gameMap.getWidth() || 
-                ty < 0 || ty >= gameMap.getHeight()) {
-                // Этот случай в идеале должен быть перехвачен начальной проверкой границ,
-                // но хорош для надежности, если объект частично внутри/снаружи
-                continue; 
-            }
-            
-            if (gameMap.getTile(tx, ty) == TileType::Wall) {
-                return true;
-            }
-        }
-    }
-    
-    return false; // Нет коллизий после проверки всех тайлов
+TileGrid GameModel::wallGrid() const {
+    return {gameMap.getTileData(), gameMap.getWidth(), gameMap.getHeight()};
 }
 
 void GameModel::update() {
     if (state != GameState::PLAYING) {
-        // Если игра окончена и playerTank существует, убеждаемся, что он помечен как уничтоженный
-        // Это может быть избыточно, если isDestroyed() точен, но как защита:
-        if (state == GameState::GAME_OVER && playerTank && !playerTank->isDestroyed()) {
-            // Этот случай в идеале не должен происходить, если playerTank->isDestroyed() корректно запускает GAME_OVER
-        }
         return;
     }
+    ARCADE_TRACE_ZONE("GameModel::update");
 
     auto now = std::chrono::steady_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastUpdateTime);
     float deltaTime = elapsed.count() / 1000.0f;
     lastUpdateTime = now;
-    gameTime += deltaTime;
   
     if (deltaTime > 0.0001f) { // Избегаем деления на ноль или крайне малого deltaTime
         fps = 1.0f / deltaTime;
@@ -134,50 +134,106 @@ void GameModel::update() {
         fps = 0; // Или какое-то высокое значение, но 0 указывает на проблему или фактически приостановленное состояние
     }
 
-    // Обновляем все игровые объекты
-    for (auto& obj : gameObjects) {
-        obj->update(deltaTime);
+    step(deltaTime);
+}
+
+void GameModel::step(float deltaTime) {
+    if (state != GameState::PLAYING) {
+        return;
+    }
+    ARCADE_TRACE_ZONE("GameModel::step");
+    ARCADE_ALLOC_PHASE("tick");
+    frameArena.reset(); // Временные списки прошлого тика больше не нужны
+    gameTime += deltaTime;
+
+    // Обновляем все игровые объекты; пули двигаются одним проходом по массиву
+    {
+        ARCADE_TRACE_ZONE("objects");
+        for (auto& obj : gameObjects) {
+            obj->update(deltaTime);
+        }
+        bullets.integrate();
     }
 
+    applyPlayerInput();       // Непрерывное движение и стрельба по удерживаемым клавишам
+
     updateEnemies(deltaTime); // Логика ИИ для врагов
     processCollisions();    // Обрабатываем взаимодействия и урон
 
-    // Проверяем смерть игрока *перед* удалением объектов, чтобы playerTank был еще действителен
-    // и его состояние можно было проверить через isDestroyed()
-    if (playerTank && playerTank->isDestroyed()) {
+    // Проверяем смерть игроков *перед* удалением объектов, пока их танки еще действительны.
+    // Игра окончена, когда погибли все активные игроки
+    bool anyActive = false;
+    bool anyAlive = false;
+    for (auto& player : players) {
+        if (player.tank && player.tank->isDestroyed()) {
+            player.tank = nullptr; // Объект танка будет удален ниже
+        }
+        anyActive = anyActive || player.active;
+        anyAlive = anyAlive || player.tank != nullptr;
+    }
+    if (anyActive && !anyAlive) {
         state = GameState::GAME_OVER;
-        // Не возвращаемся здесь, позволяем удалить объект танка игрока ниже, если он в gameObjects
     }
 
     // Удаляем уничтоженные объекты
-    // Будьте осторожны, если playerTank указывает на объект, который собирается быть удален
-    gameObjects.erase(
-        std::remove_if(gameObjects.begin(), gameObjects.end(),
-            [&](const std::unique_ptr<GameObject>& obj) { 
-                bool destroyed = obj->isDestroyed();
-                // Если объект playerTank уничтожен и удален, указатель playerTank будет висячим
-                // GameState::GAME_OVER должно предотвратить дальнейшие действия, зависящие от состояния объекта playerTank
-                // Доступ к playerTank->getHealth() через getPlayerHealth() сделан безопасным проверкой состояния игры
-                return destroyed; 
-            }),
-        gameObjects.end()
-    );
-
-    // После удаления, если playerTank был уничтожен, его объект больше не в gameObjects
-    // Указатель playerTank будет висячим
-    // GameState::GAME_OVER должно предотвратить дальнейшие действия, зависящие от playerTank
+    {
+        ARCADE_TRACE_ZONE("removeDestroyed");
+        tankBroadphase.removeDestroyed();
+        bullets.removeDestroyed();
+        gameObjects.erase(
+            std::remove_if(gameObjects.begin(), gameObjects.end(),
+                [&](const std::unique_ptr<GameObject>& obj) { 
+                    return obj->isDestroyed(); 
+                }),
+            gameObjects.end()
+        );
+    }
+
+    ++tickCount;
+    recordRewindTick();
+}
+
+void GameModel::applyPlayerInput() {
+    ARCADE_TRACE_ZONE("applyPlayerInput");
+    ARCADE_ALLOC_PHASE("input");
+    for (int slot = 0; slot < static_cast<int>(players.size()); ++slot) {
+        PlayerSlot& player = players[slot];
+        if (player.input.hasEvent) {
+            if (slot == localPlayer) {
+                // Отмечаем тик, применивший событие, - представление досчитает задержку до кадра
+                ++inputTiming.sequence;
+                inputTiming.eventTime = player.input.eventTime;
+                inputTiming.tickTime = std::chrono::steady_clock::now();
+            }
+            player.input.hasEvent = false;
+        }
+        if (player.input.move) {
+            movePlayerTank(player.tank, player.input.moveDirection);
+        }
+        if (player.input.fire) {
+            firePlayerTank(player.tank);
+        }
+    }
 }
 
 void GameModel::playerMove(Direction dir) {
-    if (playerTank && !playerTank->isDestroyed() && state == GameState::PLAYING) {
-        float currentX = playerTank->getX();
-        float currentY = playerTank->getY();
-        float speed = playerTank->getSpeed();
+    movePlayerTank(localTank(), dir);
+}
+
+void GameModel::playerFire() {
+    firePlayerTank(localTank());
+}
+
+void GameModel::movePlayerTank(Tank* tank, Direction dir) {
+    if (tank && !tank->isDestroyed() && state == GameState::PLAYING) {
+        float currentX = tank->getX();
+        float currentY = tank->getY();
+        float speed = tank->getSpeed();
 
         float potentialX = currentX;
         float potentialY = currentY;
 
-        playerTank->setDirection(dir); // Устанавливаем направление независимо от движения
+        tank->setDirection(dir); // Устанавливаем направление независимо от движения
 
         switch (dir) {
             case Direction::UP:    potentialY -= speed; break;
@@ -187,18 +243,18 @@ void GameModel::playerMove(Direction dir) {
         }
 
         if (!checkWallCollision(potentialX, potentialY, TANK_SIZE, TANK_SIZE)) {
-            playerTank->setPosition(potentialX, potentialY);
+            moveTank(tank, potentialX, potentialY);
         }
     }
 }
 
-void GameModel::playerFire() {
-    if (playerTank && playerTank->canFire() && state == GameState::PLAYING) { // Проверяем, может ли танк стрелять
-        playerTank->fire(); // Это сбросит внутренний таймер стрельбы танка
+void GameModel::firePlayerTank(Tank* tank) {
+    if (tank && tank->canFire() && state == GameState::PLAYING) { // Проверяем, может ли танк стрелять
+        tank->fire(); // Это сбросит внутренний таймер стрельбы танка
     
-        float bulletX = playerTank->getX() + TANK_SIZE / 2.0f; // Начинаем из центра танка
-        float bulletY = playerTank->getY() + TANK_SIZE / 2.0f;
-        Direction dir = playerTank->getDirection();
+        float bulletX = tank->getX() + TANK_SIZE / 2.0f; // Начинаем из центра танка
+        float bulletY = tank->getY() + TANK_SIZE / 2.0f;
+        Direction dir = tank->getDirection();
     
         // Корректируем начальную позицию пули, чтобы она была на краю танка, перед башней
         float offset = TANK_SIZE / 2.0f + 1.0f; // Небольшое смещение, чтобы очистить корпус танка
@@ -209,301 +265,794 @@ void GameModel::playerFire() {
             case Direction::RIGHT: bulletX += offset; break;
         }
     
-        addBullet(std::make_unique<Bullet>(bulletX, bulletY, dir, true));
+        addBullet(bulletX, bulletY, dir, true);
     }
 }
 
-void GameModel::addBullet(std::unique_ptr<Bullet> bullet) {
-    gameObjects.push_back(std::move(bullet));
+void GameModel::setPlayerInput(int slot, const PlayerInput& input) {
+    if (slot >= 0 && slot < static_cast<int>(players.size())) {
+        players[slot].input = input;
+    }
 }
 
-bool GameModel::isCellFree(float x, float y) const {
-    // Эта функция проверяет одну точку. Может потребоваться обновление или удаление
-    // если checkWallCollision используется везде для проверки областей
-    int tileX = static_cast<int>(x / TILE_SIZE);
-    int tileY = static_cast<int>(y / TILE_SIZE);
-    if (tileX < 0 || tileX >= gameMap.getWidth() || tileY < 0 || tileY >= gameMap.getHeight()) {
-        return false; // За пределами карты не свободно
+int GameModel::addPlayer() {
+    int slot = 0;
+    while (slot < static_cast<int>(players.size()) && players[slot].active) {
+        ++slot;
+    }
+    if (slot >= MAX_PLAYERS) {
+        return -1;
+    }
+    if (slot == static_cast<int>(players.size())) {
+        players.emplace_back();
+    }
+    players[slot].active = true;
+    players[slot].input = PlayerInput{};
+    spawnPlayerTank(slot);
+    return slot;
+}
+
+bool GameModel::spawnPlayer(int slot) {
+    if (slot < 0 || slot >= static_cast<int>(players.size()) || !players[slot].active || players[slot].tank) {
+        return false;
     }
-    return gameMap.getTile(tileX, tileY) != TileType::Wall;
+    return spawnPlayerTank(slot);
+}
+
+void GameModel::removePlayer(int slot) {
+    if (slot < 0 || slot >= static_cast<int>(players.size())) {
+        return;
+    }
+    PlayerSlot& player = players[slot];
+    if (player.tank) {
+        // Танк уничтожается без начисления очков и удаляется в следующем тике
+        spawnSlots.tankRemoved(player.tank->getX(), player.tank->getY());
+        player.tank->takeDamage(player.tank->getHealth());
+        player.tank = nullptr;
+    }
+    player.active = false;
+    player.input = PlayerInput{};
+}
+
+void GameModel::clearPlayers() {
+    for (int slot = 0; slot < static_cast<int>(players.size()); ++slot) {
+        removePlayer(slot);
+    }
+}
+
+bool GameModel::isPlayerAlive(int slot) const {
+    return slot >= 0 && slot < static_cast<int>(players.size()) &&
+           players[slot].tank && !players[slot].tank->isDestroyed();
+}
+
+bool GameModel::spawnPlayerTank(int slot) {
+    float x = 0;
+    float y = 0;
+    const auto& starts = gameMap.playerStarts;
+    if (slot < static_cast<int>(starts.size())) {
+        x = starts[slot].first * TILE_SIZE;
+        y = starts[slot].second * TILE_SIZE;
+        if (x < 0 || y < 0 || x + TANK_SIZE > gameMap.getWidth() * TILE_SIZE ||
+            y + TANK_SIZE > gameMap.getHeight() * TILE_SIZE) {
+            return false;
+        }
+    } else {
+        // Точек 'P' на карте меньше, чем игроков: берем свободную точку появления
+        FrameVector<std::pair<float, float>> spawnPositions{FrameAllocator<std::pair<float, float>>(frameArena)};
+        spawnSlots.pickFreeSlots(1, rng, spawnPositions);
+        if (spawnPositions.empty()) {
+            return false;
+        }
+        x = spawnPositions[0].first;
+        y = spawnPositions[0].second;
+    }
+    Tank* tank = addTank(std::make_unique<Tank>(x, y, Direction::UP, true));
+    tank->setPlayerSlot(slot);
+    players[slot].tank = tank;
+    return true;
+}
+
+Tank* GameModel::localTank() const {
+    if (localPlayer < 0 || localPlayer >= static_cast<int>(players.size())) {
+        return nullptr;
+    }
+    return players[localPlayer].tank;
+}
+
+void GameModel::addBullet(float x, float y, Direction dir, bool fromPlayer) {
+    bullets.add(nextObjectId++, x, y, dir, fromPlayer);
+}
+
+bool GameModel::isCellFree(float x, float y) const {
+    return GeometryKernels<Geometry>::isPointFree(wallGrid(), x, y);
+}
+
+bool GameModel::findPath(std::pair<int, int> fromTile, std::pair<int, int> toTile,
+                         std::vector<std::pair<int, int>>& outPath) {
+    return pathfinder.findPath(fromTile, toTile, outPath);
 }
 
 int GameModel::getPlayerHealth() const {
     if (state == GameState::GAME_OVER) return 0; // Если игра окончена, здоровье игрока фактически 0
-    return playerTank ? playerTank->getHealth() : 0;
+    Tank* tank = localTank();
+    return tank ? tank->getHealth() : 0;
 }
 
 bool GameModel::isPlayerDead() const {
     // Этот метод в основном для GameWindow для проверки
     // Внутренняя логика GameModel должна полагаться на playerTank->isDestroyed() и затем устанавливать GameState
     if (state == GameState::GAME_OVER) return true; // Если игра окончена, игрок считается мертвым
-    if (!playerTank) return true; // Не должно происходить, если игра была в процессе и состояние не GAME_OVER
-    return playerTank->isDestroyed();
+    Tank* tank = localTank();
+    if (!tank) return true; // Локальный игрок погиб или еще не появился
+    return tank->isDestroyed();
 }
 
 void GameModel::updateEnemies(float deltaTime) {
-    for (auto& obj : gameObjects) {
-        Tank* tank = dynamic_cast<Tank*>(obj.get());
+    ARCADE_TRACE_ZONE("updateEnemies");
+    ARCADE_ALLOC_PHASE("ai");
+    FrameVector<std::pair<float, float>> playerPositions{FrameAllocator<std::pair<float, float>>(frameArena)};
+    playerPositions.reserve(players.size());
+    for (const auto& player : players) {
+        if (player.tank && !player.tank->isDestroyed()) {
+            playerPositions.push_back({player.tank->getX(), player.tank->getY()});
+        }
+    }
+    simulationLod.beginTick(playerPositions, bullets);
+
+    // Проход по кругу с места, где остановился прошлый тик (без бюджета - всегда с начала)
+    aiScheduler.beginTick(tickCount);
+    const size_t objectCount = gameObjects.size();
+    const size_t firstIndex = aiScheduler.firstIndex(gameObjects);
+    for (size_t n = 0; n < objectCount; ++n) {
+        size_t index = firstIndex + n;
+        if (index >= objectCount) {
+            index -= objectCount;
+        }
+        Tank* tank = dynamic_cast<Tank*>(gameObjects[index].get());
         if (tank && !tank->isPlayer() && !tank->isDestroyed() && state == GameState::PLAYING) {
-            // Движение ИИ
-            if (rand() % 150 < 5) { // Корректируем частоту принятия решений о движении
-                Direction moveDir = static_cast<Direction>(rand() % 4);
-            
-                float currentX = tank->getX();
-                float currentY = tank->getY();
-                float speed = tank->getSpeed();
+            const SimulationLod::Tier tier = simulationLod.tierAt(tank->getX(), tank->getY());
+            simulationLod.countEnemy(tier);
+            if (!tank->isAiPending() && !simulationLod.shouldThink(tier, tank->getId(), tickCount)) {
+                continue; // Дальний спит, средний ждет своего тика
+            }
+            if (!aiScheduler.admit()) {
+                aiScheduler.defer(*tank);
+                continue;
+            }
+            aiScheduler.thought(*tank);
+            thinkEnemy(tank, tier);
+        }
+    }
+    aiScheduler.endTick();
+}
 
-                float potentialX = currentX;
-                float potentialY = currentY;
-            
-                tank->setDirection(moveDir);
+void GameModel::thinkEnemy(Tank* tank, SimulationLod::Tier tier) {
+    // Движение ИИ
+    if (rng() % 150 < simulationLod.moveChance(tier)) { // Корректируем частоту принятия решений о движении
+        // Пытаемся двигаться на долю размера танка для дискретного шага
+        float testMoveAmount = TANK_SIZE / 4.0f;
+        Direction moveDir;
+        // Часть ходов - по пути к ближайшему игроку в обход стен, остальные - случайные
+        if (!(rng() % 100 < PATH_MOVE_CHANCE && aiScheduler.admitPathQuery(*tank) &&
+              findPathDirection(tank, moveDir, testMoveAmount))) {
+            moveDir = static_cast<Direction>(rng() % 4);
+        }
+    
+        float currentX = tank->getX();
+        float currentY = tank->getY();
 
-                // Пытаемся двигаться на долю размера танка для дискретного шага
-                constexpr float testMoveAmount = TANK_SIZE / 4.0f; 
+        float potentialX = currentX;
+        float potentialY = currentY;
+    
+        tank->setDirection(moveDir);
 
-                switch (moveDir) {
-                    case Direction::UP:    potentialY = currentY - testMoveAmount; break;
-                    case Direction::DOWN:  potentialY = currentY + testMoveAmount; break;
-                    case Direction::LEFT:  potentialX = currentX - testMoveAmount; break;
-                    case Direction::RIGHT: potentialX = currentX + testMoveAmount; break;
-                }
-            
-                if (!checkWallCollision(potentialX, potentialY, TANK_SIZE, TANK_SIZE)) {
-                    // Проверяем коллизию с другими танками перед движением
-                    bool collisionWithOtherTank = false;
-                    for (const auto& otherObj : gameObjects) {
-                        if (otherObj.get() == tank) continue; // Пропускаем себя
-                        const Tank* otherTank = dynamic_cast<const Tank*>(otherObj.get());
-                        if (otherTank && !otherTank->isDestroyed()) {
-                            float otherLeft = otherTank->getX();
-                            float otherRight = otherTank->getX() + TANK_SIZE;
-                            float otherTop = otherTank->getY();
-                            float otherBottom = otherTank->getY() + TANK_SIZE;
-
-                            if (potentialX + TANK_SIZE > otherLeft && potentialX < otherRight &&
-                                potentialY + TANK_SIZE > otherTop && potentialY < otherBottom) {
-                                collisionWithOtherTank = true;
-                                break;
-                            }
-                        }
-                    }
-                    if (!collisionWithOtherTank) {
-                       tank->setPosition(potentialX, potentialY);
-                    }
-                }
-            }
-        
-            // Стрельба ИИ
-            if (rand() % 100 < 2 && tank->canFire()) { // Проверяем, может ли танк стрелять
-                tank->fire(); // Сбрасываем таймер стрельбы танка
-            
-                float bulletX = tank->getX() + TANK_SIZE / 2.0f;
-                float bulletY = tank->getY() + TANK_SIZE / 2.0f;
-                Direction dir = tank->getDirection();
-            
-                float offset = TANK_SIZE / 2.0f + 1.0f;
-                switch (dir) {
-                    case Direction::UP:    bulletY -= offset; break;
-                    case Direction::DOWN:  bulletY += offset; break;
-                    case Direction::LEFT:  bulletX -= offset; break;
-                    case Direction::RIGHT: bulletX += offset; break;
-                }
-                addBullet(std::make_unique<Bullet>(bulletX, bulletY, dir, false));
+        switch (moveDir) {
+            case Direction::UP:    potentialY = currentY - testMoveAmount; break;
+            case Direction::DOWN:  potentialY = currentY + testMoveAmount; break;
+            case Direction::LEFT:  potentialX = currentX - testMoveAmount; break;
+            case Direction::RIGHT: potentialX = currentX + testMoveAmount; break;
+        }
+    
+        if (!checkWallCollision(potentialX, potentialY, TANK_SIZE, TANK_SIZE)) {
+            // Проверяем коллизию с другими танками перед движением (только соседи по оси X)
+            if (!tankBroadphase.anyOverlap(potentialX, potentialY, TANK_SIZE, TANK_SIZE, tank)) {
+               moveTank(tank, potentialX, potentialY);
             }
         }
     }
+
+    // Стрельба ИИ: только когда игрок на линии огня и стен между ними нет.
+    // Небольшой случайный порог дает время реакции, чтобы враги не стреляли мгновенно
+    Direction fireDir;
+    if (tank->canFire() && findLineOfFire(tank, fireDir) && rng() % 100 < simulationLod.fireChance(tier)) {
+        tank->setDirection(fireDir);
+        tank->fire(); // Сбрасываем таймер стрельбы танка
+    
+        float bulletX = tank->getX() + TANK_SIZE / 2.0f;
+        float bulletY = tank->getY() + TANK_SIZE / 2.0f;
+        Direction dir = tank->getDirection();
+    
+        float offset = TANK_SIZE / 2.0f + 1.0f;
+        switch (dir) {
+            case Direction::UP:    bulletY -= offset; break;
+            case Direction::DOWN:  bulletY += offset; break;
+            case Direction::LEFT:  bulletX -= offset; break;
+            case Direction::RIGHT: bulletX += offset; break;
+        }
+        addBullet(bulletX, bulletY, dir, false);
+    }
+}
+
+void GameModel::damageWalls() {
+    // До этого прохода живы все пули, поэтому уничтоженные сейчас попали в стену или
+    // вылетели за край карты. Стена - тайл центра пули, как в ядре markWallHits
+    for (size_t i = 0; i < bullets.size(); ++i) {
+        if (!bullets.isDestroyed(i)) {
+            continue;
+        }
+        const int tileX = Geometry::tileOf(bullets.getX(i));
+        const int tileY = Geometry::tileOf(bullets.getY(i));
+        if (walls.damage(gameMap, tileX, tileY, bullets.getDamage(i))) {
+            gameMap.setTile(tileX, tileY, TileType::Empty); // Наблюдатели обновятся в этом же тике
+        }
+    }
+}
+
+bool GameModel::findPathDirection(const Tank* tank, Direction& outDir, float& inOutStep) {
+    const Tank* target = nullptr;
+    float targetDistance = 0.0f;
+    for (const auto& player : players) {
+        if (!player.tank || player.tank->isDestroyed()) continue;
+        float distance = std::abs(player.tank->getX() - tank->getX()) + std::abs(player.tank->getY() - tank->getY());
+        if (!target || distance < targetDistance) {
+            target = player.tank;
+            targetDistance = distance;
+        }
+    }
+    if (!target) {
+        return false;
+    }
+
+    constexpr float half = TANK_SIZE / 2.0f;
+    const std::pair<int, int> from{Geometry::tileOf(tank->getX() + half), Geometry::tileOf(tank->getY() + half)};
+    const std::pair<int, int> to{Geometry::tileOf(target->getX() + half), Geometry::tileOf(target->getY() + half)};
+    if (from == to || !pathfinder.findPath(from, to, aiPath) || aiPath.size() < 2) {
+        return false;
+    }
+
+    // Танк меньше тайла: прежде чем идти в соседний тайл, он выравнивается по поперечной
+    // оси внутри своего, иначе в проходе шириной в тайл упрется в угол. Шаг выравнивания
+    // укорачивается до нужного, чтобы танк не проскакивал узкое окно
+    const bool horizontal = aiPath[1].first != from.first;
+    const float position = horizontal ? tank->getY() : tank->getX();
+    const float low = (horizontal ? from.second : from.first) * TILE_SIZE;
+    const float high = low + TILE_SIZE - TANK_SIZE;
+    if (position < low) {
+        outDir = horizontal ? Direction::DOWN : Direction::RIGHT;
+        inOutStep = std::min(inOutStep, low - position);
+    } else if (position > high) {
+        outDir = horizontal ? Direction::UP : Direction::LEFT;
+        inOutStep = std::min(inOutStep, position - high);
+    } else if (horizontal) {
+        outDir = aiPath[1].first > from.first ? Direction::RIGHT : Direction::LEFT;
+    } else {
+        outDir = aiPath[1].second > from.second ? Direction::DOWN : Direction::UP;
+    }
+    return true;
+}
+
+bool GameModel::findLineOfFire(const Tank* shooter, Direction& outDir) const {
+    // Враг стреляет по первому игроку, который оказался на линии огня
+    for (const auto& player : players) {
+        if (player.tank && !player.tank->isDestroyed() && findLineOfFire(shooter, player.tank, outDir)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool GameModel::findLineOfFire(const Tank* shooter, const Tank* target, Direction& outDir) const {
+    constexpr float BULLET_RADIUS = Geometry::BULLET_RADIUS;
+    const float centerX = shooter->getX() + TANK_SIZE / 2.0f;
+    const float centerY = shooter->getY() + TANK_SIZE / 2.0f;
+    const float targetLeft = target->getX();
+    const float targetTop = target->getY();
+    const float targetRight = targetLeft + TANK_SIZE;
+    const float targetBottom = targetTop + TANK_SIZE;
+    const int tileX = Geometry::tileOf(centerX);
+    const int tileY = Geometry::tileOf(centerY);
+
+    // Пуля летит по линии центра танка и проверяет стены по тайлу своего центра,
+    // поэтому достаточно проверить строку (столбец) тайлов до ближнего края цели
+    if (centerY + BULLET_RADIUS > targetTop && centerY - BULLET_RADIUS < targetBottom) {
+        bool right = targetLeft > centerX;
+        int targetTileX = right ? Geometry::tileOf(targetLeft) : Geometry::lastTileBefore(targetRight);
+        if (lineOfSight.isRowClear(tileY, tileX, targetTileX)) {
+            outDir = right ? Direction::RIGHT : Direction::LEFT;
+            return true;
+        }
+    }
+    if (centerX + BULLET_RADIUS > targetLeft && centerX - BULLET_RADIUS < targetRight) {
+        bool down = targetTop > centerY;
+        int targetTileY = down ? Geometry::tileOf(targetTop) : Geometry::lastTileBefore(targetBottom);
+        if (lineOfSight.isColumnClear(tileX, tileY, targetTileY)) {
+            outDir = down ? Direction::DOWN : Direction::UP;
+            return true;
+        }
+    }
+    return false;
 }
 
 void GameModel::processCollisions() {
-    // Коллизии пуль (итерируем осторожно, так как пули могут быть уничтожены)
-    for (auto it_bullet = gameObjects.begin(); it_bullet != gameObjects.end(); ) {
-        Bullet* bullet = dynamic_cast<Bullet*>(it_bullet->get());
-        if (!bullet || bullet->isDestroyed()) {
-            ++it_bullet;
+    ARCADE_TRACE_ZONE("processCollisions");
+    ARCADE_ALLOC_PHASE("collisions");
+    // Коллизии пуль со стенами и краем карты - одним векторным проходом
+    bullets.markWallHits(gameMap.getTileData(), gameMap.getWidth(), gameMap.getHeight(), TILE_SIZE);
+    if (walls.isEnabled()) {
+        damageWalls();
+    }
+
+    // Коллизии пуль с танками. Кандидаты упакованы в порядке широкой фазы (по левому
+    // краю), и каждая пуля проверяется только против полосы танков, чей X-интервал
+    // достает до нее. Пули идут по возрастанию id, а из нескольких пересечений
+    // выбирается танк с меньшим id, как в прежнем переборе объектов, поэтому
+    // порядок урона не изменился
+    Tank** hitCandidates = frameArena.allocateArray<Tank*>(tankBroadphase.size());
+    const size_t candidateCount = tankBroadphase.collectAlive(hitCandidates);
+    tankHits.pack(hitCandidates, candidateCount);
+    for (size_t b = 0; b < bullets.size() && candidateCount > 0; ++b) {
+        if (bullets.isDestroyed(b)) {
             continue;
         }
-    
-        // Коллизия пули со стеной
-        int tileX = static_cast<int>(std::floor(bullet->getX() / TILE_SIZE));
-        int tileY = static_cast<int>(std::floor(bullet->getY() / TILE_SIZE));
-
-        if (tileX < 0 || tileX >= gameMap.getWidth() || tileY < 0 || tileY >= gameMap.getHeight() ||
-            gameMap.getTile(tileX, tileY) == TileType::Wall) {
-            bullet->destroy();
-            ++it_bullet; // Переходим к следующему объекту после обработки текущей пули
+        const bool fromPlayer = bullets.isFromPlayer(b);
+        const float bulletX = bullets.getX(b);
+        const float bulletY = bullets.getY(b);
+        const uint32_t targets = TankHitKernel::targetsOf(fromPlayer);
+        size_t first = 0;
+        size_t last = 0;
+        tankHits.candidatesNear(bulletX - BulletArray::RADIUS, bulletX + BulletArray::RADIUS, first, last);
+        // Дружественный огонь и самоповреждение отсекаются маской стороны внутри ядра
+        int hit = tankHits.findHit(bulletX, bulletY, BulletArray::RADIUS, targets, first, last);
+        if (hit < 0) {
             continue;
         }
-    
-        // Коллизия пули с танком
-        bool bullet_hit_tank = false;
-        for (auto it_tank = gameObjects.begin(); it_tank != gameObjects.end(); ++it_tank) {
-            // Не перепроверяем саму пулю, если она в том же цикле (не проблема здесь из-за dynamic_cast)
-            if (it_tank->get() == bullet) continue;
-
-            Tank* tank = dynamic_cast<Tank*>(it_tank->get());
-            if (!tank || tank->isDestroyed()) continue;
-        
-            // Предотвращаем дружественный огонь или самоповреждение пулями
-            if (bullet->isFromPlayer() == tank->isPlayer()) continue;
-        
-            // Проверка коллизии AABB для пули и танка
-            float bulletLeft = bullet->getX() - 3; // Радиус пули равен 3
-            float bulletRight = bullet->getX() + 3;
-            float bulletTop = bullet->getY() - 3;
-            float bulletBottom = bullet->getY() + 3;
-
-            float tankLeft = tank->getX();
-            float tankRight = tank->getX() + TANK_SIZE;
-            float tankTop = tank->getY();
-            float tankBottom = tank->getY() + TANK_SIZE;
-
-            if (bulletRight > tankLeft && bulletLeft < tankRight &&
-                bulletBottom > tankTop && bulletTop < tankBottom) {
-                tank->takeDamage(bullet->getDamage());
-                bullet->destroy();
-                bullet_hit_tank = true; // Помечаем пулю для уничтожения
-                          
-                if (bullet->isFromPlayer() && tank->isDestroyed()) {
-                    score += 100;
-                    spawnNewEnemyRandomly(); // Создаем нового врага
-                }
-                // Если вражеская пуля убила игрока, playerTank->isDestroyed() будет true
-                // GameModel::update() установит GameState::GAME_OVER
-                break; // Пуля попадает в один танк и уничтожается
+        int next = hit;
+        while ((next = tankHits.findHit(bulletX, bulletY, BulletArray::RADIUS, targets,
+                                        static_cast<size_t>(next) + 1, last)) >= 0) {
+            if (tankHits.getTank(next)->getId() < tankHits.getTank(hit)->getId()) {
+                hit = next;
             }
         }
-        if (bullet_hit_tank) {
-            // Пуля уже помечена как уничтоженная, будет очищена основным циклом erase
+        Tank* tank = tankHits.getTank(hit);
+        tank->takeDamage(bullets.getDamage(b));
+        bullets.destroy(b); // Пуля попадает в один танк и уничтожается
+
+        if (tank->isDestroyed()) {
+            tankHits.disable(hit);
+            // Погибший танк сразу освобождает точки появления под собой
+            spawnSlots.tankRemoved(tank->getX(), tank->getY());
+            if (fromPlayer) {
+                score += 100;
+                ++pendingEnemySpawns; // Новый враг появится после прохода по объектам
+            }
         }
-        ++it_bullet; // Переходим к следующему объекту
-    } // Конец цикла коллизий пуль
+        // Если вражеская пуля убила последнего игрока,
+        // GameModel::step() установит GameState::GAME_OVER
+    }
+
+    // Добавление объектов внутри цикла выше сделало бы итераторы недействительными,
+    // поэтому замены убитым врагам создаются одной пачкой здесь
+    if (pendingEnemySpawns > 0) {
+        spawnEnemies(pendingEnemySpawns);
+        pendingEnemySpawns = 0;
+    }
     
-    // Коллизии танк-танк (простое расталкивание) - выполняется после коллизий пуль
-    for (size_t i = 0; i < gameObjects.size(); ++i) {
-        Tank* tank1 = dynamic_cast<Tank*>(gameObjects[i].get());
-        if (!tank1 || tank1->isDestroyed()) continue;
-          
-        for (size_t j = i + 1; j < gameObjects.size(); ++j) {
-            Tank* tank2 = dynamic_cast<Tank*>(gameObjects[j].get());
-            if (!tank2 || tank2->isDestroyed()) continue;
+    // Коллизии танк-танк (простое расталкивание) - выполняется после коллизий пуль.
+    // Кандидаты берутся из широкой фазы, точная проверка расстояния - ниже
+    FrameVector<std::pair<Tank*, Tank*>> tankPairs{FrameAllocator<std::pair<Tank*, Tank*>>(frameArena)};
+    tankPairs.reserve(gameObjects.size());
+    tankBroadphase.findPairs(tankPairs);
+    for (auto [tank1, tank2] : tankPairs) {
+        if (tank1->isDestroyed() || tank2->isDestroyed()) continue;
 
+        float pushX = 0; // Толкаем на половину перекрытия вдоль линии центров
+        float pushY = 0;
+        bool overlapping = false; // Перекрываются и не совпадают
+        bool coincident = false;
+        if constexpr (FixedPoint::ENABLED) {
+            // Целые доли пикселя: ни эпсилонов, ни sqrt в float. Центры смещены от позиций
+            // одинаково, поэтому разность позиций - это разность центров
+            const int64_t dx = FixedPoint::fromFloat(tank1->getX()) - FixedPoint::fromFloat(tank2->getX());
+            const int64_t dy = FixedPoint::fromFloat(tank1->getY()) - FixedPoint::fromFloat(tank2->getY());
+            const int64_t distance = FixedPoint::isqrt(static_cast<uint64_t>(dx * dx + dy * dy));
+            constexpr int64_t minDistance = FixedPoint::fromFloat(TANK_SIZE);
+            coincident = dx == 0 && dy == 0;
+            overlapping = !coincident && distance < minDistance;
+            if (overlapping) {
+                const int64_t overlap = minDistance - distance;
+                pushX = FixedPoint::toFloat(static_cast<FixedPoint::Units>(dx * overlap / (2 * distance)));
+                pushY = FixedPoint::toFloat(static_cast<FixedPoint::Units>(dy * overlap / (2 * distance)));
+            }
+        } else {
             float dx = (tank1->getX() + TANK_SIZE/2.0f) - (tank2->getX() + TANK_SIZE/2.0f); // От центра к центру
             float dy = (tank1->getY() + TANK_SIZE/2.0f) - (tank2->getY() + TANK_SIZE/2.0f);
             float distance = std::sqrt(dx*dx + dy*dy);
             float min_dist = TANK_SIZE; // Минимальное расстояние до того, как они считаются перекрывающимися
-
-            if (distance < min_dist && distance > 0.001f) { // Если перекрываются и не идеально совпадают
+            overlapping = distance < min_dist && distance > 0.001f;
+            coincident = distance < 0.001f;
+            if (overlapping) {
                 float overlap = TANK_SIZE - distance;
-                float pushX = (dx / distance) * overlap / 2.0f; // Толкаем на половину перекрытия
-                float pushY = (dy / distance) * overlap / 2.0f;
-                
-                // Предварительные новые позиции
-                float tank1NewX = tank1->getX() + pushX;
-                float tank1NewY = tank1->getY() + pushY;
-                float tank2NewX = tank2->getX() - pushX;
-                float tank2NewY = tank2->getY() - pushY;
-                
-                // Проверяем коллизии перед применением толчка, чтобы предотвратить толкание в стены
-                // Это упрощенная модель
-                if (!checkWallCollision(tank1NewX, tank1NewY, TANK_SIZE, TANK_SIZE)) {
-                    tank1->setPosition(tank1NewX, tank1NewY);
-                } else if (!checkWallCollision(tank2->getX(), tank2->getY(), TANK_SIZE, TANK_SIZE)) { 
-                    // Если tank1 не может двигаться, пытаемся двигать только tank2 от исходной позиции tank1
-                    float tank2NewX_alt = tank2->getX() - 2*pushX; // Толкаем tank2 на полное перекрытие
-                    float tank2NewY_alt = tank2->getY() - 2*pushY;
-                     if (!checkWallCollision(tank2NewX_alt, tank2NewY_alt, TANK_SIZE, TANK_SIZE)) {
-                         tank2->setPosition(tank2NewX_alt, tank2NewY_alt);
-                     }
-                }
+                pushX = (dx / distance) * overlap / 2.0f;
+                pushY = (dy / distance) * overlap / 2.0f;
+            }
+        }
+
+        if (overlapping) {
+            // Предварительные новые позиции
+            float tank1NewX = tank1->getX() + pushX;
+            float tank1NewY = tank1->getY() + pushY;
+            float tank2NewX = tank2->getX() - pushX;
+            float tank2NewY = tank2->getY() - pushY;
+            
+            // Проверяем коллизии перед применением толчка, чтобы предотвратить толкание в стены
+            // Это упрощенная модель
+            if (!checkWallCollision(tank1NewX, tank1NewY, TANK_SIZE, TANK_SIZE)) {
+                moveTank(tank1, tank1NewX, tank1NewY);
+            } else if (!checkWallCollision(tank2->getX(), tank2->getY(), TANK_SIZE, TANK_SIZE)) { 
+                // Если tank1 не может двигаться, пытаемся двигать только tank2 от исходной позиции tank1
+                float tank2NewX_alt = tank2->getX() - 2*pushX; // Толкаем tank2 на полное перекрытие
+                float tank2NewY_alt = tank2->getY() - 2*pushY;
+                 if (!checkWallCollision(tank2NewX_alt, tank2NewY_alt, TANK_SIZE, TANK_SIZE)) {
+                     moveTank(tank2, tank2NewX_alt, tank2NewY_alt);
+                 }
+            }
 
-                if (!checkWallCollision(tank2NewX, tank2NewY, TANK_SIZE, TANK_SIZE)) {
-                    tank2->setPosition(tank2NewX, tank2NewY);
-                } else if (!checkWallCollision(tank1->getX(), tank1->getY(), TANK_SIZE, TANK_SIZE)) {
-                    float tank1NewX_alt = tank1->getX() + 2*pushX;
-                    float tank1NewY_alt = tank1->getY() + 2*pushY;
-                    if (!checkWallCollision(tank1NewX_alt, tank1NewY_alt, TANK_SIZE, TANK_SIZE)) {
-                        tank1->setPosition(tank1NewX_alt, tank1NewY_alt);
-                    }
+            if (!checkWallCollision(tank2NewX, tank2NewY, TANK_SIZE, TANK_SIZE)) {
+                moveTank(tank2, tank2NewX, tank2NewY);
+            } else if (!checkWallCollision(tank1->getX(), tank1->getY(), TANK_SIZE, TANK_SIZE)) {
+                float tank1NewX_alt = tank1->getX() + 2*pushX;
+                float tank1NewY_alt = tank1->getY() + 2*pushY;
+                if (!checkWallCollision(tank1NewX_alt, tank1NewY_alt, TANK_SIZE, TANK_SIZE)) {
+                    moveTank(tank1, tank1NewX_alt, tank1NewY_alt);
                 }
-            } else if (distance < 0.001f) { // Идеально совпадают, толкаем по оси x как запасной вариант
-                  float tank1NewX_pc = tank1->getX() + TANK_SIZE / 4.0f; // Толкаем на небольшое количество
-                  float tank2NewX_pc = tank2->getX() - TANK_SIZE / 4.0f;
-                  if (!checkWallCollision(tank1NewX_pc, tank1->getY(), TANK_SIZE, TANK_SIZE)) {
-                      tank1->setPosition(tank1NewX_pc, tank1->getY());
-                  }
-                  if (!checkWallCollision(tank2NewX_pc, tank2->getY(), TANK_SIZE, TANK_SIZE)) {
-                      tank2->setPosition(tank2NewX_pc, tank2->getY());
-                  }
             }
+        } else if (coincident) { // Идеально совпадают, толкаем по оси x как запасной вариант
+              float tank1NewX_pc = tank1->getX() + TANK_SIZE / 4.0f; // Толкаем на небольшое количество
+              float tank2NewX_pc = tank2->getX() - TANK_SIZE / 4.0f;
+              if (!checkWallCollision(tank1NewX_pc, tank1->getY(), TANK_SIZE, TANK_SIZE)) {
+                  moveTank(tank1, tank1NewX_pc, tank1->getY());
+              }
+              if (!checkWallCollision(tank2NewX_pc, tank2->getY(), TANK_SIZE, TANK_SIZE)) {
+                  moveTank(tank2, tank2NewX_pc, tank2->getY());
+              }
         }
     }
 } // Конец цикла коллизий танк-танк
 
-bool GameModel::findEmptySpawnLocation(float& outX, float& outY) {
-    std::vector<std::pair<int, int>> possibleSpawns = gameMap.enemyStarts;
-    if (possibleSpawns.empty()) {
-        // Запасной вариант: если нет предопределенных стартов врагов, мы не можем создать используя этот метод
-        // Более сложный метод мог бы найти любой пустой тайл на карте
+void GameModel::captureSnapshot(GameSnapshot& outSnapshot, bool withRngState) const {
+    outSnapshot.tick = tickCount;
+    outSnapshot.mapWidth = gameMap.getWidth();
+    outSnapshot.mapHeight = gameMap.getHeight();
+
+    // Отличия от исходной карты - измененные тайлы и поврежденные стены. Список собирается
+    // прямо в снимке: снимки переиспользуются между тиками, поэтому память не выделяется
+    auto& records = outSnapshot.tileChanges;
+    records.clear();
+    auto addCandidate = [&records](const std::pair<int, int>& pos) {
+        GameSnapshot::TileRecord record;
+        record.x = pos.first;
+        record.y = pos.second;
+        records.push_back(record);
+    };
+    for (const auto& pos : gameMap.getModifiedTiles()) {
+        addCandidate(pos);
+    }
+    for (const auto& pos : walls.getDamagedTiles()) {
+        addCandidate(pos);
+    }
+    auto samePosition = [](const GameSnapshot::TileRecord& a, const GameSnapshot::TileRecord& b) {
+        return a.x == b.x && a.y == b.y;
+    };
+    std::sort(records.begin(), records.end(), [](const GameSnapshot::TileRecord& a, const GameSnapshot::TileRecord& b) {
+        return a.x != b.x ? a.x < b.x : a.y < b.y;
+    });
+    records.erase(std::unique(records.begin(), records.end(), samePosition), records.end());
+    // Кандидаты могли вернуться к исходному виду: оставляем только настоящие отличия
+    records.erase(std::remove_if(records.begin(), records.end(), [this](GameSnapshot::TileRecord& record) {
+        record.tile = gameMap.getTile(record.x, record.y) == TileType::Wall
+                          ? static_cast<uint8_t>(1 + walls.getDamage(record.x, record.y))
+                          : 0;
+        return record.tile == static_cast<uint8_t>(gameMap.getInitialTile(record.x, record.y));
+    }), records.end());
+
+    // Танки и пули хранятся отдельно, но каждый список упорядочен по id - сливаем их
+    outSnapshot.objects.clear();
+    outSnapshot.objects.reserve(gameObjects.size() + bullets.size());
+    size_t b = 0;
+    auto appendBulletsBefore = [&](uint64_t id) {
+        for (; b < bullets.size() && bullets.getId(b) < id; ++b) {
+            if (bullets.isDestroyed(b)) continue;
+            GameSnapshot::ObjectRecord record;
+            record.id = bullets.getId(b);
+            record.kind = GameSnapshot::ObjectKind::Bullet;
+            record.x = bullets.getX(b);
+            record.y = bullets.getY(b);
+            record.direction = static_cast<uint8_t>(bullets.getDirection(b));
+            record.player = bullets.isFromPlayer(b);
+            record.speed = bullets.getSpeed(b);
+            record.damage = bullets.getDamage(b);
+            outSnapshot.objects.push_back(record);
+        }
+    };
+    for (const auto& obj : gameObjects) {
+        const Tank* tank = dynamic_cast<const Tank*>(obj.get());
+        if (!tank || tank->isDestroyed()) continue;
+        appendBulletsBefore(tank->getId());
+        GameSnapshot::ObjectRecord record;
+        record.id = tank->getId();
+        record.kind = GameSnapshot::ObjectKind::Tank;
+        record.x = tank->getX();
+        record.y = tank->getY();
+        record.direction = static_cast<uint8_t>(tank->getDirection());
+        // Для танков игроков хранится номер игрока + 1, чтобы различать их в сетевой игре
+        record.player = tank->isPlayer() ? static_cast<uint8_t>(std::max(tank->getPlayerSlot(), 0) + 1) : 0;
+        record.health = tank->getHealth();
+        record.maxHealth = tank->getMaxHealth();
+        record.reloadTime = tank->getReloadTime();
+        record.timeSinceLastShot = tank->getTimeSinceLastShot();
+        record.speed = tank->getSpeed();
+        outSnapshot.objects.push_back(record);
+    }
+    appendBulletsBefore(std::numeric_limits<uint64_t>::max()); // Пули новее последнего танка
+
+    outSnapshot.state = static_cast<uint8_t>(state);
+    outSnapshot.score = score;
+    outSnapshot.gameTime = gameTime;
+    outSnapshot.nextObjectId = nextObjectId;
+    outSnapshot.rngDraws = rng.getDraws();
+    outSnapshot.rngState.clear();
+    if (withRngState) {
+        std::ostringstream rngText;
+        rngText << rng.getEngine();
+        outSnapshot.rngState = rngText.str();
+    }
+}
+
+bool GameModel::restoreSnapshot(const GameSnapshot& snapshot) {
+    if (!applySnapshot(snapshot)) {
         return false;
     }
+    // Загруженное состояние становится началом новой истории перемотки
+    rewindBuffer.clear();
+    recordRewindTick();
+    return true;
+}
 
-    // Используем лучший генератор случайных чисел для перемешивания
-    std::random_device rd;
-    std::mt19937 g(rd());
-    std::shuffle(possibleSpawns.begin(), possibleSpawns.end(), g);
+bool GameModel::rewindTo(uint64_t tick) {
+    if (tick == tickCount) {
+        return true;
+    }
+    return rewindBuffer.rewindTo(tick, rewindScratch) && applySnapshot(rewindScratch);
+}
 
-    for (const auto& tilePos : possibleSpawns) {
-        if (tilePos.first < 0 || tilePos.first >= gameMap.getWidth() ||
-            tilePos.second < 0 || tilePos.second >= gameMap.getHeight()) {
-            continue;
-        }
-        float potentialX = tilePos.first * TILE_SIZE + (TILE_SIZE - TANK_SIZE) / 2.0f;
-        float potentialY = tilePos.second * TILE_SIZE + (TILE_SIZE - TANK_SIZE) / 2.0f;
+void GameModel::setRewindWindow(int ticks, int keyframeInterval) {
+    rewindBuffer.configure(ticks, keyframeInterval);
+    recordRewindTick();
+}
 
-        // Проверка 1: Является ли сам тайл стеной? (Не должно быть для enemyStarts, но хорошая проверка)
-        if (gameMap.getTile(tilePos.first, tilePos.second) == TileType::Wall) {
-            continue;
+void GameModel::recordRewindTick() {
+    if (!rewindBuffer.isEnabled()) {
+        return;
+    }
+    ARCADE_TRACE_ZONE("recordRewindTick");
+    ARCADE_ALLOC_PHASE("rewind");
+    // Состояние генератора (несколько килобайт текста) нужно только ключевым кадрам,
+    // в остальных тиках достаточно счетчика выданных чисел
+    captureSnapshot(rewindScratch, rewindBuffer.needsKeyframe(tickCount));
+    rewindBuffer.record(rewindScratch);
+}
+
+bool GameModel::applySnapshot(const GameSnapshot& snapshot) {
+    // Сначала проверяем снимок целиком, чтобы при ошибке модель осталась нетронутой
+    if (snapshot.mapWidth != gameMap.getWidth() || snapshot.mapHeight != gameMap.getHeight()) {
+        return false;
+    }
+    if (snapshot.state > static_cast<uint8_t>(GameState::MENU)) {
+        return false;
+    }
+    for (const auto& tile : snapshot.tileChanges) {
+        if (tile.x < 0 || tile.x >= snapshot.mapWidth || tile.y < 0 || tile.y >= snapshot.mapHeight ||
+            tile.tile > DestructibleWalls::MAX_HEALTH) {
+            return false;
+        }
+    }
+    uint32_t previousId = 0;
+    for (const auto& record : snapshot.objects) {
+        // id должны возрастать: на этом держатся дельты буфера перемотки
+        if (record.id <= previousId || record.id >= snapshot.nextObjectId) {
+            return false;
+        }
+        previousId = record.id;
+        if (record.direction > static_cast<uint8_t>(Direction::RIGHT) || record.player > MAX_PLAYERS ||
+            (record.kind != GameSnapshot::ObjectKind::Tank && record.kind != GameSnapshot::ObjectKind::Bullet)) {
+            return false;
         }
+    }
+    std::mt19937 restoredRng;
+    std::istringstream rngText(snapshot.rngState);
+    rngText >> restoredRng;
+    if (rngText.fail()) {
+        return false;
+    }
 
-        // Проверка 2: Занято ли местоположение (выровненное по тайлу) каким-либо существующим танком?
-        bool occupied = false;
-        for (const auto& obj : gameObjects) {
-            const Tank* tank = dynamic_cast<const Tank*>(obj.get());
-            if (tank && !tank->isDestroyed()) {
-                // Проверка AABB на перекрытие (предполагая TANK_SIZE для коллизионного бокса)
-                float otherTankLeft = tank->getX();
-                float otherTankRight = tank->getX() + TANK_SIZE;
-                float otherTankTop = tank->getY();
-                float otherTankBottom = tank->getY() + TANK_SIZE;
-
-                // Определяем ограничивающий бокс для потенциального места создания
-                float spawnLeft = potentialX;
-                float spawnRight = potentialX + TANK_SIZE;
-                float spawnTop = potentialY;
-                float spawnBottom = potentialY + TANK_SIZE;
-
-                // Проверяем на перекрытие
-                if (spawnRight > otherTankLeft && spawnLeft < otherTankRight &&
-                    spawnBottom > otherTankTop && spawnTop < otherTankBottom) {
-                    occupied = true;
-                    break;
-                }
+    gameObjects.clear();
+    bullets.clear();
+    tankBroadphase.clear();
+    spawnSlots.resetOccupancy();
+    aiScheduler.reset();
+    pendingEnemySpawns = 0;
+    for (auto& player : players) {
+        player.tank = nullptr;
+        player.input = PlayerInput{};
+    }
+
+    // Наблюдатели карты обновят путь, видимость и точки появления только по измененным тайлам
+    gameMap.resetToInitialState();
+    walls.clear();
+    replicatedTiles.clear();
+    for (const auto& tile : snapshot.tileChanges) {
+        gameMap.setTile(tile.x, tile.y, tile.tile ? TileType::Wall : TileType::Empty);
+        walls.setDamage(tile.x, tile.y, tile.tile > 1 ? tile.tile - 1 : 0);
+    }
+
+    for (const auto& record : snapshot.objects) {
+        Direction dir = static_cast<Direction>(record.direction);
+        if (record.kind == GameSnapshot::ObjectKind::Tank) {
+            auto tank = std::make_unique<Tank>(record.x, record.y, dir, record.player != 0);
+            tank->restoreState(record.health, record.maxHealth, record.speed,
+                               record.reloadTime, record.timeSinceLastShot);
+            Tank* raw = addTank(std::move(tank));
+            raw->setId(record.id);
+            raw->setAiState(snapshot.tick, false);
+            if (raw->isPlayer()) {
+                attachPlayerTank(record.player - 1, raw);
             }
+        } else {
+            bullets.add(record.id, record.x, record.y, dir, record.player != 0, record.speed, record.damage);
+        }
+    }
+
+    rng.restore(restoredRng, snapshot.rngDraws);
+    nextObjectId = snapshot.nextObjectId;
+    tickCount = snapshot.tick;
+    state = static_cast<GameState>(snapshot.state);
+    score = snapshot.score;
+    gameTime = snapshot.gameTime;
+    lastUpdateTime = std::chrono::steady_clock::now(); // Время, проведенное в загрузке, не попадает в deltaTime
+    return true;
+}
+
+void GameModel::attachPlayerTank(int slot, Tank* tank) {
+    if (slot >= static_cast<int>(players.size())) {
+        players.resize(slot + 1);
+    }
+    tank->setPlayerSlot(slot);
+    if (!players[slot].tank) {
+        players[slot].tank = tank;
+    }
+    players[slot].active = true;
+}
+
+bool GameModel::applyReplicatedState(const GameSnapshot& snapshot, int localSlot) {
+    if (snapshot.mapWidth != gameMap.getWidth() || snapshot.mapHeight != gameMap.getHeight() ||
+        snapshot.state > static_cast<uint8_t>(GameState::MENU)) {
+        return false;
+    }
+
+    // Тайлы перестраиваются только когда сервер их действительно поменял
+    bool tilesChanged = snapshot.tileChanges.size() != replicatedTiles.size();
+    for (size_t i = 0; !tilesChanged && i < replicatedTiles.size(); ++i) {
+        const auto& a = snapshot.tileChanges[i];
+        const auto& b = replicatedTiles[i];
+        tilesChanged = a.x != b.x || a.y != b.y || a.tile != b.tile;
+    }
+    if (tilesChanged) {
+        gameMap.resetToInitialState();
+        walls.clear();
+        for (const auto& tile : snapshot.tileChanges) {
+            gameMap.setTile(tile.x, tile.y, tile.tile ? TileType::Wall : TileType::Empty);
+            walls.setDamage(tile.x, tile.y, tile.tile > 1 ? tile.tile - 1 : 0);
+        }
+        replicatedTiles = snapshot.tileChanges;
+    }
+
+    // Объекты с тем же id обновляются на месте, остальные создаются заново.
+    // Оба списка упорядочены по id, поэтому хватает одного прохода
+    replicatedObjects.clear();
+    replicatedObjects.reserve(snapshot.objects.size());
+    for (auto& player : players) {
+        player.tank = nullptr;
+    }
+    bullets.clear(); // Пули дешевле создать заново, чем сопоставлять
+    size_t old = 0;
+    for (const auto& record : snapshot.objects) {
+        if (record.direction > static_cast<uint8_t>(Direction::RIGHT) || record.player > MAX_PLAYERS) {
+            continue;
+        }
+        Direction dir = static_cast<Direction>(record.direction);
+        if (record.kind != GameSnapshot::ObjectKind::Tank) {
+            bullets.add(record.id, record.x, record.y, dir, record.player != 0, record.speed, record.damage);
+            continue;
+        }
+        while (old < gameObjects.size() && gameObjects[old]->getId() < record.id) {
+            ++old;
+        }
+        std::unique_ptr<GameObject> object;
+        if (old < gameObjects.size() && gameObjects[old]->getId() == record.id) {
+            object = std::move(gameObjects[old++]);
+        }
+        Tank* tank = dynamic_cast<Tank*>(object.get());
+        if (!tank) {
+            object = std::make_unique<Tank>(record.x, record.y, dir, record.player != 0);
+            tank = static_cast<Tank*>(object.get());
+        }
+        tank->setPosition(record.x, record.y);
+        tank->setDirection(dir);
+        tank->restoreState(record.health, record.maxHealth, record.speed,
+                           record.reloadTime, record.timeSinceLastShot);
+        if (record.player != 0) {
+            attachPlayerTank(record.player - 1, tank);
         }
+        object->setId(record.id);
+        replicatedObjects.push_back(std::move(object));
+    }
+    gameObjects.swap(replicatedObjects);
+    replicatedObjects.clear();
 
-        if (!occupied) {
-            outX = potentialX;
-            outY = potentialY;
-            return true; // Нашли пустое место
+    // Копия не симулирует, но индексы держим согласованными с объектами
+    tankBroadphase.clear();
+    spawnSlots.resetOccupancy();
+    for (const auto& obj : gameObjects) {
+        if (Tank* tank = dynamic_cast<Tank*>(obj.get())) {
+            tankBroadphase.insert(tank);
+            spawnSlots.tankAdded(tank->getX(), tank->getY());
         }
     }
-    return false; // Не найдено подходящее пустое место для создания из enemyStarts
+
+    localPlayer = localSlot;
+    nextObjectId = snapshot.nextObjectId;
+    tickCount = snapshot.tick;
+    state = static_cast<GameState>(snapshot.state);
+    score = snapshot.score;
+    gameTime = snapshot.gameTime;
+    return true;
 }
 
-void GameModel::spawnNewEnemyRandomly() {
-    float spawnX, spawnY;
-    if (findEmptySpawnLocation(spawnX, spawnY)) {
-        Direction randomDir = static_cast<Direction>(rand() % 4);
-        gameObjects.push_back(std::make_unique<Tank>(spawnX, spawnY, randomDir, false));
+int GameModel::spawnEnemies(int count) {
+    FrameVector<std::pair<float, float>> spawnPositions{FrameAllocator<std::pair<float, float>>(frameArena)};
+    spawnPositions.reserve(count);
+    spawnSlots.pickFreeSlots(count, rng, spawnPositions);
+    for (const auto& pos : spawnPositions) {
+        Direction randomDir = static_cast<Direction>(rng() % 4);
+        addTank(std::make_unique<Tank>(pos.first, pos.second, randomDir, false));
     }
+    return static_cast<int>(spawnPositions.size());
+}
+
+Tank* GameModel::addTank(std::unique_ptr<Tank> tank) {
+    Tank* raw = tank.get();
+    raw->setId(nextObjectId++);
+    raw->setAiState(tickCount, false);
+    tankBroadphase.insert(raw);
+    spawnSlots.tankAdded(raw->getX(), raw->getY());
+    gameObjects.push_back(std::move(tank));
+    return raw;
+}
+
+void GameModel::moveTank(Tank* tank, float x, float y) {
+    float oldX = tank->getX();
+    float oldY = tank->getY();
+    tank->setPosition(x, y);
+    tankBroadphase.tankMoved(tank, oldX);
+    spawnSlots.tankMoved(oldX, oldY, tank->getX(), tank->getY()); // Позиция могла привязаться к сетке
 }
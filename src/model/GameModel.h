@@ -3,10 +3,25 @@
 #include "../common/Direction.h"
 #include "GameObject.h"
 #include "Tank.h"
-#include "Bullet.h"
+#include "BulletArray.h"
+#include "PlayerInput.h"
+#include "HierarchicalPathfinder.h"
+#include "LineOfSight.h"
+#include "TankBroadphase.h"
+#include "TankHitKernel.h"
+#include "SpawnSlotTracker.h"
+#include "SimulationLod.h"
+#include "AiScheduler.h"
+#include "DestructibleWalls.h"
+#include "GeometryKernels.h"
+#include "GameSnapshot.h"
+#include "RewindBuffer.h"
+#include "CountingRandom.h"
+#include "../common/FrameArena.h"
 #include <vector>
 #include <memory>
 #include <chrono>
+#include <random>
 #include <cmath> 
 
 enum class GameState {
@@ -18,12 +33,19 @@ MENU
 
 class GameModel {
 public:
-static constexpr float TILE_SIZE = 40.0f;  // Увеличено с 20.0f до 40.0f
-static constexpr float TANK_SIZE = 36.0f;  // Увеличено с 20.0f до 36.0f
+using Geometry = GameGeometry; // Размеры тайла, танка и пули задаются при компиляции
+static constexpr float TILE_SIZE = Geometry::TILE_SIZE;
+static constexpr float TANK_SIZE = Geometry::TANK_SIZE;
+static constexpr int MAX_PLAYERS = 16;
 
 GameModel();
+GameModel(const GameModel&) = delete;
+GameModel& operator=(const GameModel&) = delete;
 bool init(const std::string& mapFile);
-void update();
+bool init(std::shared_ptr<const MapLayout> layout); // Карта, уже загруженная для других моделей
+void setSeed(uint32_t seed); // Воспроизводимые партии: вызывается перед reset()
+void update();               // Шаг на время, прошедшее с прошлого вызова
+void step(float deltaTime);  // Шаг заданной длины (сервер, тесты)
 void reset();
 
 GameState getState() const { return state; }
@@ -31,30 +53,126 @@ void setState(GameState newState) { state = newState; }
 
 int getScore() const { return score; }
 float getFPS() const { return fps; }
+const FrameArena& getFrameArena() const { return frameArena; } // Выделения временной памяти за тик
+float getGameTime() const { return gameTime; }
 int getPlayerHealth() const;
 
 const GameMap& getMap() const { return gameMap; }
-const std::vector<std::unique_ptr<GameObject>>& getObjects() const { return gameObjects; }
+const std::vector<std::unique_ptr<GameObject>>& getObjects() const { return gameObjects; } // Танки
+const BulletArray& getBullets() const { return bullets; }
+
+// Поиск пути по тайлам (к целям, в обход, назад к точкам появления)
+bool findPath(std::pair<int, int> fromTile, std::pair<int, int> toTile,
+              std::vector<std::pair<int, int>>& outPath);
+const HierarchicalPathfinder& getPathfinder() const { return pathfinder; }
+// Построить граф путей заранее (при подготовке партии), а не в первом тике с запросом пути
+void preparePathfinding() { pathfinder.prepare(); }
 
 void playerMove(Direction dir);
 void playerFire();
-void addBullet(std::unique_ptr<Bullet> bullet);
+void setPlayerInput(const PlayerInput& input) { setPlayerInput(localPlayer, input); } // Применяется в каждом тике
+void setPlayerInput(int slot, const PlayerInput& input);
+
+// Несколько игроков (сетевая игра). Игрок 0 - локальный игрок одиночной игры.
+// Танки активных игроков создаются при reset(); игра окончена, когда погибли все
+int addPlayer();              // Номер нового игрока или -1, если мест нет
+bool spawnPlayer(int slot);   // Новый танк для активного игрока, у которого танка нет
+void removePlayer(int slot);  // Игрок вышел: его танк убирается без начисления очков
+void clearPlayers();
+bool isPlayerAlive(int slot) const;
+int getPlayerCount() const { return static_cast<int>(players.size()); }
+const InputTiming& getInputTiming() const { return inputTiming; }
+void addBullet(float x, float y, Direction dir, bool fromPlayer);
 bool isCellFree(float x, float y) const; // This might be superseded by checkWallCollision or need review
 
 int getPlayerScore() const { return score; } 
 bool isPlayerDead() const; 
 
+// Сохранение: снимок берется на игровом потоке между тиками, кодирование и запись - в SaveGame.
+// restoreSnapshot возвращает false (и не трогает модель), если снимок не подходит к загруженной карте
+void captureSnapshot(GameSnapshot& outSnapshot, bool withRngState = true) const;
+bool restoreSnapshot(const GameSnapshot& snapshot);
+
+// Клиент сетевой игры: модель только отображает состояние сервера и сама не симулирует.
+// Объекты с теми же id обновляются на месте
+bool applyReplicatedState(const GameSnapshot& snapshot, int localSlot);
+
+// Перемотка: модель помнит последние тики (по умолчанию 10 с при 60 тиках в секунду).
+// rewindTo возвращает модель в тик из окна буфера, более поздние тики забываются
+void setRewindWindow(int ticks, int keyframeInterval = 60); // ticks = 0 выключает запись
+bool rewindTo(uint64_t tick);
+const RewindBuffer& getRewindBuffer() const { return rewindBuffer; }
+uint64_t getTick() const { return tickCount; }
+
+// Уровни детализации ИИ врагов по расстоянию до игроков (по умолчанию включены)
+void setSimulationLod(const SimulationLodConfig& config) { simulationLod.configure(config); }
+const SimulationLod& getSimulationLod() const { return simulationLod; }
+// Бюджет времени на ИИ врагов за тик, мкс. 0 (по умолчанию) - без ограничения и без
+// зависимости от скорости машины; бюджет нужен только локальной игре
+void setAiBudget(int microseconds) { aiScheduler.setBudget(microseconds); }
+const AiScheduler& getAiScheduler() const { return aiScheduler; }
+
+// Разрушаемые стены: прочность в единицах урона пуль (по умолчанию 4 попадания), 0 - неразрушимы
+void setWallHealth(int health) { walls.setWallHealth(health); }
+const DestructibleWalls& getWalls() const { return walls; }
+
+// Пакетное появление врагов в случайных свободных точках; возвращает число созданных
+int spawnEnemies(int count);
+
 private:
+static constexpr uint32_t PATH_MOVE_CHANCE = 25; // Процент ходов врага по пути к игроку
+
+void applyPlayerInput();
 void processCollisions();
+void damageWalls();
 
 void updateEnemies(float deltaTime);
+void thinkEnemy(Tank* tank, SimulationLod::Tier tier);
+// Направление первого шага по пути к ближайшему игроку; inOutStep может укоротиться
+bool findPathDirection(const Tank* tank, Direction& outDir, float& inOutStep);
 bool checkWallCollision(float x, float y, float width, float height) const;
-void spawnNewEnemyRandomly(); // New function
-bool findEmptySpawnLocation(float& outX, float& outY); // Helper for spawning
+TileGrid wallGrid() const;
+bool findLineOfFire(const Tank* shooter, Direction& outDir) const; // Есть ли у танка выстрел по игроку
+bool findLineOfFire(const Tank* shooter, const Tank* target, Direction& outDir) const;
+void movePlayerTank(Tank* tank, Direction dir);
+void firePlayerTank(Tank* tank);
+bool spawnPlayerTank(int slot);
+void attachPlayerTank(int slot, Tank* tank);
+Tank* localTank() const;
+Tank* addTank(std::unique_ptr<Tank> tank);
+void moveTank(Tank* tank, float x, float y); // Все перемещения танков идут через него
+bool applySnapshot(const GameSnapshot& snapshot);
+void recordRewindTick();
 
 GameMap gameMap;
+HierarchicalPathfinder pathfinder;
+LineOfSight lineOfSight;
+TankBroadphase tankBroadphase;
+TankHitKernel tankHits; // Узкая фаза пуля-танк
+SpawnSlotTracker spawnSlots;
+SimulationLod simulationLod;
+AiScheduler aiScheduler;
+HierarchicalPathfinder::Path aiPath; // Путь врага для findPathDirection, переиспользуется
+DestructibleWalls walls;
+int pendingEnemySpawns = 0; // Замены убитым врагам, создаются после прохода коллизий
+CountingRandom<std::mt19937> rng;
+RewindBuffer rewindBuffer;
+GameSnapshot rewindScratch; // Снимок тика для буфера перемотки, переиспользуется
+uint64_t tickCount = 0;
+uint32_t nextObjectId = 1;
+FrameArena frameArena; // Временные списки тика; сбрасывается в начале step()
 std::vector<std::unique_ptr<GameObject>> gameObjects;
-Tank* playerTank;
+BulletArray bullets; // Пули хранятся отдельно от объектов - для векторных ядер
+struct PlayerSlot {
+    bool active = false;
+    Tank* tank = nullptr; // nullptr, пока игрок погиб или еще не появился
+    PlayerInput input;
+};
+std::vector<PlayerSlot> players;
+int localPlayer = 0;
+std::vector<GameSnapshot::TileRecord> replicatedTiles;       // Для applyReplicatedState
+std::vector<std::unique_ptr<GameObject>> replicatedObjects; // Буфер, переиспользуется
+InputTiming inputTiming;
 GameState state = GameState::PLAYING; // Default to PLAYING, actual initial state set by controller
 int score = 0;
 float fps = 0;
@@ -1,3 +1,3 @@
 #include "GameObject.h"
 
-GameObject::GameObject(float x, float y) : x(x), y(y) {}
+GameObject::GameObject(float x, float y) : x(FixedPoint::quantize(x)), y(FixedPoint::quantize(y)) {}
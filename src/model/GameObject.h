@@ -1,6 +1,8 @@
 #pragma once
 #include "../common/Direction.h"
+#include "FixedPoint.h"
 #include <memory>
+#include <cstdint>
 
 class GameObject {
 public:
@@ -12,8 +14,17 @@ public:
     
     float getX() const { return x; }
     float getY() const { return y; }
-    void setPosition(float newX, float newY) { x = newX; y = newY; }
+    // В режиме фиксированной точки позиция привязывается к сетке (FixedPoint)
+    void setPosition(float newX, float newY) {
+        x = FixedPoint::quantize(newX);
+        y = FixedPoint::quantize(newY);
+    }
+
+    // Назначается GameModel при добавлении; в списке объектов id возрастают
+    uint32_t getId() const { return id; }
+    void setId(uint32_t newId) { id = newId; }
 
 protected:
     float x, y;
+    uint32_t id = 0;
 };
@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Полное состояние симуляции между тиками - то, что сохраняется и восстанавливается.
+// Карта хранится только отличиями от исходной загруженной карты
+struct GameSnapshot {
+    enum class ObjectKind : uint8_t {
+        Tank,
+        Bullet
+    };
+
+    // Код тайла: 0 - пусто, 1 - стена, 1 + d - стена с уроном d (DestructibleWalls).
+    // Поврежденная стена исходной карты тоже хранится как отличие
+    struct TileRecord {
+        int32_t x = 0, y = 0;
+        uint8_t tile = 0;
+    };
+
+    // Объекты идут в порядке GameModel::gameObjects: от него зависит порядок обработки коллизий.
+    // Новые объекты добавляются в конец с растущими id, поэтому id в списке возрастают
+    struct ObjectRecord {
+        uint32_t id = 0;
+        ObjectKind kind = ObjectKind::Tank;
+        float x = 0, y = 0;
+        uint8_t direction = 0;
+        uint8_t player = 0;          // Танк игрока или пуля игрока
+        int32_t health = 0;          // Только для танков
+        int32_t maxHealth = 0;
+        float reloadTime = 0;
+        float timeSinceLastShot = 0;
+        float speed = 0;
+        int32_t damage = 0;          // Только для пуль
+    };
+
+    uint64_t tick = 0;
+    int32_t mapWidth = 0;
+    int32_t mapHeight = 0;
+    std::vector<TileRecord> tileChanges;
+    std::vector<ObjectRecord> objects;
+    uint32_t nextObjectId = 1;
+
+    uint8_t state = 0;
+    int32_t score = 0;
+    float gameTime = 0;
+    std::string rngState; // Текстовое состояние std::mt19937 (формат operator<<)
+    uint64_t rngDraws = 0; // Сколько чисел выдал генератор; rngState может быть пустым, см. RewindBuffer
+};
@@ -0,0 +1,6 @@
+#include "GeometryKernels.h"
+
+// Геометрия игры и ее вариант с тайлами - степенью двойки: второй собирается всегда,
+// чтобы ветка со сдвигами не отставала от основной
+template struct GeometryKernels<GameGeometry>;
+template struct GeometryKernels<TileGeometry<32, 28, 3>>;
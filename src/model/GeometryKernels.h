@@ -0,0 +1,72 @@
+#pragma once
+#include "TileGeometry.h"
+#include "TileType.h"
+
+// Тайлы карты по строкам, как GameMap::getTileData()
+struct TileGrid {
+    const TileType* tiles;
+    int width;
+    int height;
+};
+
+// Проверки стен для геометрии, заданной при компиляции. Специализации, которыми пользуется
+// игра, собираются один раз в GeometryKernels.cpp; остальные инстанцируются по месту
+template <class Geometry>
+struct GeometryKernels {
+    using Grid = TileGrid;
+
+    // Прямоугольник задевает стену или выходит за край карты
+    static bool boxHitsWall(const Grid& grid, float x, float y, float width, float height);
+    // Танк с левым верхним углом (x, y)
+    static bool tankHitsWall(const Grid& grid, float x, float y) {
+        return boxHitsWall(grid, x, y, Geometry::TANK_SIZE, Geometry::TANK_SIZE);
+    }
+    // Точка на проходимом тайле внутри карты
+    static bool isPointFree(const Grid& grid, float x, float y);
+};
+
+template <class Geometry>
+bool GeometryKernels<Geometry>::boxHitsWall(const Grid& grid, float x, float y, float width, float height) {
+    if (x < 0 || y < 0 || (x + width) > grid.width * Geometry::TILE_SIZE ||
+        (y + height) > grid.height * Geometry::TILE_SIZE) {
+        return true;
+    }
+
+    // Диапазон покрываемых тайлов
+    const int startTileX = Geometry::tileOf(x);
+    const int startTileY = Geometry::tileOf(y);
+    const int endTileX = Geometry::lastTileBefore(x + width);
+    const int endTileY = Geometry::lastTileBefore(y + height);
+
+    for (int ty = startTileY; ty <= endTileY; ++ty) {
+        // Ошибки округления у края карты: такие тайлы пропускаем, край уже проверен выше
+        if (ty < 0 || ty >= grid.height) {
+            continue;
+        }
+        const TileType* row = grid.tiles + ty * grid.width;
+        for (int tx = startTileX; tx <= endTileX; ++tx) {
+            if (tx >= 0 && tx < grid.width && row[tx] == TileType::Wall) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template <class Geometry>
+bool GeometryKernels<Geometry>::isPointFree(const Grid& grid, float x, float y) {
+    if constexpr (FixedPoint::ENABLED) {
+        if (x < 0 || y < 0) {
+            return false; // tileOf округляет вниз, а не к нулю
+        }
+    }
+    const int tileX = Geometry::tileOf(x);
+    const int tileY = Geometry::tileOf(y);
+    if (tileX < 0 || tileX >= grid.width || tileY < 0 || tileY >= grid.height) {
+        return false; // За пределами карты не свободно
+    }
+    return grid.tiles[tileY * grid.width + tileX] != TileType::Wall;
+}
+
+extern template struct GeometryKernels<GameGeometry>;
+extern template struct GeometryKernels<TileGeometry<32, 28, 3>>;
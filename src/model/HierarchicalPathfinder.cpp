@@ -0,0 +1,552 @@
+#include "HierarchicalPathfinder.h"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+
+namespace {
+
+struct SharedGraphEntry {
+    const MapLayout* layout;
+    std::weak_ptr<const MapLayout> owner; // Пустой у встроенных карт: они живут всю программу
+    bool permanent;
+    int clusterSize;
+    std::shared_ptr<const HierarchicalPathfinder> graph;
+};
+
+std::mutex sharedGraphsMutex;
+std::vector<SharedGraphEntry> sharedGraphs;
+
+} // namespace
+
+HierarchicalPathfinder::HierarchicalPathfinder(int clusterSize, size_t cacheCapacity)
+    : clusterSize(std::max(clusterSize, 2)), cacheCapacity(cacheCapacity) {}
+
+void HierarchicalPathfinder::build(const GameMap& gameMap) {
+    map = &gameMap;
+    mapWidth = gameMap.getWidth();
+    mapHeight = gameMap.getHeight();
+    clustersX = (mapWidth + clusterSize - 1) / clusterSize;
+    clustersY = (mapHeight + clusterSize - 1) / clusterSize;
+
+    const int clusterCount = clustersX * clustersY;
+    built = false;
+    nodes.clear();
+    freeNodes.clear();
+    clusterNodes.clear();
+    borderNodes.clear();
+    clearCache();
+
+    const size_t clusterArea = static_cast<size_t>(clusterSize) * clusterSize;
+    bfsDist.resize(clusterArea);
+    bfsParent.resize(clusterArea);
+    startDist.resize(clusterArea);
+    goalDist.resize(clusterArea);
+
+    clusterDirty.assign(clusterCount, 0);
+    dirtyClusters.clear();
+    // Общий граф построен по исходной карте - отличия этой карты перестроятся поверх него
+    for (const auto& [x, y] : gameMap.getModifiedTiles()) {
+        invalidateTile(x, y);
+    }
+}
+
+void HierarchicalPathfinder::prepare() {
+    if (!map) {
+        return;
+    }
+    if (!built) {
+        std::shared_ptr<const HierarchicalPathfinder> shared;
+        if (map->getLayout()) {
+            shared = sharedGraph(map->getLayout(), clusterSize);
+        }
+        if (shared) {
+            nodes = shared->nodes;
+            freeNodes = shared->freeNodes;
+            clusterNodes = shared->clusterNodes;
+            borderNodes = shared->borderNodes;
+        } else {
+            buildAll();
+        }
+        built = true;
+    }
+    flushDirty();
+}
+
+std::shared_ptr<const HierarchicalPathfinder> HierarchicalPathfinder::sharedGraph(
+    const std::shared_ptr<const MapLayout>& layout, int clusterSize) {
+    std::lock_guard<std::mutex> lock(sharedGraphsMutex);
+    // Графы выгруженных карт больше не нужны, а их адрес может занять новая карта
+    sharedGraphs.erase(std::remove_if(sharedGraphs.begin(), sharedGraphs.end(),
+                                      [](const SharedGraphEntry& e) { return !e.permanent && e.owner.expired(); }),
+                       sharedGraphs.end());
+    for (const auto& entry : sharedGraphs) {
+        if (entry.layout == layout.get() && entry.clusterSize == clusterSize) {
+            return entry.graph;
+        }
+    }
+
+    // Строим под блокировкой: остальные модели на этой карте все равно ждали бы этот граф
+    auto graph = std::make_shared<HierarchicalPathfinder>(clusterSize, 0);
+    {
+        GameMap pristine;
+        if (!pristine.load(layout)) {
+            return nullptr;
+        }
+        graph->build(pristine);
+        graph->buildAll();
+        graph->map = nullptr; // Копия карты удаляется, а граф от нее не зависит
+    }
+    const bool permanent = layout.use_count() == 0;
+    sharedGraphs.push_back({layout.get(), layout, permanent, clusterSize, graph});
+    return graph;
+}
+
+void HierarchicalPathfinder::buildAll() {
+    const int clusterCount = clustersX * clustersY;
+    nodes.clear();
+    freeNodes.clear();
+    clusterNodes.assign(clusterCount, {});
+    borderNodes.assign(clusterCount * 2, {});
+
+    // Полное построение - это перестройка, в которой "грязные" все кластеры
+    clusterDirty.assign(clusterCount, 1);
+    dirtyClusters.resize(clusterCount);
+    for (int c = 0; c < clusterCount; ++c) {
+        dirtyClusters[c] = c;
+    }
+    flushDirty();
+}
+
+void HierarchicalPathfinder::invalidateTile(int x, int y) {
+    if (!map || x < 0 || y < 0 || x >= mapWidth || y >= mapHeight) {
+        return;
+    }
+    int cluster = clusterOf(x, y);
+    if (!clusterDirty[cluster]) {
+        clusterDirty[cluster] = 1;
+        dirtyClusters.push_back(cluster);
+    }
+}
+
+void HierarchicalPathfinder::clearCache() {
+    cacheEntries.clear();
+    cacheIndex.clear();
+    unreachable.clear();
+}
+
+bool HierarchicalPathfinder::isPassable(int x, int y) const {
+    return map->getTile(x, y) != TileType::Wall;
+}
+
+int HierarchicalPathfinder::clusterOf(int x, int y) const {
+    return (y / clusterSize) * clustersX + (x / clusterSize);
+}
+
+void HierarchicalPathfinder::clusterBounds(int cluster, int& x0, int& y0, int& x1, int& y1) const {
+    x0 = (cluster % clustersX) * clusterSize;
+    y0 = (cluster / clustersX) * clusterSize;
+    x1 = std::min(x0 + clusterSize, mapWidth) - 1;
+    y1 = std::min(y0 + clusterSize, mapHeight) - 1;
+}
+
+void HierarchicalPathfinder::flushDirty() {
+    if (dirtyClusters.empty()) {
+        return;
+    }
+    unreachable.clear();
+
+    // Сбрасываем из кэша пути, проходящие через измененные кластеры
+    for (auto it = cacheEntries.begin(); it != cacheEntries.end(); ) {
+        bool touched = std::any_of(it->clusters.begin(), it->clusters.end(),
+                                   [&](int c) { return clusterDirty[c] != 0; });
+        if (touched) {
+            cacheIndex.erase(it->key);
+            it = cacheEntries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Входы лежат на границах, поэтому перестраиваем все четыре границы
+    // измененного кластера, а расстояния - в нем и в соседях
+    std::vector<uint8_t> borderMark(borderNodes.size(), 0);
+    std::vector<uint8_t> clusterMark(clusterNodes.size(), 0);
+    for (int c : dirtyClusters) {
+        int cx = c % clustersX;
+        int cy = c / clustersX;
+        borderMark[c * 2] = 1;
+        borderMark[c * 2 + 1] = 1;
+        clusterMark[c] = 1;
+        if (cx > 0) { borderMark[(c - 1) * 2] = 1; clusterMark[c - 1] = 1; }
+        if (cy > 0) { borderMark[(c - clustersX) * 2 + 1] = 1; clusterMark[c - clustersX] = 1; }
+        if (cx + 1 < clustersX) clusterMark[c + 1] = 1;
+        if (cy + 1 < clustersY) clusterMark[c + clustersX] = 1;
+    }
+
+    for (size_t b = 0; b < borderMark.size(); ++b) {
+        if (borderMark[b]) rebuildBorder(static_cast<int>(b));
+    }
+    for (size_t c = 0; c < clusterMark.size(); ++c) {
+        if (clusterMark[c]) rebuildIntraEdges(static_cast<int>(c));
+    }
+
+    for (int c : dirtyClusters) {
+        clusterDirty[c] = 0;
+    }
+    dirtyClusters.clear();
+}
+
+int HierarchicalPathfinder::allocateNode(int x, int y, int cluster, int border) {
+    int id;
+    if (!freeNodes.empty()) {
+        id = freeNodes.back();
+        freeNodes.pop_back();
+    } else {
+        id = static_cast<int>(nodes.size());
+        nodes.emplace_back();
+    }
+    Node& node = nodes[id];
+    node.x = x;
+    node.y = y;
+    node.cluster = cluster;
+    node.border = border;
+    node.alive = true;
+    node.edges.clear();
+    clusterNodes[cluster].push_back(id);
+    return id;
+}
+
+void HierarchicalPathfinder::releaseNode(int id) {
+    Node& node = nodes[id];
+    auto& list = clusterNodes[node.cluster];
+    auto it = std::find(list.begin(), list.end(), id);
+    if (it != list.end()) {
+        *it = list.back();
+        list.pop_back();
+    }
+    node.alive = false;
+    node.edges.clear();
+    freeNodes.push_back(id);
+}
+
+void HierarchicalPathfinder::rebuildBorder(int border) {
+    for (int id : borderNodes[border]) {
+        releaseNode(id);
+    }
+    borderNodes[border].clear();
+
+    const int cluster = border / 2;
+    const bool east = (border % 2) == 0;
+    const int cx = cluster % clustersX;
+    const int cy = cluster / clustersX;
+    if ((east && cx + 1 >= clustersX) || (!east && cy + 1 >= clustersY)) {
+        return; // Край карты - соседа нет
+    }
+    const int neighbour = east ? cluster + 1 : cluster + clustersX;
+
+    int x0, y0, x1, y1;
+    clusterBounds(cluster, x0, y0, x1, y1);
+    const int first = east ? y0 : x0;
+    const int last = east ? y1 : x1;
+
+    // Тайл по эту сторону границы и по ту для позиции i вдоль границы
+    auto sideA = [&](int i) { return east ? TilePos{x1, i} : TilePos{i, y1}; };
+    auto sideB = [&](int i) { return east ? TilePos{x1 + 1, i} : TilePos{i, y1 + 1}; };
+
+    auto addEntrance = [&](int i) {
+        TilePos a = sideA(i);
+        TilePos b = sideB(i);
+        int idA = allocateNode(a.first, a.second, cluster, border);
+        int idB = allocateNode(b.first, b.second, neighbour, border);
+        nodes[idA].edges.push_back({idB, 1, true});
+        nodes[idB].edges.push_back({idA, 1, true});
+        borderNodes[border].push_back(idA);
+        borderNodes[border].push_back(idB);
+    };
+
+    // Непрерывный проход вдоль границы дает один вход посередине,
+    // длинный проход - два входа по краям
+    constexpr int LONG_ENTRANCE = 6;
+    int runStart = -1;
+    for (int i = first; i <= last + 1; ++i) {
+        bool open = false;
+        if (i <= last) {
+            TilePos a = sideA(i);
+            TilePos b = sideB(i);
+            open = isPassable(a.first, a.second) && isPassable(b.first, b.second);
+        }
+        if (open && runStart < 0) {
+            runStart = i;
+        } else if (!open && runStart >= 0) {
+            int runEnd = i - 1;
+            if (runEnd - runStart + 1 < LONG_ENTRANCE) {
+                addEntrance((runStart + runEnd) / 2);
+            } else {
+                addEntrance(runStart);
+                addEntrance(runEnd);
+            }
+            runStart = -1;
+        }
+    }
+}
+
+void HierarchicalPathfinder::rebuildIntraEdges(int cluster) {
+    const auto& ids = clusterNodes[cluster];
+    for (int id : ids) {
+        auto& edges = nodes[id].edges;
+        edges.erase(std::remove_if(edges.begin(), edges.end(),
+                                   [](const Edge& e) { return !e.inter; }),
+                    edges.end());
+    }
+
+    int x0, y0, x1, y1;
+    clusterBounds(cluster, x0, y0, x1, y1);
+    for (int id : ids) {
+        clusterBfs(cluster, {nodes[id].x, nodes[id].y}, bfsDist, nullptr);
+        for (int other : ids) {
+            if (other == id) continue;
+            int d = bfsDist[(nodes[other].y - y0) * clusterSize + (nodes[other].x - x0)];
+            if (d >= 0) {
+                nodes[id].edges.push_back({other, d, false});
+            }
+        }
+    }
+}
+
+void HierarchicalPathfinder::clusterBfs(int cluster, TilePos from, std::vector<int>& dist,
+                                        std::vector<int>* parents) {
+    int x0, y0, x1, y1;
+    clusterBounds(cluster, x0, y0, x1, y1);
+    std::fill(dist.begin(), dist.end(), -1);
+
+    bfsQueue.clear();
+    int startLocal = (from.second - y0) * clusterSize + (from.first - x0);
+    dist[startLocal] = 0;
+    if (parents) (*parents)[startLocal] = -1;
+    bfsQueue.push_back(startLocal);
+
+    static constexpr int DX[4] = {1, -1, 0, 0};
+    static constexpr int DY[4] = {0, 0, 1, -1};
+    for (size_t head = 0; head < bfsQueue.size(); ++head) {
+        int local = bfsQueue[head];
+        int lx = local % clusterSize;
+        int ly = local / clusterSize;
+        for (int k = 0; k < 4; ++k) {
+            int nx = lx + DX[k];
+            int ny = ly + DY[k];
+            if (nx < 0 || ny < 0 || x0 + nx > x1 || y0 + ny > y1) continue;
+            int next = ny * clusterSize + nx;
+            if (dist[next] >= 0 || !isPassable(x0 + nx, y0 + ny)) continue;
+            dist[next] = dist[local] + 1;
+            if (parents) (*parents)[next] = local;
+            bfsQueue.push_back(next);
+        }
+    }
+}
+
+bool HierarchicalPathfinder::localPath(int cluster, TilePos from, TilePos to, Path& out) {
+    int x0, y0, x1, y1;
+    clusterBounds(cluster, x0, y0, x1, y1);
+    clusterBfs(cluster, from, bfsDist, &bfsParent);
+
+    int local = (to.second - y0) * clusterSize + (to.first - x0);
+    if (bfsDist[local] < 0) {
+        return false;
+    }
+    // Восстанавливаем путь с конца и дописываем в прямом порядке, без начального тайла
+    size_t insertAt = out.size();
+    for (int cur = local; bfsParent[cur] >= 0; cur = bfsParent[cur]) {
+        out.push_back({x0 + cur % clusterSize, y0 + cur / clusterSize});
+    }
+    std::reverse(out.begin() + insertAt, out.end());
+    return true;
+}
+
+bool HierarchicalPathfinder::abstractSearch(TilePos start, TilePos goal, Path& outPath) {
+    const int startCluster = clusterOf(start.first, start.second);
+    const int goalCluster = clusterOf(goal.first, goal.second);
+    clusterBfs(startCluster, start, startDist, nullptr);
+    clusterBfs(goalCluster, goal, goalDist, nullptr);
+
+    // Временные вершины старта и цели добавляются за концом массива узлов
+    const int nodeCount = static_cast<int>(nodes.size());
+    const int START = nodeCount;
+    const int GOAL = nodeCount + 1;
+    if (searchCost.size() < nodes.size() + 2) {
+        searchCost.resize(nodes.size() + 2);
+        searchParent.resize(nodes.size() + 2);
+        searchStamp.resize(nodes.size() + 2, 0);
+    }
+    if (++currentStamp == 0) {
+        std::fill(searchStamp.begin(), searchStamp.end(), 0);
+        currentStamp = 1;
+    }
+
+    int sx0, sy0, sx1, sy1, gx0, gy0, gx1, gy1;
+    clusterBounds(startCluster, sx0, sy0, sx1, sy1);
+    clusterBounds(goalCluster, gx0, gy0, gx1, gy1);
+
+    auto heuristic = [&](int id) {
+        if (id == GOAL) return 0;
+        if (id == START) return std::abs(start.first - goal.first) + std::abs(start.second - goal.second);
+        return std::abs(nodes[id].x - goal.first) + std::abs(nodes[id].y - goal.second);
+    };
+
+    openHeap.clear();
+    auto relax = [&](int id, int cost, int parent) {
+        if (searchStamp[id] == currentStamp && searchCost[id] <= cost) return;
+        searchStamp[id] = currentStamp;
+        searchCost[id] = cost;
+        searchParent[id] = parent;
+        openHeap.push_back({cost + heuristic(id), id});
+        std::push_heap(openHeap.begin(), openHeap.end(), std::greater<>());
+    };
+
+    relax(START, 0, -1);
+    bool found = false;
+    while (!openHeap.empty()) {
+        std::pop_heap(openHeap.begin(), openHeap.end(), std::greater<>());
+        auto [f, id] = openHeap.back();
+        openHeap.pop_back();
+        int g = searchCost[id];
+        if (f != g + heuristic(id)) continue; // Устаревшая запись в куче
+        if (id == GOAL) {
+            found = true;
+            break;
+        }
+
+        if (id == START) {
+            for (int n : clusterNodes[startCluster]) {
+                int d = startDist[(nodes[n].y - sy0) * clusterSize + (nodes[n].x - sx0)];
+                if (d >= 0) relax(n, d, START);
+            }
+            if (startCluster == goalCluster) {
+                int d = startDist[(goal.second - sy0) * clusterSize + (goal.first - sx0)];
+                if (d >= 0) relax(GOAL, d, START);
+            }
+            continue;
+        }
+
+        const Node& node = nodes[id];
+        for (const Edge& e : node.edges) {
+            relax(e.to, g + e.cost, id);
+        }
+        if (node.cluster == goalCluster) {
+            int d = goalDist[(node.y - gy0) * clusterSize + (node.x - gx0)];
+            if (d >= 0) relax(GOAL, g + d, id);
+        }
+    }
+    if (!found) {
+        return false;
+    }
+
+    abstractPath.clear();
+    for (int id = GOAL; id != -1; id = searchParent[id]) {
+        abstractPath.push_back(id);
+    }
+    std::reverse(abstractPath.begin(), abstractPath.end());
+
+    // Уточняем абстрактный путь до потайлового
+    outPath.clear();
+    outPath.push_back(start);
+    TilePos current = start;
+    for (size_t k = 1; k < abstractPath.size(); ++k) {
+        int prev = abstractPath[k - 1];
+        int id = abstractPath[k];
+        TilePos target = (id == GOAL) ? goal : TilePos{nodes[id].x, nodes[id].y};
+        if (target == current) continue;
+
+        int cluster;
+        if (prev == START) {
+            cluster = startCluster;
+        } else if (id == GOAL) {
+            cluster = goalCluster;
+        } else if (nodes[prev].cluster != nodes[id].cluster) {
+            outPath.push_back(target); // Межкластерный переход - соседний тайл
+            current = target;
+            continue;
+        } else {
+            cluster = nodes[id].cluster;
+        }
+        if (!localPath(cluster, current, target, outPath)) {
+            return false;
+        }
+        current = target;
+    }
+    return true;
+}
+
+bool HierarchicalPathfinder::findPath(TilePos start, TilePos goal, Path& outPath) {
+    if (!map) {
+        return false;
+    }
+    prepare();
+
+    auto inside = [&](TilePos p) {
+        return p.first >= 0 && p.second >= 0 && p.first < mapWidth && p.second < mapHeight;
+    };
+    if (!inside(start) || !inside(goal) ||
+        !isPassable(start.first, start.second) || !isPassable(goal.first, goal.second)) {
+        return false;
+    }
+
+    uint64_t key = (static_cast<uint64_t>(start.second * mapWidth + start.first) << 32) |
+                   static_cast<uint32_t>(goal.second * mapWidth + goal.first);
+    auto cached = cacheIndex.find(key);
+    if (cached != cacheIndex.end()) {
+        cacheEntries.splice(cacheEntries.begin(), cacheEntries, cached->second);
+        outPath = cached->second->path;
+        ++cacheHits;
+        return true;
+    }
+    if (unreachable.count(key)) {
+        ++cacheHits;
+        return false;
+    }
+    ++cacheMisses;
+
+    bool found = false;
+    int startCluster = clusterOf(start.first, start.second);
+    if (startCluster == clusterOf(goal.first, goal.second)) {
+        // В пределах одного кластера сначала пробуем обойтись локальным поиском
+        outPath.clear();
+        outPath.push_back(start);
+        found = localPath(startCluster, start, goal, outPath);
+    }
+    if (!found) {
+        found = abstractSearch(start, goal, outPath);
+    }
+    if (found) {
+        storeInCache(key, outPath);
+    } else if (cacheCapacity > 0) {
+        // Неудачный поиск обходит весь граф - повторять его до изменения карты незачем
+        if (unreachable.size() >= cacheCapacity) {
+            unreachable.clear();
+        }
+        unreachable.insert(key);
+    }
+    return found;
+}
+
+void HierarchicalPathfinder::storeInCache(uint64_t key, const Path& path) {
+    if (cacheCapacity == 0) {
+        return;
+    }
+    CacheEntry entry{key, path, {}};
+    for (const auto& tile : path) {
+        int c = clusterOf(tile.first, tile.second);
+        if (entry.clusters.empty() || entry.clusters.back() != c) {
+            entry.clusters.push_back(c);
+        }
+    }
+    std::sort(entry.clusters.begin(), entry.clusters.end());
+    entry.clusters.erase(std::unique(entry.clusters.begin(), entry.clusters.end()), entry.clusters.end());
+
+    cacheEntries.push_front(std::move(entry));
+    cacheIndex[key] = cacheEntries.begin();
+    if (cacheEntries.size() > cacheCapacity) {
+        cacheIndex.erase(cacheEntries.back().key);
+        cacheEntries.pop_back();
+    }
+}
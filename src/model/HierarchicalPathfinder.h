@@ -0,0 +1,121 @@
+#pragma once
+#include "GameMap.h"
+#include <memory>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+// Иерархический поиск пути (HPA*) по тайловой карте.
+// Карта делится на квадратные кластеры, на общих границах соседних кластеров
+// выделяются входы (порталы). Расстояния между порталами одного кластера
+// считаются заранее, поэтому запрос идет по небольшому абстрактному графу
+// и лишь затем уточняется локальным поиском внутри кластеров.
+// Изменение тайла перестраивает только его кластер и границы с соседями.
+// Граф строится при первом запросе: граф исходной карты считается один раз на
+// MapLayout и копируется во все модели на ней, а тайлы, измененные с загрузки,
+// перестраиваются поверх копии как обычные изменения.
+class HierarchicalPathfinder {
+public:
+    using TilePos = std::pair<int, int>;
+    using Path = std::vector<TilePos>;
+
+    explicit HierarchicalPathfinder(int clusterSize = 16, size_t cacheCapacity = 256);
+
+    void build(const GameMap& map);   // Привязка к карте (при загрузке); сам граф - в prepare
+    void prepare();                   // Достроить граф сейчас, а не при первом запросе
+    void invalidateTile(int x, int y); // Тайл изменился: кластер перестроится перед следующим запросом
+
+    // Путь по тайлам от start до goal включительно. false, если пути нет
+    bool findPath(TilePos start, TilePos goal, Path& outPath);
+
+    int getClusterCount() const { return clustersX * clustersY; }
+    int getPortalCount() const { return static_cast<int>(nodes.size() - freeNodes.size()); }
+    size_t getCacheHits() const { return cacheHits; }
+    size_t getCacheMisses() const { return cacheMisses; }
+    void clearCache();
+
+private:
+    struct Edge {
+        int to;
+        int cost;
+        bool inter; // Переход между кластерами (соседние тайлы через границу)
+    };
+
+    struct Node {
+        int x = 0, y = 0;
+        int cluster = -1;
+        int border = -1;
+        bool alive = false;
+        std::vector<Edge> edges;
+    };
+
+    struct CacheEntry {
+        uint64_t key;
+        Path path;
+        std::vector<int> clusters; // Кластеры, через которые проходит путь
+    };
+
+    // Граф исходной карты layout, общий для всех моделей на ней
+    static std::shared_ptr<const HierarchicalPathfinder> sharedGraph(const std::shared_ptr<const MapLayout>& layout,
+                                                                     int clusterSize);
+    void buildAll();
+
+    bool isPassable(int x, int y) const;
+    int clusterOf(int x, int y) const;
+    void clusterBounds(int cluster, int& x0, int& y0, int& x1, int& y1) const;
+
+    void flushDirty();
+    void rebuildBorder(int border);
+    void rebuildIntraEdges(int cluster);
+    int allocateNode(int x, int y, int cluster, int border);
+    void releaseNode(int id);
+
+    // Поиск в ширину внутри границ кластера; dist заполняется для тайлов кластера
+    void clusterBfs(int cluster, TilePos from, std::vector<int>& dist, std::vector<int>* parents);
+    bool localPath(int cluster, TilePos from, TilePos to, Path& out);
+    bool abstractSearch(TilePos start, TilePos goal, Path& outPath);
+
+    void storeInCache(uint64_t key, const Path& path);
+
+    const GameMap* map = nullptr;
+    int mapWidth = 0;
+    int mapHeight = 0;
+    int clusterSize;
+    int clustersX = 0;
+    int clustersY = 0;
+    bool built = false;
+
+    std::vector<Node> nodes;
+    std::vector<int> freeNodes;
+    std::vector<std::vector<int>> clusterNodes;
+    std::vector<std::vector<int>> borderNodes; // Граница: cluster * 2 + (0 - восточная, 1 - южная)
+
+    std::vector<uint8_t> clusterDirty;
+    std::vector<int> dirtyClusters;
+
+    // Рабочие буферы, переиспользуемые между запросами
+    std::vector<int> bfsDist;
+    std::vector<int> bfsParent;
+    std::vector<int> bfsQueue;
+    std::vector<int> startDist;
+    std::vector<int> goalDist;
+    std::vector<int> searchCost;
+    std::vector<int> searchParent;
+    std::vector<uint32_t> searchStamp;
+    std::vector<std::pair<int, int>> openHeap; // (f, узел) для A* по абстрактному графу
+    std::vector<int> abstractPath;
+    uint32_t currentStamp = 0;
+
+    size_t cacheCapacity;
+    std::list<CacheEntry> cacheEntries; // Начало списка - последние использованные
+    std::unordered_map<uint64_t, std::list<CacheEntry>::iterator> cacheIndex;
+    // Пары без пути. Новый путь может открыть тайл в любом месте карты,
+    // поэтому они забываются при любом изменении, а не по кластерам
+    std::unordered_set<uint64_t> unreachable;
+    size_t cacheHits = 0;
+    size_t cacheMisses = 0;
+};
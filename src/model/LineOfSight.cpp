@@ -0,0 +1,75 @@
+#include "LineOfSight.h"
+#include <algorithm>
+
+void LineOfSight::build(const GameMap& map) {
+    width = map.getWidth();
+    height = map.getHeight();
+    rowWords = (width + 63) / 64;
+    columnWords = (height + 63) / 64;
+    rowBits.assign(static_cast<size_t>(height) * rowWords, 0);
+    columnBits.assign(static_cast<size_t>(width) * columnWords, 0);
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (map.getTile(x, y) == TileType::Wall) {
+                updateTile(x, y, TileType::Wall);
+            }
+        }
+    }
+}
+
+void LineOfSight::updateTile(int x, int y, TileType tile) {
+    if (x < 0 || y < 0 || x >= width || y >= height) {
+        return;
+    }
+    uint64_t& rowWord = rowBits[static_cast<size_t>(y) * rowWords + x / 64];
+    uint64_t& columnWord = columnBits[static_cast<size_t>(x) * columnWords + y / 64];
+    const uint64_t rowMask = uint64_t{1} << (x % 64);
+    const uint64_t columnMask = uint64_t{1} << (y % 64);
+    if (tile == TileType::Wall) {
+        rowWord |= rowMask;
+        columnWord |= columnMask;
+    } else {
+        rowWord &= ~rowMask;
+        columnWord &= ~columnMask;
+    }
+}
+
+bool LineOfSight::isRowClear(int row, int x0, int x1) const {
+    if (row < 0 || row >= height) {
+        return false;
+    }
+    if (x0 > x1) std::swap(x0, x1);
+    if (x0 < 0 || x1 >= width) {
+        return false; // За пределами карты видимости нет
+    }
+    return isRangeClear(&rowBits[static_cast<size_t>(row) * rowWords], x0, x1);
+}
+
+bool LineOfSight::isColumnClear(int col, int y0, int y1) const {
+    if (col < 0 || col >= width) {
+        return false;
+    }
+    if (y0 > y1) std::swap(y0, y1);
+    if (y0 < 0 || y1 >= height) {
+        return false;
+    }
+    return isRangeClear(&columnBits[static_cast<size_t>(col) * columnWords], y0, y1);
+}
+
+bool LineOfSight::isRangeClear(const uint64_t* bits, int from, int to) {
+    const int firstWord = from / 64;
+    const int lastWord = to / 64;
+    // Маска битов [from % 64, 63] первого слова и [0, to % 64] последнего
+    const uint64_t firstMask = ~uint64_t{0} << (from % 64);
+    const uint64_t lastMask = ~uint64_t{0} >> (63 - to % 64);
+
+    if (firstWord == lastWord) {
+        return (bits[firstWord] & firstMask & lastMask) == 0;
+    }
+    if (bits[firstWord] & firstMask) return false;
+    for (int w = firstWord + 1; w < lastWord; ++w) {
+        if (bits[w]) return false;
+    }
+    return (bits[lastWord] & lastMask) == 0;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include "GameMap.h"
+#include <vector>
+#include <cstdint>
+
+// Проверка прямой видимости вдоль строк и столбцов карты.
+// Стены хранятся битовыми масками по строкам и по столбцам, поэтому
+// "нет ли стен между двумя тайлами одной линии" - несколько битовых операций.
+class LineOfSight {
+public:
+    void build(const GameMap& map);
+    void updateTile(int x, int y, TileType tile);
+
+    // Нет ни одной стены в тайлах строки row с x0 по x1 (в любом порядке, включительно)
+    bool isRowClear(int row, int x0, int x1) const;
+    // То же для столбца col с y0 по y1
+    bool isColumnClear(int col, int y0, int y1) const;
+
+private:
+    static bool isRangeClear(const uint64_t* bits, int from, int to);
+
+    int width = 0;
+    int height = 0;
+    int rowWords = 0;
+    int columnWords = 0;
+    std::vector<uint64_t> rowBits;    // height строк по rowWords слов
+    std::vector<uint64_t> columnBits; // width столбцов по columnWords слов
+};
@@ -0,0 +1,170 @@
+#include "MapGenerator.h"
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+// SplitMix64: быстрый генератор с одинаковым результатом на любой платформе
+// (распределения из <random> от платформы зависят)
+class SplitMix64 {
+public:
+    explicit SplitMix64(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    int range(int lo, int hi) { // [lo, hi]
+        return lo + static_cast<int>(next() % static_cast<uint64_t>(hi - lo + 1));
+    }
+
+    double unit() {
+        return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+private:
+    uint64_t state;
+};
+
+struct Room {
+    int x, y, w, h;
+};
+
+class MapCanvas {
+public:
+    MapCanvas(int width, int height, char fill)
+        : width(width), height(height), stride(width + 1),
+          text(static_cast<size_t>(stride) * height, fill) {
+        for (int y = 0; y < height; ++y) {
+            text[static_cast<size_t>(y) * stride + width] = '\n';
+        }
+    }
+
+    char& at(int x, int y) { return text[static_cast<size_t>(y) * stride + x]; }
+
+    void fillRect(int x0, int y0, int x1, int y1, char c) {
+        // Внешняя рамка карты всегда остается стеной
+        x0 = std::max(x0, 1); y0 = std::max(y0, 1);
+        x1 = std::min(x1, width - 2); y1 = std::min(y1, height - 2);
+        for (int y = y0; y <= y1; ++y) {
+            std::fill_n(&at(x0, y), std::max(0, x1 - x0 + 1), c);
+        }
+    }
+
+    void drawBorder() {
+        std::fill_n(&at(0, 0), width, '#');
+        std::fill_n(&at(0, height - 1), width, '#');
+        for (int y = 0; y < height; ++y) {
+            at(0, y) = '#';
+            at(width - 1, y) = '#';
+        }
+    }
+
+    const int width;
+    const int height;
+    const int stride;
+    std::string text;
+};
+
+void scatterWalls(MapCanvas& canvas, SplitMix64& rng, double density, int x0, int y0, int x1, int y1) {
+    if (density <= 0.0) return;
+    if (density >= 1.0) {
+        // Порог 2^64 не помещается в uint64_t - сплошная стена без розыгрыша
+        canvas.fillRect(x0, y0, x1, y1, '#');
+        return;
+    }
+    // Сравнение целых вместо вещественных - заметно быстрее на больших картах
+    const uint64_t threshold = static_cast<uint64_t>(density * 18446744073709551616.0);
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            if (rng.next() < threshold) canvas.at(x, y) = '#';
+        }
+    }
+}
+
+void carveCorridor(MapCanvas& canvas, int ax, int ay, int bx, int by, int corridorWidth, bool horizontalFirst) {
+    const int half = (corridorWidth - 1) / 2;
+    const int extra = corridorWidth - 1 - half;
+    int cornerX = horizontalFirst ? bx : ax;
+    int cornerY = horizontalFirst ? ay : by;
+    canvas.fillRect(std::min(ax, cornerX) - half, std::min(ay, cornerY) - half,
+                    std::max(ax, cornerX) + extra, std::max(ay, cornerY) + extra, '.');
+    canvas.fillRect(std::min(bx, cornerX) - half, std::min(by, cornerY) - half,
+                    std::max(bx, cornerX) + extra, std::max(by, cornerY) + extra, '.');
+}
+
+void placeSpawns(MapCanvas& canvas, SplitMix64& rng, char marker, int count) {
+    // Случайные пустые клетки; ограничение попыток защищает от почти сплошных карт
+    long long attempts = static_cast<long long>(count) * 64 + 1024;
+    while (count > 0 && attempts-- > 0) {
+        int x = rng.range(1, canvas.width - 2);
+        int y = rng.range(1, canvas.height - 2);
+        if (canvas.at(x, y) == '.') {
+            canvas.at(x, y) = marker;
+            --count;
+        }
+    }
+}
+
+} // namespace
+
+std::string MapGenerator::generate(const MapGeneratorParams& params) {
+    const int width = std::max(params.width, MIN_SIDE);
+    const int height = std::max(params.height, MIN_SIDE);
+    SplitMix64 rng(params.seed);
+
+    MapCanvas canvas(width, height, params.roomCount > 0 ? '#' : '.');
+    canvas.drawBorder();
+
+    if (params.roomCount <= 0) {
+        scatterWalls(canvas, rng, params.wallDensity, 1, 1, width - 2, height - 2);
+    } else {
+        const int minSize = std::max(2, params.minRoomSize);
+        const int maxSize = std::max(minSize, params.maxRoomSize);
+        const int corridorWidth = std::max(1, params.corridorWidth);
+        std::vector<Room> rooms;
+        rooms.reserve(params.roomCount);
+        for (int i = 0; i < params.roomCount; ++i) {
+            Room room;
+            room.w = std::min(rng.range(minSize, maxSize), width - 2);
+            room.h = std::min(rng.range(minSize, maxSize), height - 2);
+            room.x = rng.range(1, width - 1 - room.w);
+            room.y = rng.range(1, height - 1 - room.h);
+            canvas.fillRect(room.x, room.y, room.x + room.w - 1, room.y + room.h - 1, '.');
+            // Препятствия только внутри комнаты, отступив от краев, чтобы входы не перекрывались
+            scatterWalls(canvas, rng, params.wallDensity,
+                         room.x + 1, room.y + 1, room.x + room.w - 2, room.y + room.h - 2);
+            rooms.push_back(room);
+        }
+        // Каждая комната соединяется с предыдущей - так связна вся карта
+        for (size_t i = 1; i < rooms.size(); ++i) {
+            const Room& a = rooms[i - 1];
+            const Room& b = rooms[i];
+            carveCorridor(canvas, a.x + a.w / 2, a.y + a.h / 2, b.x + b.w / 2, b.y + b.h / 2,
+                          corridorWidth, (rng.next() & 1) != 0);
+        }
+    }
+
+    // GameMap требует стартовую позицию игрока, поэтому хотя бы одна 'P' есть всегда
+    placeSpawns(canvas, rng, 'P', std::max(1, params.playerSpawns));
+    placeSpawns(canvas, rng, 'E', std::max(0, params.enemySpawns));
+    return std::move(canvas.text);
+}
+
+bool MapGenerator::writeToStream(const MapGeneratorParams& params, std::ostream& out) {
+    std::string text = generate(params);
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    return out.good();
+}
+
+bool MapGenerator::writeToFile(const MapGeneratorParams& params, const std::string& filename) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    return writeToStream(params, file);
+}
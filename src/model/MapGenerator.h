@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <ostream>
+
+// Параметры процедурной карты. Одинаковые параметры и seed дают одинаковую карту
+struct MapGeneratorParams {
+    int width = 64;
+    int height = 48;
+    uint64_t seed = 1;
+    double wallDensity = 0.1; // Доля случайных одиночных стен в проходимой части
+    int roomCount = 0;        // 0 - открытая арена, иначе комнаты, соединенные коридорами
+    int minRoomSize = 4;
+    int maxRoomSize = 12;
+    int corridorWidth = 2;
+    int playerSpawns = 1;
+    int enemySpawns = 8;
+};
+
+// Генерирует карту в формате, который читает GameMap::loadFromFile:
+// '#' - стена, '.' - пусто, 'P' - игрок, 'E' - точка появления врага
+class MapGenerator {
+public:
+    static constexpr int MIN_SIDE = 3; // Меньшие ширина и высота увеличиваются до него: рамка и одна клетка
+
+    static std::string generate(const MapGeneratorParams& params);
+    static bool writeToStream(const MapGeneratorParams& params, std::ostream& out);
+    static bool writeToFile(const MapGeneratorParams& params, const std::string& filename);
+};
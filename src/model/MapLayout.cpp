@@ -0,0 +1,58 @@
+#include "MapLayout.h"
+#include <fstream>
+
+std::shared_ptr<const MapLayout> MapLayout::fromFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+    return fromStream(file);
+}
+
+std::shared_ptr<const MapLayout> MapLayout::fromStream(std::istream& file) {
+    auto layout = std::make_shared<MapLayout>();
+    std::string line;
+    int currentLineNumber = 0;
+
+    while (std::getline(file, line)) {
+        if (line.empty() && file.eof()) { // Разрешаем одну завершающую пустую строку, если это самый конец
+            break;
+        }
+        if (currentLineNumber == 0) {
+            layout->width = static_cast<int>(line.length());
+            if (layout->width == 0) {
+                return nullptr;
+            }
+        } else if (static_cast<int>(line.length()) != layout->width) {
+            return nullptr;
+        }
+
+        for (int col = 0; col < layout->width; ++col) {
+            char c = line[col];
+            if (c == '#') {
+                layout->ownTiles.push_back(TileType::Wall);
+                continue;
+            }
+            if (c == 'P') {
+                if (layout->playerStart.first == -1) { // Устанавливаем только для первого найденного 'P'
+                    layout->playerStart = {col, currentLineNumber};
+                }
+                layout->ownPlayerStarts.push_back({col, currentLineNumber});
+            } else if (c == 'E') {
+                layout->ownEnemyStarts.push_back({col, currentLineNumber});
+            }
+            layout->ownTiles.push_back(TileType::Empty);
+        }
+        currentLineNumber++;
+    }
+    layout->height = currentLineNumber;
+
+    // Без стартовой позиции игрока карта непригодна
+    if (layout->height == 0 || layout->playerStart.first < 0) {
+        return nullptr;
+    }
+    layout->tiles = layout->ownTiles;
+    layout->playerStarts = layout->ownPlayerStarts;
+    layout->enemyStarts = layout->ownEnemyStarts;
+    return layout;
+}
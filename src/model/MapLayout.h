@@ -0,0 +1,43 @@
+#pragma once
+#include "TileType.h"
+#include <istream>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Разобранная карта в исходном виде: тайлы и точки появления.
+// Неизменяема, поэтому одна копия разделяется всеми GameMap, загруженными из нее
+// (например, всеми матчами сервера на одной карте).
+// Данные смотрят либо в собственные буферы (карта из файла), либо в статические
+// массивы встроенной карты (EmbeddedMaps) - тогда ничего не копируется
+struct MapLayout {
+    using Position = std::pair<int, int>;
+
+    MapLayout() = default;
+    // Карта поверх данных, живущих всю программу
+    constexpr MapLayout(int width, int height, std::span<const TileType> tiles,
+                        std::span<const Position> playerStarts, std::span<const Position> enemyStarts)
+        : width(width), height(height), tiles(tiles),
+          playerStart(playerStarts.empty() ? Position{-1, -1} : playerStarts.front()),
+          playerStarts(playerStarts), enemyStarts(enemyStarts) {}
+    MapLayout(const MapLayout&) = delete; // Спаны смотрят в собственные буферы
+    MapLayout& operator=(const MapLayout&) = delete;
+
+    int width = 0;
+    int height = 0;
+    std::span<const TileType> tiles; // По строкам, width * height
+    Position playerStart{-1, -1}; // Первая 'P'
+    std::span<const Position> playerStarts;
+    std::span<const Position> enemyStarts;
+
+    // nullptr, если карта пустая, строки разной длины или нет стартовой позиции игрока
+    static std::shared_ptr<const MapLayout> fromStream(std::istream& input);
+    static std::shared_ptr<const MapLayout> fromFile(const std::string& filename);
+
+private:
+    std::vector<TileType> ownTiles;
+    std::vector<Position> ownPlayerStarts;
+    std::vector<Position> ownEnemyStarts;
+};
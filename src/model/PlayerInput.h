@@ -0,0 +1,22 @@
+#pragma once
+#include "../common/Direction.h"
+#include <chrono>
+#include <cstdint>
+
+// Состояние управления игроком, снятое с клавиатуры на очередной тик
+struct PlayerInput {
+    bool move = false;
+    Direction moveDirection = Direction::UP;
+    bool fire = false;
+
+    // Было ли с прошлого тика событие клавиатуры и когда пришло самое раннее из них
+    bool hasEvent = false;
+    std::chrono::steady_clock::time_point eventTime;
+};
+
+// Отметки времени последнего события ввода, примененного моделью
+struct InputTiming {
+    uint64_t sequence = 0; // Растет с каждым примененным событием
+    std::chrono::steady_clock::time_point eventTime;
+    std::chrono::steady_clock::time_point tickTime;
+};
@@ -0,0 +1,147 @@
+#include "RewindBuffer.h"
+#include <algorithm>
+#include <random>
+#include <sstream>
+
+namespace {
+
+// Текстовое состояние генератора после draws выданных чисел, начиная с ключевого кадра
+std::string rngStateAt(const GameSnapshot& keyframe, uint64_t draws) {
+    std::mt19937 engine;
+    std::istringstream input(keyframe.rngState);
+    input >> engine;
+    engine.discard(draws - keyframe.rngDraws);
+    std::ostringstream output;
+    output << engine;
+    return output.str();
+}
+
+size_t snapshotMemory(const GameSnapshot& snapshot) {
+    return sizeof(GameSnapshot) + snapshot.rngState.capacity() +
+           snapshot.tileChanges.capacity() * sizeof(GameSnapshot::TileRecord) +
+           snapshot.objects.capacity() * sizeof(GameSnapshot::ObjectRecord);
+}
+
+} // namespace
+
+RewindBuffer::RewindBuffer(int capacityTicks, int keyframeInterval) {
+    configure(capacityTicks, keyframeInterval);
+}
+
+void RewindBuffer::configure(int newCapacityTicks, int newKeyframeInterval) {
+    capacityTicks = std::max(0, newCapacityTicks);
+    keyframeInterval = std::max(1, newKeyframeInterval);
+    clear();
+}
+
+void RewindBuffer::clear() {
+    segments.clear();
+}
+
+bool RewindBuffer::needsKeyframe(uint64_t tick) const {
+    return segments.empty() || tick != newest.tick + 1 ||
+           static_cast<int>(segments.back().deltaEnds.size()) + 1 >= keyframeInterval;
+}
+
+void RewindBuffer::record(const GameSnapshot& state) {
+    if (!isEnabled()) {
+        return;
+    }
+    if (needsKeyframe(state.tick) || !appendDelta(state)) {
+        startSegment(state);
+    }
+    newest = state;
+    evictOldSegments();
+}
+
+void RewindBuffer::startSegment(const GameSnapshot& state) {
+    Segment segment = std::move(spareSegment);
+    segment.keyframe = state;
+    if (segment.keyframe.rngState.empty() && !segments.empty()) {
+        // Снимок без состояния генератора: досчитываем его от предыдущего ключевого кадра
+        segment.keyframe.rngState = rngStateAt(segments.back().keyframe, state.rngDraws);
+    }
+    segment.deltaBytes.clear();
+    segment.deltaEnds.clear();
+    segments.push_back(std::move(segment));
+    spareSegment = Segment{};
+}
+
+bool RewindBuffer::appendDelta(const GameSnapshot& state) {
+    Segment& segment = segments.back();
+    if (!encoder.encode(newest, state, segment.deltaBytes)) {
+        return false;
+    }
+    segment.deltaEnds.push_back(static_cast<uint32_t>(segment.deltaBytes.size()));
+    return true;
+}
+
+void RewindBuffer::evictOldSegments() {
+    // Второй сегмент должен сам покрывать окно, иначе первый еще нужен
+    while (segments.size() > 1 &&
+           newest.tick - segments[1].keyframe.tick + 1 >= static_cast<uint64_t>(capacityTicks)) {
+        spareSegment = std::move(segments.front());
+        segments.pop_front();
+    }
+}
+
+const RewindBuffer::Segment* RewindBuffer::findSegment(uint64_t tick) const {
+    for (auto it = segments.rbegin(); it != segments.rend(); ++it) {
+        if (it->keyframe.tick <= tick) {
+            return tick <= it->keyframe.tick + it->deltaEnds.size() ? &*it : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+bool RewindBuffer::restore(uint64_t tick, GameSnapshot& outState) const {
+    const Segment* segment = findSegment(tick);
+    if (!segment) {
+        return false;
+    }
+    outState = segment->keyframe;
+    size_t begin = 0;
+    for (uint64_t i = 0; i < tick - segment->keyframe.tick; ++i) {
+        size_t end = segment->deltaEnds[i];
+        if (!SnapshotDelta::apply(segment->deltaBytes.data() + begin, end - begin, outState)) {
+            return false;
+        }
+        begin = end;
+    }
+    if (outState.rngDraws != segment->keyframe.rngDraws) {
+        outState.rngState = rngStateAt(segment->keyframe, outState.rngDraws);
+    }
+    return true;
+}
+
+bool RewindBuffer::rewindTo(uint64_t tick, GameSnapshot& outState) {
+    if (!restore(tick, outState)) {
+        return false;
+    }
+    while (!segments.empty() && segments.back().keyframe.tick > tick) {
+        segments.pop_back();
+    }
+    Segment& segment = segments.back();
+    size_t keep = static_cast<size_t>(tick - segment.keyframe.tick);
+    segment.deltaEnds.resize(keep);
+    segment.deltaBytes.resize(keep ? segment.deltaEnds.back() : 0);
+    newest = outState;
+    return true;
+}
+
+uint64_t RewindBuffer::getOldestTick() const {
+    return segments.empty() ? 0 : segments.front().keyframe.tick;
+}
+
+uint64_t RewindBuffer::getNewestTick() const {
+    return segments.empty() ? 0 : newest.tick;
+}
+
+size_t RewindBuffer::getMemoryUsage() const {
+    size_t total = snapshotMemory(newest) + snapshotMemory(spareSegment.keyframe);
+    for (const auto& segment : segments) {
+        total += snapshotMemory(segment.keyframe) + segment.deltaBytes.capacity() +
+                 segment.deltaEnds.capacity() * sizeof(uint32_t);
+    }
+    return total;
+}
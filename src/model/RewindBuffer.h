@@ -0,0 +1,58 @@
+#pragma once
+#include "GameSnapshot.h"
+#include "SnapshotDelta.h"
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+// Кольцевой буфер последних тиков симуляции для перемотки и поиска рассинхронизаций.
+// Буфер состоит из сегментов: полный снимок (ключевой кадр) и упакованные дельты
+// следующих тиков (SnapshotDelta). Восстановление любого тика - один ключевой кадр и не больше
+// keyframeInterval дельт. Старые сегменты отбрасываются целиком, поэтому в буфере
+// всегда не меньше capacityTicks последних тиков
+class RewindBuffer {
+public:
+    explicit RewindBuffer(int capacityTicks = 600, int keyframeInterval = 60);
+
+    void configure(int capacityTicks, int keyframeInterval); // capacityTicks = 0 выключает запись
+    void clear();
+
+    bool isEnabled() const { return capacityTicks > 0; }
+    // Запись тика tick станет ключевым кадром - тогда снимку нужно rngState
+    bool needsKeyframe(uint64_t tick) const;
+
+    // Состояние после тика state.tick. Тики должны идти подряд, иначе начинается новый сегмент
+    void record(const GameSnapshot& state);
+
+    // Состояние на тике tick (rngState восстанавливается). false, если тик вне буфера
+    bool restore(uint64_t tick, GameSnapshot& outState) const;
+    // Восстанавливает тик и забывает все, что было после него
+    bool rewindTo(uint64_t tick, GameSnapshot& outState);
+
+    bool isEmpty() const { return segments.empty(); }
+    uint64_t getOldestTick() const;
+    uint64_t getNewestTick() const;
+    size_t getKeyframeCount() const { return segments.size(); }
+    size_t getMemoryUsage() const; // Приблизительно, в байтах
+
+private:
+    struct Segment {
+        GameSnapshot keyframe;
+        std::vector<uint8_t> deltaBytes;
+        std::vector<uint32_t> deltaEnds; // Дельта i переводит в тик keyframe.tick + i + 1
+    };
+
+    void startSegment(const GameSnapshot& state);
+    bool appendDelta(const GameSnapshot& state);
+    void evictOldSegments();
+    const Segment* findSegment(uint64_t tick) const;
+
+    int capacityTicks;
+    int keyframeInterval;
+    std::deque<Segment> segments;
+    Segment spareSegment; // Вытесненный сегмент: его буферы переиспользуются
+    GameSnapshot newest;  // База для следующей дельты
+
+    SnapshotDelta encoder;
+};
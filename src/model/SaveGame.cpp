@@ -0,0 +1,233 @@
+#include "SaveGame.h"
+#include "../common/ByteStream.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#ifdef ARCADE_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+constexpr char MAGIC[4] = {'T', 'N', 'K', 'S'};
+constexpr size_t HEADER_SIZE = 16; // Сигнатура, версия, сжатие, резерв, исходный и сохраненный размер
+
+enum class Compression : uint8_t {
+    None = 0,
+    Zlib = 1
+};
+
+constexpr size_t TILE_RECORD_SIZE = 9;
+constexpr size_t OBJECT_RECORD_SIZE_V1 = 35;
+constexpr size_t OBJECT_RECORD_SIZE = 39;
+
+} // namespace
+
+void SaveGame::serialize(const GameSnapshot& snapshot, std::vector<uint8_t>& outPayload) {
+    outPayload.clear();
+    outPayload.reserve(64 + snapshot.rngState.size() +
+                       snapshot.tileChanges.size() * TILE_RECORD_SIZE +
+                       snapshot.objects.size() * OBJECT_RECORD_SIZE);
+    ByteWriter out(outPayload);
+
+    out.u64(snapshot.tick);
+    out.i32(snapshot.mapWidth);
+    out.i32(snapshot.mapHeight);
+    out.u8(snapshot.state);
+    out.i32(snapshot.score);
+    out.f32(snapshot.gameTime);
+    out.u32(static_cast<uint32_t>(snapshot.rngState.size()));
+    out.bytes(snapshot.rngState.data(), snapshot.rngState.size());
+    out.u64(snapshot.rngDraws);
+
+    out.u32(static_cast<uint32_t>(snapshot.tileChanges.size()));
+    for (const auto& tile : snapshot.tileChanges) {
+        out.i32(tile.x);
+        out.i32(tile.y);
+        out.u8(tile.tile);
+    }
+
+    out.u32(snapshot.nextObjectId);
+    out.u32(static_cast<uint32_t>(snapshot.objects.size()));
+    for (const auto& object : snapshot.objects) {
+        out.u32(object.id);
+        out.u8(static_cast<uint8_t>(object.kind));
+        out.f32(object.x);
+        out.f32(object.y);
+        out.u8(object.direction);
+        out.u8(object.player);
+        out.i32(object.health);
+        out.i32(object.maxHealth);
+        out.f32(object.reloadTime);
+        out.f32(object.timeSinceLastShot);
+        out.f32(object.speed);
+        out.i32(object.damage);
+    }
+}
+
+bool SaveGame::deserialize(const uint8_t* data, size_t size, GameSnapshot& outSnapshot, uint16_t version) {
+    if (version < 1 || version > FORMAT_VERSION) {
+        return false;
+    }
+    const bool hasIds = version >= 2;
+    const bool hasWallDamage = version >= 3;
+    ByteReader in(data, size);
+
+    outSnapshot.tick = hasIds ? in.u64() : 0;
+    outSnapshot.mapWidth = in.i32();
+    outSnapshot.mapHeight = in.i32();
+    outSnapshot.state = in.u8();
+    outSnapshot.score = in.i32();
+    outSnapshot.gameTime = in.f32();
+    uint32_t rngSize = 0;
+    if (!in.count(rngSize, 1)) return false;
+    outSnapshot.rngState.resize(rngSize);
+    if (!in.bytes(outSnapshot.rngState.data(), rngSize)) return false;
+    outSnapshot.rngDraws = hasIds ? in.u64() : 0;
+
+    uint32_t tileCount = 0;
+    if (!in.count(tileCount, TILE_RECORD_SIZE)) return false;
+    outSnapshot.tileChanges.resize(tileCount);
+    for (auto& tile : outSnapshot.tileChanges) {
+        tile.x = in.i32();
+        tile.y = in.i32();
+        tile.tile = in.u8();
+        if (!hasWallDamage) {
+            tile.tile = tile.tile ? 1 : 0; // До версии 3 тайл - только пусто или стена
+        }
+    }
+
+    outSnapshot.nextObjectId = hasIds ? in.u32() : 1;
+    uint32_t objectCount = 0;
+    if (!in.count(objectCount, hasIds ? OBJECT_RECORD_SIZE : OBJECT_RECORD_SIZE_V1)) return false;
+    outSnapshot.objects.resize(objectCount);
+    for (auto& object : outSnapshot.objects) {
+        // В первой версии id не было: нумеруем по порядку, как при новой игре
+        object.id = hasIds ? in.u32() : outSnapshot.nextObjectId++;
+        object.kind = static_cast<GameSnapshot::ObjectKind>(in.u8());
+        object.x = in.f32();
+        object.y = in.f32();
+        object.direction = in.u8();
+        object.player = in.u8();
+        object.health = in.i32();
+        object.maxHealth = in.i32();
+        object.reloadTime = in.f32();
+        object.timeSinceLastShot = in.f32();
+        object.speed = in.f32();
+        object.damage = in.i32();
+    }
+    return in.ok() && in.remaining() == 0;
+}
+
+void SaveGame::pack(const std::vector<uint8_t>& payload, std::vector<uint8_t>& outFile) {
+    outFile.clear();
+    Compression compression = Compression::None;
+    const uint8_t* stored = payload.data();
+    size_t storedSize = payload.size();
+
+#ifdef ARCADE_HAVE_ZLIB
+    // Самый быстрый уровень: сохранения в основном из повторяющихся записей,
+    // и более сильное сжатие почти ничего не дает, а время увеличивает заметно
+    std::vector<uint8_t> compressed(compressBound(static_cast<uLong>(payload.size())));
+    uLongf compressedSize = static_cast<uLongf>(compressed.size());
+    if (compress2(compressed.data(), &compressedSize, payload.data(),
+                  static_cast<uLong>(payload.size()), Z_BEST_SPEED) == Z_OK &&
+        compressedSize < payload.size()) {
+        compression = Compression::Zlib;
+        compressed.resize(compressedSize);
+    }
+#endif
+
+    ByteWriter out(outFile);
+    out.bytes(MAGIC, sizeof(MAGIC));
+    out.u16(FORMAT_VERSION);
+    out.u8(static_cast<uint8_t>(compression));
+    out.u8(0);
+    out.u32(static_cast<uint32_t>(payload.size()));
+#ifdef ARCADE_HAVE_ZLIB
+    if (compression == Compression::Zlib) {
+        stored = compressed.data();
+        storedSize = compressed.size();
+    }
+#endif
+    out.u32(static_cast<uint32_t>(storedSize));
+    out.bytes(stored, storedSize);
+}
+
+bool SaveGame::unpack(const std::vector<uint8_t>& file, std::vector<uint8_t>& outPayload,
+                      uint16_t& outVersion) {
+    ByteReader in(file.data(), file.size());
+    char magic[4];
+    if (!in.bytes(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+        return false;
+    }
+    uint16_t version = in.u16();
+    Compression compression = static_cast<Compression>(in.u8());
+    in.u8();
+    uint32_t rawSize = in.u32();
+    uint32_t storedSize = in.u32();
+    if (!in.ok() || version < 1 || version > FORMAT_VERSION || storedSize != in.remaining()) {
+        return false;
+    }
+    outVersion = version;
+    const uint8_t* stored = file.data() + HEADER_SIZE;
+
+    if (compression == Compression::None) {
+        if (rawSize != storedSize) return false;
+        outPayload.assign(stored, stored + storedSize);
+        return true;
+    }
+#ifdef ARCADE_HAVE_ZLIB
+    if (compression == Compression::Zlib) {
+        outPayload.resize(rawSize);
+        uLongf size = rawSize;
+        return uncompress(outPayload.data(), &size, stored, storedSize) == Z_OK && size == rawSize;
+    }
+#endif
+    return false; // Сохранение сжато, а эта сборка без zlib
+}
+
+bool SaveGame::writeFile(const std::string& filename, const GameSnapshot& snapshot) {
+    std::vector<uint8_t> payload;
+    std::vector<uint8_t> file;
+    serialize(snapshot, payload);
+    pack(payload, file);
+
+    const std::string tempName = filename + ".tmp";
+    {
+        std::ofstream out(tempName, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+        if (!out.good()) {
+            return false;
+        }
+    }
+#ifdef _WIN32
+    std::remove(filename.c_str()); // На Windows rename не перезаписывает существующий файл
+#endif
+    return std::rename(tempName.c_str(), filename.c_str()) == 0;
+}
+
+bool SaveGame::readFile(const std::string& filename, GameSnapshot& outSnapshot) {
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        return false;
+    }
+    std::streamsize fileSize = in.tellg();
+    if (fileSize < static_cast<std::streamsize>(HEADER_SIZE)) {
+        return false;
+    }
+    std::vector<uint8_t> file(static_cast<size_t>(fileSize));
+    in.seekg(0);
+    if (!in.read(reinterpret_cast<char*>(file.data()), fileSize)) {
+        return false;
+    }
+    std::vector<uint8_t> payload;
+    uint16_t version = 0;
+    if (!unpack(file, payload, version)) {
+        return false;
+    }
+    return deserialize(payload.data(), payload.size(), outSnapshot, version);
+}
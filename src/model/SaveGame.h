@@ -0,0 +1,32 @@
+#pragma once
+#include "GameSnapshot.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// Версионированный двоичный формат сохранений.
+// Файл: заголовок (сигнатура, версия, способ сжатия, размеры) и полезная нагрузка,
+// сжатая zlib, если он был найден при сборке. Все числа - little-endian
+class SaveGame {
+public:
+    // 2: номер тика, счетчик генератора и id объектов
+    // 3: код тайла 1 + d - стена с уроном d (разрушаемые стены)
+    static constexpr uint16_t FORMAT_VERSION = 3;
+
+    // Снимок <-> полезная нагрузка без заголовка. Старые версии читаются,
+    // недостающие поля заполняются так, как их выдала бы новая игра
+    static void serialize(const GameSnapshot& snapshot, std::vector<uint8_t>& outPayload);
+    static bool deserialize(const uint8_t* data, size_t size, GameSnapshot& outSnapshot,
+                            uint16_t version = FORMAT_VERSION);
+
+    // Полезная нагрузка <-> содержимое файла (заголовок и сжатие)
+    static void pack(const std::vector<uint8_t>& payload, std::vector<uint8_t>& outFile);
+    static bool unpack(const std::vector<uint8_t>& file, std::vector<uint8_t>& outPayload,
+                       uint16_t& outVersion);
+
+    // Запись идет во временный файл с последующим переименованием,
+    // поэтому прерванное сохранение не портит предыдущее
+    static bool writeFile(const std::string& filename, const GameSnapshot& snapshot);
+    static bool readFile(const std::string& filename, GameSnapshot& outSnapshot);
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+// Общие макросы векторных ядер модели. ARCADE_X86 - есть SSE2 и можно компилировать
+// AVX2-функции; ARCADE_TARGET_AVX2 помечает такие функции (вызывать их можно только
+// после проверки процессора, см. BulletArray::getBestKernel)
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ARCADE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define ARCADE_TARGET_AVX2
+#else
+#define ARCADE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
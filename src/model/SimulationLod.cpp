@@ -0,0 +1,52 @@
+#include "SimulationLod.h"
+#include <algorithm>
+#include <cmath>
+
+SimulationLod::SimulationLod() {
+    configure(SimulationLodConfig{});
+}
+
+void SimulationLod::configure(const SimulationLodConfig& newConfig) {
+    config = newConfig;
+    config.nearTiles = std::max(0, config.nearTiles);
+    config.midTiles = std::max(config.nearTiles, config.midTiles);
+    config.midInterval = std::clamp(config.midInterval, 1, 30);
+    // Ходы независимы, поэтому за интервал сохраняется среднее число шагов.
+    // Выстрел возможен один раз за перезарядку: сохраняется шанс выстрелить хоть раз за интервал
+    midMoveChance = std::min<uint32_t>(150, NEAR_MOVE_CHANCE * static_cast<uint32_t>(config.midInterval));
+    midFireChance = static_cast<uint32_t>(
+        std::lround(100.0 * (1.0 - std::pow(1.0 - NEAR_FIRE_CHANCE / 100.0, config.midInterval))));
+}
+
+void SimulationLod::build(int mapWidth, int mapHeight, float tileSize) {
+    regionsX = std::max(1, (mapWidth + REGION_TILES - 1) / REGION_TILES);
+    regionsY = std::max(1, (mapHeight + REGION_TILES - 1) / REGION_TILES);
+    regionSize = tileSize * REGION_TILES;
+    regions.assign(static_cast<size_t>(regionsX) * regionsY, Tier::Far);
+}
+
+int SimulationLod::regionOf(float coord) const {
+    return static_cast<int>(std::floor(coord / regionSize));
+}
+
+void SimulationLod::markAround(int regionX, int regionY, int radius, Tier tier) {
+    const int left = std::max(0, regionX - radius);
+    const int right = std::min(regionsX - 1, regionX + radius);
+    const int top = std::max(0, regionY - radius);
+    const int bottom = std::min(regionsY - 1, regionY + radius);
+    for (int y = top; y <= bottom; ++y) {
+        for (int x = left; x <= right; ++x) {
+            Tier& region = regions[static_cast<size_t>(y) * regionsX + x];
+            region = std::min(region, tier);
+        }
+    }
+}
+
+SimulationLod::Tier SimulationLod::tierAt(float x, float y) const {
+    if (!config.enabled) {
+        return Tier::Near;
+    }
+    const int regionX = std::clamp(regionOf(x), 0, regionsX - 1);
+    const int regionY = std::clamp(regionOf(y), 0, regionsY - 1);
+    return regions[static_cast<size_t>(regionY) * regionsX + regionX];
+}
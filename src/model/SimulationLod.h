@@ -0,0 +1,90 @@
+#pragma once
+#include "BulletArray.h"
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+// Уровни детализации симуляции врагов по расстоянию до игроков.
+// Карта делится на области REGION_TILES x REGION_TILES тайлов; в начале тика каждая
+// область получает уровень по расстоянию (в областях) до ближайшего танка игрока:
+// близкие враги думают каждый тик, средние - раз в midInterval тиков с шансами,
+// растянутыми на этот интервал, дальние спят. Пуля игрока будит свою область до
+// среднего уровня. Уровни считаются заново из состояния модели в каждом тике, поэтому
+// сервер, клиенты и перемотка получают одинаковые решения без лишних полей в снимке
+struct SimulationLodConfig {
+    bool enabled = true;
+    int nearTiles = 24;  // Примерно экран вокруг игрока
+    int midTiles = 48;
+    int midInterval = 4; // 1..30
+};
+
+class SimulationLod {
+public:
+    enum class Tier : uint8_t { Near, Mid, Far };
+    static constexpr int REGION_TILES = 8;
+
+    SimulationLod();
+
+    void configure(const SimulationLodConfig& config);
+    const SimulationLodConfig& getConfig() const { return config; }
+    void build(int mapWidth, int mapHeight, float tileSize); // Размер карты в тайлах
+
+    // Уровни областей на этот тик. players - позиции танков игроков (левый верхний угол)
+    template <typename PositionList>
+    void beginTick(const PositionList& players, const BulletArray& bullets);
+
+    Tier tierAt(float x, float y) const;
+    // Думает ли враг с уровнем tier в тике tick; id разносит средних по разным тикам
+    bool shouldThink(Tier tier, uint32_t id, uint64_t tick) const {
+        return tier == Tier::Near ||
+               (tier == Tier::Mid && (tick + id) % static_cast<uint64_t>(config.midInterval) == 0);
+    }
+    // Шансы решений на тик ИИ: ход из 150 и выстрел из 100 для близких, растянутые для средних
+    uint32_t moveChance(Tier tier) const { return tier == Tier::Near ? NEAR_MOVE_CHANCE : midMoveChance; }
+    uint32_t fireChance(Tier tier) const { return tier == Tier::Near ? NEAR_FIRE_CHANCE : midFireChance; }
+
+    // Для отладки и бенчмарков: враги каждого уровня в последнем тике
+    void countEnemy(Tier tier) { ++counts[static_cast<int>(tier)]; }
+    int getCount(Tier tier) const { return counts[static_cast<int>(tier)]; }
+
+private:
+    static constexpr uint32_t NEAR_MOVE_CHANCE = 5;
+    static constexpr uint32_t NEAR_FIRE_CHANCE = 20;
+
+    void markAround(int regionX, int regionY, int radius, Tier tier);
+    int regionOf(float coord) const;
+
+    SimulationLodConfig config;
+    uint32_t midMoveChance = NEAR_MOVE_CHANCE;
+    uint32_t midFireChance = NEAR_FIRE_CHANCE;
+    std::vector<Tier> regions;
+    int regionsX = 0;
+    int regionsY = 0;
+    float regionSize = 1.0f;
+    int counts[3] = {};
+};
+
+template <typename PositionList>
+void SimulationLod::beginTick(const PositionList& players, const BulletArray& bullets) {
+    std::fill(std::begin(counts), std::end(counts), 0);
+    if (!config.enabled) {
+        return;
+    }
+    std::fill(regions.begin(), regions.end(), Tier::Far);
+    const int nearRadius = (config.nearTiles + REGION_TILES - 1) / REGION_TILES;
+    const int midRadius = (config.midTiles + REGION_TILES - 1) / REGION_TILES;
+    // Сначала средний круг, затем ближний поверх: уровень области - лучший из всех игроков
+    for (const auto& position : players) {
+        markAround(regionOf(position.first), regionOf(position.second), midRadius, Tier::Mid);
+    }
+    for (size_t i = 0; i < bullets.size(); ++i) {
+        if (bullets.isFromPlayer(i) && !bullets.isDestroyed(i)) {
+            markAround(regionOf(bullets.getX(i)), regionOf(bullets.getY(i)), 0, Tier::Mid);
+        }
+    }
+    for (const auto& position : players) {
+        markAround(regionOf(position.first), regionOf(position.second), nearRadius, Tier::Near);
+    }
+}
@@ -0,0 +1,295 @@
+#include "SnapshotDelta.h"
+#include "../common/ByteStream.h"
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+using ObjectRecord = GameSnapshot::ObjectRecord;
+using TileRecord = GameSnapshot::TileRecord;
+
+constexpr uint8_t TILE_REMOVED = 0xFF; // Тайл снова совпадает с исходной картой
+
+// Биты маски изменившихся полей объекта
+constexpr uint8_t FIELD_STEP = 0x01;      // Сдвинулся ровно на speed по направлению - без данных
+constexpr uint8_t FIELD_X = 0x02;
+constexpr uint8_t FIELD_Y = 0x04;
+constexpr uint8_t FIELD_DIRECTION = 0x08;
+constexpr uint8_t FIELD_HEALTH = 0x10;
+constexpr uint8_t FIELD_RELOAD_TIMER = 0x20;
+constexpr uint8_t FIELD_OTHER = 0x40;     // Редко меняющиеся поля одним блоком
+
+bool sameBits(float a, float b) {
+    return std::bit_cast<uint32_t>(a) == std::bit_cast<uint32_t>(b);
+}
+
+bool tileLess(const TileRecord& a, const TileRecord& b) {
+    return a.x != b.x ? a.x < b.x : a.y < b.y;
+}
+
+// Положение после шага на speed - тот же результат, что у BulletArray::integrate
+void stepPosition(const ObjectRecord& from, uint8_t direction, float speed, float& x, float& y) {
+    x = from.x;
+    y = from.y;
+    switch (direction) {
+        case 0: y -= speed; break; // UP
+        case 1: y += speed; break; // DOWN
+        case 2: x -= speed; break; // LEFT
+        default: x += speed; break; // RIGHT
+    }
+}
+
+bool otherFieldsDiffer(const ObjectRecord& a, const ObjectRecord& b) {
+    return a.kind != b.kind || a.player != b.player || a.maxHealth != b.maxHealth ||
+           !sameBits(a.reloadTime, b.reloadTime) || !sameBits(a.speed, b.speed) || a.damage != b.damage;
+}
+
+void writeOtherFields(ByteWriter& out, const ObjectRecord& object) {
+    out.u8(static_cast<uint8_t>(object.kind));
+    out.u8(object.player);
+    out.zigzag(object.maxHealth);
+    out.f32(object.reloadTime);
+    out.f32(object.speed);
+    out.zigzag(object.damage);
+}
+
+void readOtherFields(ByteReader& in, ObjectRecord& object) {
+    object.kind = static_cast<GameSnapshot::ObjectKind>(in.u8());
+    object.player = in.u8();
+    object.maxHealth = static_cast<int32_t>(in.zigzag());
+    object.reloadTime = in.f32();
+    object.speed = in.f32();
+    object.damage = static_cast<int32_t>(in.zigzag());
+}
+
+} // namespace
+
+bool SnapshotDelta::apply(const uint8_t* data, size_t size, GameSnapshot& state) {
+    // Порядок полей совпадает с encode()
+    ByteReader in(data, size);
+    state.tick += in.varint();
+    state.rngDraws += in.varint();
+    state.state = in.u8();
+    state.score = static_cast<int32_t>(state.score + in.zigzag());
+    state.gameTime = in.f32();
+    uint32_t previousNextId = state.nextObjectId;
+    state.nextObjectId = static_cast<uint32_t>(state.nextObjectId + in.varint());
+
+    // Тайлы: слияние двух списков, упорядоченных по (x, y)
+    size_t tileOpCount = in.varint();
+    std::vector<TileRecord> tiles;
+    tiles.reserve(state.tileChanges.size() + tileOpCount);
+    size_t oldTile = 0;
+    for (size_t i = 0; i < tileOpCount && in.ok(); ++i) {
+        TileRecord op;
+        op.x = static_cast<int32_t>(in.varint());
+        op.y = static_cast<int32_t>(in.varint());
+        op.tile = in.u8();
+        while (oldTile < state.tileChanges.size() && tileLess(state.tileChanges[oldTile], op)) {
+            tiles.push_back(state.tileChanges[oldTile++]);
+        }
+        if (oldTile < state.tileChanges.size() && !tileLess(op, state.tileChanges[oldTile])) {
+            ++oldTile; // Та же позиция: старое значение заменяется или удаляется
+        }
+        if (op.tile != TILE_REMOVED) {
+            tiles.push_back(op);
+        }
+    }
+    tiles.insert(tiles.end(), state.tileChanges.begin() + oldTile, state.tileChanges.end());
+    state.tileChanges.swap(tiles);
+
+    // Объекты: исчезнувшие и изменившиеся идут по возрастанию id, как и сам список
+    std::vector<ObjectRecord> objects;
+    objects.reserve(state.objects.size());
+    size_t destroyedCount = in.varint();
+    std::vector<uint32_t> destroyed(std::min<size_t>(destroyedCount, size));
+    uint32_t id = 0;
+    for (auto& destroyedId : destroyed) {
+        id += static_cast<uint32_t>(in.varint());
+        destroyedId = id;
+    }
+
+    size_t changedCount = in.varint();
+    size_t nextOld = 0;
+    size_t nextDestroyed = 0;
+    auto copyUpTo = [&](uint32_t limitId) {
+        while (nextOld < state.objects.size() && state.objects[nextOld].id < limitId) {
+            const ObjectRecord& object = state.objects[nextOld++];
+            if (nextDestroyed < destroyed.size() && destroyed[nextDestroyed] == object.id) {
+                ++nextDestroyed;
+                continue;
+            }
+            objects.push_back(object);
+        }
+    };
+    id = 0;
+    for (size_t i = 0; i < changedCount && in.ok(); ++i) {
+        id += static_cast<uint32_t>(in.varint());
+        copyUpTo(id);
+        if (nextOld >= state.objects.size() || state.objects[nextOld].id != id) {
+            return false;
+        }
+        const ObjectRecord& previous = state.objects[nextOld++];
+        ObjectRecord object = previous;
+        uint8_t mask = in.u8();
+        if (mask & FIELD_OTHER) readOtherFields(in, object);
+        if (mask & FIELD_DIRECTION) object.direction = in.u8();
+        if (mask & FIELD_HEALTH) object.health = static_cast<int32_t>(object.health + in.zigzag());
+        if (mask & FIELD_RELOAD_TIMER) object.timeSinceLastShot = in.f32();
+        if (mask & FIELD_STEP) stepPosition(previous, object.direction, object.speed, object.x, object.y);
+        if (mask & FIELD_X) object.x = in.f32();
+        if (mask & FIELD_Y) object.y = in.f32();
+        objects.push_back(object);
+    }
+    copyUpTo(previousNextId);
+
+    size_t spawnedCount = in.varint();
+    for (size_t i = 0; i < spawnedCount && in.ok(); ++i) {
+        ObjectRecord object;
+        object.id = static_cast<uint32_t>(previousNextId + in.varint());
+        readOtherFields(in, object);
+        object.x = in.f32();
+        object.y = in.f32();
+        object.direction = in.u8();
+        object.health = static_cast<int32_t>(in.zigzag());
+        object.timeSinceLastShot = in.f32();
+        objects.push_back(object);
+    }
+    state.objects.swap(objects);
+    return in.ok() && in.atEnd() && nextDestroyed == destroyed.size();
+}
+
+bool SnapshotDelta::encode(const GameSnapshot& previous, const GameSnapshot& state,
+                           std::vector<uint8_t>& outBytes) {
+    if (state.tick < previous.tick || state.rngDraws < previous.rngDraws ||
+        state.nextObjectId < previous.nextObjectId) {
+        return false;
+    }
+
+    // Тайлы: слияние упорядоченных списков
+    tileOps.clear();
+    size_t a = 0;
+    size_t b = 0;
+    while (a < previous.tileChanges.size() || b < state.tileChanges.size()) {
+        if (b > 0 && b < state.tileChanges.size() && !tileLess(state.tileChanges[b - 1], state.tileChanges[b])) {
+            return false;
+        }
+        if (b == state.tileChanges.size() ||
+            (a < previous.tileChanges.size() && tileLess(previous.tileChanges[a], state.tileChanges[b]))) {
+            TileRecord removed = previous.tileChanges[a++];
+            removed.tile = TILE_REMOVED;
+            tileOps.push_back(removed);
+        } else if (a == previous.tileChanges.size() || tileLess(state.tileChanges[b], previous.tileChanges[a])) {
+            tileOps.push_back(state.tileChanges[b++]);
+        } else {
+            if (previous.tileChanges[a].tile != state.tileChanges[b].tile) {
+                tileOps.push_back(state.tileChanges[b]);
+            }
+            ++a;
+            ++b;
+        }
+    }
+
+    // Объекты: слияние по id. Новые объекты обязаны быть в конце списка
+    destroyedIds.clear();
+    changedObjects.clear();
+    spawnedObjects.clear();
+    a = 0;
+    b = 0;
+    while (a < previous.objects.size() || b < state.objects.size()) {
+        if (b > 0 && b < state.objects.size() && state.objects[b - 1].id >= state.objects[b].id) {
+            return false;
+        }
+        if (b == state.objects.size() ||
+            (a < previous.objects.size() && previous.objects[a].id < state.objects[b].id)) {
+            destroyedIds.push_back(previous.objects[a++].id);
+        } else if (a == previous.objects.size() || state.objects[b].id < previous.objects[a].id) {
+            if (state.objects[b].id < previous.nextObjectId || state.objects[b].id >= state.nextObjectId) {
+                return false;
+            }
+            spawnedObjects.push_back(b++);
+        } else {
+            changedObjects.push_back({a++, b++});
+        }
+    }
+
+    ByteWriter out(outBytes);
+    out.varint(state.tick - previous.tick);
+    out.varint(state.rngDraws - previous.rngDraws);
+    out.u8(state.state);
+    out.zigzag(static_cast<int64_t>(state.score) - previous.score);
+    out.f32(state.gameTime);
+    out.varint(state.nextObjectId - previous.nextObjectId);
+
+    out.varint(tileOps.size());
+    for (const auto& op : tileOps) {
+        out.varint(static_cast<uint32_t>(op.x));
+        out.varint(static_cast<uint32_t>(op.y));
+        out.u8(op.tile);
+    }
+
+    out.varint(destroyedIds.size());
+    uint32_t lastId = 0;
+    for (uint32_t id : destroyedIds) {
+        out.varint(id - lastId);
+        lastId = id;
+    }
+
+    // Число изменившихся объектов пишется до них, поэтому сначала считаем маски
+    size_t changedCount = 0;
+    for (auto& pair : changedObjects) {
+        const ObjectRecord& before = previous.objects[pair.first];
+        const ObjectRecord& after = state.objects[pair.second];
+        bool moved = !sameBits(before.x, after.x) || !sameBits(before.y, after.y);
+        if (moved || before.direction != after.direction || before.health != after.health ||
+            !sameBits(before.timeSinceLastShot, after.timeSinceLastShot) || otherFieldsDiffer(before, after)) {
+            changedObjects[changedCount++] = pair;
+        }
+    }
+    changedObjects.resize(changedCount);
+
+    out.varint(changedObjects.size());
+    lastId = 0;
+    for (const auto& pair : changedObjects) {
+        const ObjectRecord& before = previous.objects[pair.first];
+        const ObjectRecord& after = state.objects[pair.second];
+        uint8_t mask = 0;
+        if (otherFieldsDiffer(before, after)) mask |= FIELD_OTHER;
+        if (before.direction != after.direction) mask |= FIELD_DIRECTION;
+        if (before.health != after.health) mask |= FIELD_HEALTH;
+        if (!sameBits(before.timeSinceLastShot, after.timeSinceLastShot)) mask |= FIELD_RELOAD_TIMER;
+        if (!sameBits(before.x, after.x) || !sameBits(before.y, after.y)) {
+            float stepX, stepY;
+            stepPosition(before, after.direction, after.speed, stepX, stepY);
+            if (sameBits(stepX, after.x) && sameBits(stepY, after.y)) {
+                mask |= FIELD_STEP; // Обычный случай для пуль и едущих танков
+            } else {
+                if (!sameBits(before.x, after.x)) mask |= FIELD_X;
+                if (!sameBits(before.y, after.y)) mask |= FIELD_Y;
+            }
+        }
+
+        out.varint(after.id - lastId);
+        lastId = after.id;
+        out.u8(mask);
+        if (mask & FIELD_OTHER) writeOtherFields(out, after);
+        if (mask & FIELD_DIRECTION) out.u8(after.direction);
+        if (mask & FIELD_HEALTH) out.zigzag(static_cast<int64_t>(after.health) - before.health);
+        if (mask & FIELD_RELOAD_TIMER) out.f32(after.timeSinceLastShot);
+        if (mask & FIELD_X) out.f32(after.x);
+        if (mask & FIELD_Y) out.f32(after.y);
+    }
+
+    out.varint(spawnedObjects.size());
+    for (size_t index : spawnedObjects) {
+        const ObjectRecord& object = state.objects[index];
+        out.varint(object.id - previous.nextObjectId);
+        writeOtherFields(out, object);
+        out.f32(object.x);
+        out.f32(object.y);
+        out.u8(object.direction);
+        out.zigzag(object.health);
+        out.f32(object.timeSinceLastShot);
+    }
+    return true;
+}
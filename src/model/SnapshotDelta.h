@@ -0,0 +1,27 @@
+#pragma once
+#include "GameSnapshot.h"
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Упакованная разница между двумя снимками одной симуляции: изменившиеся поля объектов,
+// появившиеся и исчезнувшие объекты, измененные тайлы. Используется буфером перемотки
+// (соседние тики) и сетевой репликацией (от подтвержденного клиентом снимка).
+// Объекты сопоставляются по id, поэтому в обоих снимках id должны возрастать
+class SnapshotDelta {
+public:
+    // Дописывает в outBytes дельту, переводящую base в target. false (и ничего не пишет),
+    // если снимки нельзя связать дельтой - тогда нужен полный снимок
+    bool encode(const GameSnapshot& base, const GameSnapshot& target, std::vector<uint8_t>& outBytes);
+
+    // Применяет дельту к state на месте. rngState не меняется, только счетчик rngDraws
+    static bool apply(const uint8_t* data, size_t size, GameSnapshot& state);
+
+private:
+    // Рабочие списки, переиспользуются между вызовами
+    std::vector<uint32_t> destroyedIds;
+    std::vector<std::pair<size_t, size_t>> changedObjects; // (индекс в base, индекс в target)
+    std::vector<size_t> spawnedObjects;
+    std::vector<GameSnapshot::TileRecord> tileOps;
+};
@@ -0,0 +1,116 @@
+#include "SpawnSlotTracker.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+int64_t tileKey(int x, int y) {
+    return (static_cast<int64_t>(y) << 32) | static_cast<uint32_t>(x);
+}
+}
+
+void SpawnSlotTracker::build(const GameMap& map, float newTileSize, float newTankSize) {
+    tileSize = newTileSize;
+    tankSize = newTankSize;
+    slots.clear();
+    slotByTile.clear();
+
+    for (const auto& pos : map.enemyStarts) {
+        if (pos.first < 0 || pos.first >= map.getWidth() ||
+            pos.second < 0 || pos.second >= map.getHeight() ||
+            slotByTile.count(tileKey(pos.first, pos.second))) {
+            continue;
+        }
+        Slot slot;
+        slot.tileX = pos.first;
+        slot.tileY = pos.second;
+        slot.x = pos.first * tileSize + (tileSize - tankSize) / 2.0f;
+        slot.y = pos.second * tileSize + (tileSize - tankSize) / 2.0f;
+        slotByTile[tileKey(pos.first, pos.second)] = static_cast<int>(slots.size());
+        slots.push_back(slot);
+    }
+    for (auto& slot : slots) {
+        slot.blocked = map.getTile(slot.tileX, slot.tileY) == TileType::Wall;
+    }
+    resetOccupancy();
+}
+
+void SpawnSlotTracker::resetOccupancy() {
+    freeSlots.clear();
+    for (size_t i = 0; i < slots.size(); ++i) {
+        // Блокировка стеной переживает сброс занятости танками
+        Slot& slot = slots[i];
+        slot.occupants = slot.blocked ? 1 : 0;
+        slot.freeIndex = -1;
+        if (slot.occupants == 0) {
+            slot.freeIndex = static_cast<int>(freeSlots.size());
+            freeSlots.push_back(static_cast<int>(i));
+        }
+    }
+}
+
+void SpawnSlotTracker::tankAdded(float x, float y) {
+    adjustOccupancy(x, y, +1);
+}
+
+void SpawnSlotTracker::tankMoved(float oldX, float oldY, float newX, float newY) {
+    adjustOccupancy(oldX, oldY, -1);
+    adjustOccupancy(newX, newY, +1);
+}
+
+void SpawnSlotTracker::tankRemoved(float x, float y) {
+    adjustOccupancy(x, y, -1);
+}
+
+void SpawnSlotTracker::tileChanged(int x, int y, TileType tile) {
+    auto it = slotByTile.find(tileKey(x, y));
+    if (it == slotByTile.end()) {
+        return;
+    }
+    bool blocked = tile == TileType::Wall;
+    if (slots[it->second].blocked != blocked) {
+        slots[it->second].blocked = blocked;
+        changeSlot(it->second, blocked ? +1 : -1);
+    }
+}
+
+void SpawnSlotTracker::adjustOccupancy(float x, float y, int delta) {
+    if (slots.empty()) {
+        return;
+    }
+    // Бокс точки лежит внутри ее тайла, поэтому перекрыть точку могут
+    // только тайлы под боксом танка - не больше 2x2
+    const int tileX0 = static_cast<int>(std::floor(x / tileSize));
+    const int tileY0 = static_cast<int>(std::floor(y / tileSize));
+    const int tileX1 = static_cast<int>(std::floor((x + tankSize) / tileSize));
+    const int tileY1 = static_cast<int>(std::floor((y + tankSize) / tileSize));
+    for (int ty = tileY0; ty <= tileY1; ++ty) {
+        for (int tx = tileX0; tx <= tileX1; ++tx) {
+            auto it = slotByTile.find(tileKey(tx, ty));
+            if (it == slotByTile.end()) continue;
+            const Slot& slot = slots[it->second];
+            if (x + tankSize > slot.x && x < slot.x + tankSize &&
+                y + tankSize > slot.y && y < slot.y + tankSize) {
+                changeSlot(it->second, delta);
+            }
+        }
+    }
+}
+
+void SpawnSlotTracker::changeSlot(int slotIndex, int delta) {
+    Slot& slot = slots[slotIndex];
+    bool wasFree = slot.occupants == 0;
+    slot.occupants += delta;
+    bool isFree = slot.occupants == 0;
+
+    if (wasFree && !isFree) {
+        // Удаляем из массива свободных заменой на последний элемент
+        int last = freeSlots.back();
+        freeSlots[slot.freeIndex] = last;
+        slots[last].freeIndex = slot.freeIndex;
+        freeSlots.pop_back();
+        slot.freeIndex = -1;
+    } else if (!wasFree && isFree) {
+        slot.freeIndex = static_cast<int>(freeSlots.size());
+        freeSlots.push_back(slotIndex);
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "GameMap.h"
+#include <vector>
+#include <utility>
+#include <unordered_map>
+#include <cstdint>
+#include <algorithm>
+
+// Учет занятости точек появления врагов.
+// Для каждой точки хранится число танков, чей бокс ее перекрывает; счетчики
+// обновляются инкрементально при появлении, перемещении и гибели танков.
+// Свободные точки лежат в отдельном массиве, поэтому случайная свободная
+// точка выбирается за O(1) без перебора объектов.
+class SpawnSlotTracker {
+public:
+    void build(const GameMap& map, float tileSize, float tankSize);
+    void resetOccupancy();
+
+    void tankAdded(float x, float y);
+    void tankMoved(float oldX, float oldY, float newX, float newY);
+    void tankRemoved(float x, float y);
+    void tileChanged(int x, int y, TileType tile); // Стена на точке появления блокирует ее
+
+    // Выбирает до count разных свободных точек; возвращает позиции танков для них.
+    // randomValue - источник случайных чисел вида uint32_t(), outPositions - вектор пар (x, y)
+    // с любым аллокатором
+    template <typename Random, typename PositionList>
+    void pickFreeSlots(int count, Random& randomValue, PositionList& outPositions);
+
+    size_t getSlotCount() const { return slots.size(); }
+    size_t getFreeSlotCount() const { return freeSlots.size(); }
+
+private:
+    struct Slot {
+        int tileX, tileY;
+        float x, y;          // Позиция танка, появляющегося в этой точке
+        int occupants = 0;   // Танки, перекрывающие точку (+1, если на ней стена)
+        bool blocked = false; // На точке стоит стена
+        int freeIndex = -1;  // Позиция в freeSlots или -1
+    };
+
+    void adjustOccupancy(float x, float y, int delta);
+    void changeSlot(int slotIndex, int delta);
+
+    std::vector<Slot> slots;
+    std::vector<int> freeSlots;
+    std::unordered_map<int64_t, int> slotByTile;
+    float tileSize = 1.0f;
+    float tankSize = 1.0f;
+};
+
+template <typename Random, typename PositionList>
+void SpawnSlotTracker::pickFreeSlots(int count, Random& randomValue, PositionList& outPositions) {
+    // Частичная перетасовка Фишера-Йетса прямо в массиве свободных точек:
+    // порядок в нем не важен, важны только обратные индексы
+    int available = static_cast<int>(freeSlots.size());
+    count = std::min(count, available);
+    for (int i = 0; i < count; ++i) {
+        int j = i + static_cast<int>(static_cast<uint32_t>(randomValue()) % static_cast<uint32_t>(available - i));
+        std::swap(freeSlots[i], freeSlots[j]);
+        slots[freeSlots[i]].freeIndex = i;
+        slots[freeSlots[j]].freeIndex = j;
+        const Slot& slot = slots[freeSlots[i]];
+        outPositions.push_back({slot.x, slot.y});
+    }
+}
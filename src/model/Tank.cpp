@@ -22,3 +22,11 @@ void Tank::fire() {
       timeSinceLastShot = 0.0f;
   }
 }
+
+void Tank::restoreState(int newHealth, int newMaxHealth, float newSpeed, float newReloadTime, float newTimeSinceLastShot) {
+  health = newHealth;
+  maxHealth = newMaxHealth;
+  speed = FixedPoint::quantize(newSpeed);
+  reloadTime = newReloadTime;
+  timeSinceLastShot = newTimeSinceLastShot;
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "../model/GameObject.h"
 #include "../common/Direction.h"
+#include <cstdint>
 
 class Tank : public GameObject {
 public:
@@ -18,16 +19,31 @@ public:
   Direction getDirection() const { return direction; }
   void setDirection(Direction newDir) { direction = newDir; }
   bool isPlayer() const { return player; }
+  int getPlayerSlot() const { return playerSlot; } // Номер игрока в сетевой игре, -1 у врагов
+  void setPlayerSlot(int slot) { playerSlot = slot; }
   int getHealth() const { return health; }
   int getMaxHealth() const { return maxHealth; }
   float getSpeed() const { return speed; }
+  float getReloadTime() const { return reloadTime; }
+  float getTimeSinceLastShot() const { return timeSinceLastShot; }
+
+  // Восстановление из сохранения
+  void restoreState(int newHealth, int newMaxHealth, float newSpeed, float newReloadTime, float newTimeSinceLastShot);
+
+  // Планировщик ИИ (в снимки не входит): тик последнего решения и ход, отложенный из-за бюджета
+  uint64_t getAiTick() const { return aiTick; }
+  bool isAiPending() const { return aiPending; }
+  void setAiState(uint64_t tick, bool pending) { aiTick = tick; aiPending = pending; }
 
 private:
   Direction direction;
   bool player;
+  int playerSlot = -1;
   int health;
   int maxHealth;
   float speed;
   float reloadTime; // Time in seconds between shots
   float timeSinceLastShot; // Time elapsed since last shot
+  uint64_t aiTick = 0;
+  bool aiPending = false;
 };
@@ -0,0 +1,103 @@
+#include "TankBroadphase.h"
+#include <algorithm>
+#include <cmath>
+
+TankBroadphase::TankBroadphase(float tankSize) : tankSize(tankSize) {}
+
+void TankBroadphase::clear() {
+    entries.clear();
+}
+
+void TankBroadphase::insert(Tank* tank) {
+    Entry entry{tank->getX(), tank};
+    auto it = std::upper_bound(entries.begin(), entries.end(), entry.minX,
+                               [](float x, const Entry& e) { return x < e.minX; });
+    entries.insert(it, entry);
+}
+
+void TankBroadphase::removeDestroyed() {
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [](const Entry& e) { return e.tank->isDestroyed(); }),
+                  entries.end());
+}
+
+void TankBroadphase::tankMoved(const Tank* tank, float oldX) {
+    // Ищем запись по старому ключу, затем сдвигаем ее на новое место вставками
+    auto it = std::lower_bound(entries.begin(), entries.end(), oldX,
+                               [](const Entry& e, float x) { return e.minX < x; });
+    while (it != entries.end() && it->tank != tank) {
+        ++it;
+    }
+    if (it == entries.end()) {
+        return;
+    }
+
+    size_t i = static_cast<size_t>(it - entries.begin());
+    entries[i].minX = tank->getX();
+    while (i > 0 && entries[i - 1].minX > entries[i].minX) {
+        std::swap(entries[i - 1], entries[i]);
+        --i;
+    }
+    while (i + 1 < entries.size() && entries[i + 1].minX < entries[i].minX) {
+        std::swap(entries[i + 1], entries[i]);
+        ++i;
+    }
+}
+
+size_t TankBroadphase::collectAlive(Tank** outTanks) const {
+    size_t count = 0;
+    for (const Entry& entry : entries) {
+        if (!entry.tank->isDestroyed()) {
+            outTanks[count++] = entry.tank;
+        }
+    }
+    return count;
+}
+
+size_t TankBroadphase::firstCandidate(float x) const {
+    // Бокс танка пересекает x только если его левый край правее x - tankSize
+    auto it = std::upper_bound(entries.begin(), entries.end(), x - tankSize,
+                               [](float value, const Entry& e) { return value < e.minX; });
+    return static_cast<size_t>(it - entries.begin());
+}
+
+void TankBroadphase::queryOverlaps(float x, float y, float width, float height, const Tank* exclude,
+                                   std::vector<Tank*>& outTanks) const {
+    const float right = x + width;
+    const float bottom = y + height;
+    for (size_t i = firstCandidate(x); i < entries.size() && entries[i].minX < right; ++i) {
+        Tank* tank = entries[i].tank;
+        if (tank == exclude || tank->isDestroyed()) continue;
+        if (tank->getY() < bottom && tank->getY() + tankSize > y) {
+            outTanks.push_back(tank);
+        }
+    }
+}
+
+bool TankBroadphase::anyOverlap(float x, float y, float width, float height, const Tank* exclude) const {
+    const float right = x + width;
+    const float bottom = y + height;
+    for (size_t i = firstCandidate(x); i < entries.size() && entries[i].minX < right; ++i) {
+        const Tank* tank = entries[i].tank;
+        if (tank == exclude || tank->isDestroyed()) continue;
+        if (tank->getY() < bottom && tank->getY() + tankSize > y) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TankBroadphase::findPairs(FrameVector<std::pair<Tank*, Tank*>>& outPairs) const {
+    for (size_t i = 0; i < entries.size(); ++i) {
+        Tank* first = entries[i].tank;
+        if (first->isDestroyed()) continue;
+        const float right = entries[i].minX + tankSize;
+        for (size_t j = i + 1; j < entries.size() && entries[j].minX < right; ++j) {
+            Tank* second = entries[j].tank;
+            if (second->isDestroyed()) continue;
+            if (std::fabs(first->getY() - second->getY()) < tankSize) {
+                outPairs.push_back({first, second});
+            }
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "Tank.h"
+#include "../common/FrameArena.h"
+#include <vector>
+#include <utility>
+
+// Широкая фаза столкновений танков: sort-and-sweep по оси X.
+// Танки хранятся отсортированными по левому краю; порядок поддерживается
+// инкрементально при каждом перемещении, поэтому между тиками сортировка
+// почти ничего не стоит, а поиск соседей - это бинарный поиск и короткий проход.
+class TankBroadphase {
+public:
+    explicit TankBroadphase(float tankSize);
+
+    void clear();
+    void insert(Tank* tank);
+    void removeDestroyed();
+    void tankMoved(const Tank* tank, float oldX); // Вызывать после каждого изменения позиции танка
+
+    // Живые танки, чей бокс пересекается с [x, x + width) x [y, y + height)
+    void queryOverlaps(float x, float y, float width, float height, const Tank* exclude,
+                       std::vector<Tank*>& outTanks) const;
+    bool anyOverlap(float x, float y, float width, float height, const Tank* exclude) const;
+
+    // Пары живых танков с пересекающимися боксами
+    void findPairs(FrameVector<std::pair<Tank*, Tank*>>& outPairs) const;
+
+    // Живые танки по возрастанию левого края; outTanks вмещает size() записей.
+    // Возвращает их число
+    size_t collectAlive(Tank** outTanks) const;
+
+    size_t size() const { return entries.size(); }
+
+private:
+    struct Entry {
+        float minX;
+        Tank* tank;
+    };
+
+    size_t firstCandidate(float x) const; // Первая запись, которая может пересекаться с x
+
+    std::vector<Entry> entries;
+    float tankSize;
+};
@@ -0,0 +1,165 @@
+#include "TankHitKernel.h"
+#include "SimdTarget.h"
+#include <algorithm>
+
+namespace {
+
+constexpr size_t LANES = 8; // Шаг дополнения массивов - ширина AVX2
+
+struct BulletBox {
+    float left;
+    float right;
+    float top;
+    float bottom;
+};
+
+// Номер младшего установленного бита
+inline int lowestBit(int bits) {
+    int index = 0;
+    while (!(bits & 1)) {
+        bits >>= 1;
+        ++index;
+    }
+    return index;
+}
+
+int findHitScalar(const float* minX, const float* minY, const float* maxX, const float* maxY,
+                  const uint32_t* sides, size_t count, const BulletBox& box, uint32_t targets) {
+    for (size_t i = 0; i < count; ++i) {
+        if ((sides[i] & targets) && box.right > minX[i] && box.left < maxX[i] &&
+            box.bottom > minY[i] && box.top < maxY[i]) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+#ifdef ARCADE_X86
+
+int findHitSse2(const float* minX, const float* minY, const float* maxX, const float* maxY,
+                const uint32_t* sides, size_t count, const BulletBox& box, uint32_t targets) {
+    const __m128 left = _mm_set1_ps(box.left);
+    const __m128 right = _mm_set1_ps(box.right);
+    const __m128 top = _mm_set1_ps(box.top);
+    const __m128 bottom = _mm_set1_ps(box.bottom);
+    const __m128i targetMask = _mm_set1_epi32(static_cast<int>(targets));
+    const __m128i zero = _mm_setzero_si128();
+    for (size_t i = 0; i < count; i += 4) {
+        __m128 overlap = _mm_and_ps(
+            _mm_and_ps(_mm_cmpgt_ps(right, _mm_loadu_ps(minX + i)), _mm_cmplt_ps(left, _mm_loadu_ps(maxX + i))),
+            _mm_and_ps(_mm_cmpgt_ps(bottom, _mm_loadu_ps(minY + i)), _mm_cmplt_ps(top, _mm_loadu_ps(maxY + i))));
+        __m128i sideBits = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sides + i)), targetMask);
+        __m128i enemy = _mm_xor_si128(_mm_cmpeq_epi32(sideBits, zero), _mm_set1_epi32(-1));
+        int bits = _mm_movemask_ps(_mm_and_ps(overlap, _mm_castsi128_ps(enemy)));
+        if (bits) {
+            return static_cast<int>(i) + lowestBit(bits);
+        }
+    }
+    return -1;
+}
+
+ARCADE_TARGET_AVX2
+int findHitAvx2(const float* minX, const float* minY, const float* maxX, const float* maxY,
+                const uint32_t* sides, size_t count, const BulletBox& box, uint32_t targets) {
+    const __m256 left = _mm256_set1_ps(box.left);
+    const __m256 right = _mm256_set1_ps(box.right);
+    const __m256 top = _mm256_set1_ps(box.top);
+    const __m256 bottom = _mm256_set1_ps(box.bottom);
+    const __m256i targetMask = _mm256_set1_epi32(static_cast<int>(targets));
+    const __m256i zero = _mm256_setzero_si256();
+    for (size_t i = 0; i < count; i += 8) {
+        __m256 overlap = _mm256_and_ps(
+            _mm256_and_ps(_mm256_cmp_ps(right, _mm256_loadu_ps(minX + i), _CMP_GT_OQ),
+                          _mm256_cmp_ps(left, _mm256_loadu_ps(maxX + i), _CMP_LT_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(bottom, _mm256_loadu_ps(minY + i), _CMP_GT_OQ),
+                          _mm256_cmp_ps(top, _mm256_loadu_ps(maxY + i), _CMP_LT_OQ)));
+        __m256i sideBits = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(sides + i)), targetMask);
+        __m256i enemy = _mm256_xor_si256(_mm256_cmpeq_epi32(sideBits, zero), _mm256_set1_epi32(-1));
+        int bits = _mm256_movemask_ps(_mm256_and_ps(overlap, _mm256_castsi256_ps(enemy)));
+        if (bits) {
+            return static_cast<int>(i) + lowestBit(bits);
+        }
+    }
+    return -1;
+}
+
+#endif // ARCADE_X86
+
+} // namespace
+
+TankHitKernel::TankHitKernel(float tankSize) : tankSize(tankSize), kernel(BulletArray::getBestKernel()) {}
+
+void TankHitKernel::setKernel(BulletArray::Kernel newKernel) {
+    BulletArray::Kernel best = BulletArray::getBestKernel();
+    kernel = static_cast<int>(newKernel) <= static_cast<int>(best) ? newKernel : best;
+}
+
+void TankHitKernel::clear() {
+    tanks.clear();
+    minX.clear();
+    minY.clear();
+    maxX.clear();
+    maxY.clear();
+    sides.clear();
+}
+
+void TankHitKernel::pack(Tank* const* candidates, size_t count) {
+    clear();
+    tanks.assign(candidates, candidates + count);
+    const size_t padded = (count + LANES - 1) / LANES * LANES + LANES;
+    minX.resize(padded, 0.0f);
+    minY.resize(padded, 0.0f);
+    maxX.resize(padded, 0.0f);
+    maxY.resize(padded, 0.0f);
+    sides.resize(padded, 0);
+    for (size_t i = 0; i < count; ++i) {
+        const Tank* tank = candidates[i];
+        minX[i] = tank->getX();
+        minY[i] = tank->getY();
+        maxX[i] = tank->getX() + tankSize;
+        maxY[i] = tank->getY() + tankSize;
+        sides[i] = tank->isDestroyed() ? 0 : sideOf(*tank);
+    }
+}
+
+int TankHitKernel::findHit(float x, float y, float radius, uint32_t targetSides) const {
+    return findHit(x, y, radius, targetSides, 0, tanks.size());
+}
+
+int TankHitKernel::findHit(float x, float y, float radius, uint32_t targetSides, size_t first, size_t last) const {
+    if (first >= last) {
+        return -1;
+    }
+    const BulletBox box{x - radius, x + radius, y - radius, y + radius};
+    const size_t count = last - first;
+    int hit = -1;
+    // Векторные ядра дочитывают хвост до кратного ширине - дополнение массивов
+    // это допускает, а попадания за last отбрасываются ниже
+    switch (kernel) {
+#ifdef ARCADE_X86
+        case BulletArray::Kernel::AVX2:
+            hit = findHitAvx2(minX.data() + first, minY.data() + first, maxX.data() + first, maxY.data() + first,
+                              sides.data() + first, count, box, targetSides);
+            break;
+        case BulletArray::Kernel::SSE2:
+            hit = findHitSse2(minX.data() + first, minY.data() + first, maxX.data() + first, maxY.data() + first,
+                              sides.data() + first, count, box, targetSides);
+            break;
+#endif
+        default:
+            hit = findHitScalar(minX.data() + first, minY.data() + first, maxX.data() + first, maxY.data() + first,
+                                sides.data() + first, count, box, targetSides);
+            break;
+    }
+    return hit < 0 || static_cast<size_t>(hit) >= count ? -1 : hit + static_cast<int>(first);
+}
+
+void TankHitKernel::candidatesNear(float left, float right, size_t& first, size_t& last) const {
+    // Бокс кандидата пересекает [left, right) только при minX в (left - tankSize, right).
+    // Полоса расширена на единицу, чтобы округление не отсекло касание - точную
+    // проверку все равно делает ядро
+    auto begin = minX.begin();
+    auto end = minX.begin() + static_cast<std::ptrdiff_t>(tanks.size());
+    first = static_cast<size_t>(std::upper_bound(begin, end, left - tankSize - 1.0f) - begin);
+    last = static_cast<size_t>(std::lower_bound(begin + static_cast<std::ptrdiff_t>(first), end, right + 1.0f) - begin);
+}
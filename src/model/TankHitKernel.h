@@ -0,0 +1,58 @@
+#pragma once
+#include "BulletArray.h"
+#include "Tank.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Узкая фаза пуля-танк. Боксы кандидатов из любого списка (все танки, выдача
+// TankBroadphase) упаковываются в массивы вместе с маской стороны, и одна пуля
+// проверяется сразу против 8 (AVX2) или 4 (SSE2) танков без ветвлений:
+// дружественный огонь отсекается той же маской. Результат - номер кандидата в
+// исходном списке; при нескольких пересечениях берется наименьший, поэтому урон
+// применяется в детерминированном порядке независимо от ядра.
+// Если кандидаты упакованы по возрастанию левого края (порядок TankBroadphase),
+// пулю достаточно проверить против полосы candidatesNear, а не всего списка
+class TankHitKernel {
+public:
+    // Стороны танков - биты маски цели
+    static constexpr uint32_t PLAYER_SIDE = 1;
+    static constexpr uint32_t ENEMY_SIDE = 2;
+
+    explicit TankHitKernel(float tankSize);
+
+    // Кандидаты в порядке приоритета. Уничтоженные танки целями не становятся
+    void pack(Tank* const* candidates, size_t count);
+    void clear();
+
+    // Первый кандидат стороны из targetSides, чей бокс пересекается с квадратом пули, или -1
+    int findHit(float x, float y, float radius, uint32_t targetSides) const;
+    // То же среди кандидатов [first, last)
+    int findHit(float x, float y, float radius, uint32_t targetSides, size_t first, size_t last) const;
+    // Полоса [first, last) кандидатов, чей бокс может пересечь [left, right) по X.
+    // Требует упаковки по возрастанию левого края
+    void candidatesNear(float left, float right, size_t& first, size_t& last) const;
+    // Кандидат перестает быть целью (танк уничтожен в этом же проходе)
+    void disable(int index) { sides[index] = 0; }
+
+    Tank* getTank(int index) const { return tanks[index]; }
+    size_t size() const { return tanks.size(); }
+
+    static uint32_t sideOf(const Tank& tank) { return tank.isPlayer() ? PLAYER_SIDE : ENEMY_SIDE; }
+    static uint32_t targetsOf(bool fromPlayer) { return fromPlayer ? ENEMY_SIDE : PLAYER_SIDE; }
+
+    BulletArray::Kernel getKernel() const { return kernel; }
+    void setKernel(BulletArray::Kernel newKernel); // Как BulletArray::setKernel
+
+private:
+    float tankSize;
+    std::vector<Tank*> tanks;
+    // Массивы дополнены пустыми записями со стороной 0, чтобы проход по 8 с любого
+    // начала полосы не выходил за их конец
+    std::vector<float> minX;
+    std::vector<float> minY;
+    std::vector<float> maxX;
+    std::vector<float> maxY;
+    std::vector<uint32_t> sides;
+    BulletArray::Kernel kernel;
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include "FixedPoint.h"
+#include <bit>
+
+// Геометрия мира, известная при компиляции: размер тайла, танка и радиус пули в пикселях.
+// Для размера тайла - степени двойки деление заменяется умножением на точную обратную
+// величину, для остальных размеров остается деление в float. В режиме фиксированной
+// точки номер тайла считается в целых: для степени двойки это сдвиг
+template <int TileSize, int TankSize, int BulletRadius>
+struct TileGeometry {
+    static_assert(TileSize > 0 && TankSize > 0 && BulletRadius > 0, "размеры должны быть положительными");
+
+    static constexpr float TILE_SIZE = static_cast<float>(TileSize);
+    static constexpr float TANK_SIZE = static_cast<float>(TankSize);
+    static constexpr float BULLET_RADIUS = static_cast<float>(BulletRadius);
+
+    static constexpr bool POWER_OF_TWO_TILES = std::has_single_bit(static_cast<unsigned>(TileSize));
+    static constexpr FixedPoint::Units TILE_UNITS = TileSize * FixedPoint::ONE;
+    static constexpr int TILE_UNIT_SHIFT = std::countr_zero(static_cast<unsigned>(TILE_UNITS));
+
+    // Тайл координаты с округлением к нулю, как у static_cast<int>(coord / TILE_SIZE).
+    // В режиме фиксированной точки - вниз; координаты левее и выше карты проверяются до вызова
+    static int tileOf(float coord) {
+        if constexpr (FixedPoint::ENABLED) {
+            return tileOfUnits(FixedPoint::fromFloat(coord));
+        } else if constexpr (POWER_OF_TWO_TILES) {
+            // Умножение на обратную степень двойки точное, результат совпадает с делением бит в бит.
+            // Сдвиг целой координаты оказался медленнее: лишние преобразование и поправка знака
+            return static_cast<int>(coord * (1.0f / TILE_SIZE));
+        } else {
+            return static_cast<int>(coord / TILE_SIZE);
+        }
+    }
+
+    // Последний тайл, который задевает отрезок, заканчивающийся в end (сам end не входит)
+    static int lastTileBefore(float end) {
+        if constexpr (FixedPoint::ENABLED) {
+            return tileOfUnits(FixedPoint::fromFloat(end) - 1); // Последняя доля пикселя, без эпсилона
+        } else {
+            return tileOf(end - 0.001f);
+        }
+    }
+
+    static int tileOfUnits(FixedPoint::Units units) {
+        if constexpr (POWER_OF_TWO_TILES) {
+            return units >> TILE_UNIT_SHIFT;
+        } else {
+            return units >= 0 ? units / TILE_UNITS : -((TILE_UNITS - 1 - units) / TILE_UNITS);
+        }
+    }
+};
+
+// Геометрия игры
+using GameGeometry = TileGeometry<40, 36, 3>;
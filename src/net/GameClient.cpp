@@ -0,0 +1,269 @@
+#include "GameClient.h"
+#include "../common/ByteStream.h"
+#include "../model/GameMap.h"
+#include "../model/GameModel.h"
+#include "../model/SnapshotDelta.h"
+#include <algorithm>
+#include <cmath>
+
+using NetProtocol::PacketType;
+
+GameClient::~GameClient() {
+    disconnect();
+}
+
+bool GameClient::connect(const NetAddress& server, const GameMap& map, double timeoutSeconds) {
+    disconnect();
+    if (!socket.open()) {
+        return false;
+    }
+    serverAddress = server;
+    emptyWorld = GameSnapshot{};
+    emptyWorld.mapWidth = map.getWidth();
+    emptyWorld.mapHeight = map.getHeight();
+    states.clear();
+    assemblies.clear();
+    clockValid = false;
+    inputSequence = 0;
+    receiveBuffer.resize(NetProtocol::MAX_PACKET_SIZE * 2);
+
+    NetProtocol::writeHeader(packet, PacketType::Connect);
+    ByteWriter(packet).u32(NetProtocol::mapChecksum(map));
+    std::vector<uint8_t> request = packet;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeoutSeconds);
+    while (std::chrono::steady_clock::now() < deadline) {
+        // Запрос повторяется: UDP может его потерять
+        send(request);
+        if (!socket.waitReadable(100)) {
+            continue;
+        }
+        NetAddress from;
+        int size;
+        while ((size = socket.receiveFrom(receiveBuffer.data(), receiveBuffer.size(), from)) >= 0) {
+            PacketType type;
+            if (from != serverAddress || !NetProtocol::readHeader(receiveBuffer.data(), size, type)) {
+                continue;
+            }
+            stats.bytesReceived += static_cast<uint64_t>(size);
+            if (type == PacketType::Reject) {
+                socket.close();
+                return false;
+            }
+            if (type == PacketType::Accept) {
+                ByteReader in(receiveBuffer.data() + NetProtocol::PACKET_HEADER_SIZE,
+                              size - NetProtocol::PACKET_HEADER_SIZE);
+                int slot = in.u8();
+                if (!in.ok()) {
+                    continue;
+                }
+                playerSlot = slot;
+                connected = true;
+                lastHeard = std::chrono::steady_clock::now();
+                return true;
+            }
+        }
+    }
+    socket.close();
+    return false;
+}
+
+void GameClient::disconnect() {
+    if (connected) {
+        NetProtocol::writeHeader(packet, PacketType::Disconnect);
+        send(packet);
+    }
+    connected = false;
+    playerSlot = -1;
+    socket.close();
+}
+
+void GameClient::sendInput(const PlayerInput& input) {
+    if (!connected) {
+        return;
+    }
+    NetProtocol::writeHeader(packet, PacketType::Input);
+    ByteWriter out(packet);
+    out.u32(++inputSequence);
+    out.u8(states.empty() ? 0 : 1);
+    out.u64(states.empty() ? 0 : states.back().tick);
+    out.u8(NetProtocol::packInput(input));
+    send(packet);
+}
+
+void GameClient::poll() {
+    if (!connected) {
+        return;
+    }
+    NetAddress from;
+    int size;
+    while ((size = socket.receiveFrom(receiveBuffer.data(), receiveBuffer.size(), from)) >= 0) {
+        PacketType type;
+        if (from != serverAddress || !NetProtocol::readHeader(receiveBuffer.data(), size, type)) {
+            continue;
+        }
+        stats.bytesReceived += static_cast<uint64_t>(size);
+        lastHeard = std::chrono::steady_clock::now();
+        if (type == PacketType::Snapshot) {
+            handleSnapshotFragment(receiveBuffer.data(), static_cast<size_t>(size));
+        } else if (type == PacketType::Disconnect) {
+            connected = false;
+            return;
+        }
+    }
+    if (std::chrono::steady_clock::now() - lastHeard > std::chrono::duration<double>(SERVER_TIMEOUT)) {
+        connected = false;
+    }
+}
+
+void GameClient::handleSnapshotFragment(const uint8_t* data, size_t size) {
+    ByteReader in(data + NetProtocol::PACKET_HEADER_SIZE, size - NetProtocol::PACKET_HEADER_SIZE);
+    NetProtocol::SnapshotFragmentHeader header;
+    header.tick = in.u64();
+    header.baseTick = in.u64();
+    header.hasBase = in.u8() != 0;
+    header.fragmentIndex = in.u16();
+    header.fragmentCount = in.u16();
+    header.totalSize = in.u32();
+    size_t offset = static_cast<size_t>(header.fragmentIndex) * NetProtocol::MAX_FRAGMENT_SIZE;
+    if (!in.ok() || header.fragmentCount == 0 || header.fragmentCount > NetProtocol::MAX_FRAGMENTS ||
+        header.fragmentIndex >= header.fragmentCount ||
+        header.totalSize > static_cast<size_t>(header.fragmentCount) * NetProtocol::MAX_FRAGMENT_SIZE ||
+        offset + in.remaining() > header.totalSize) {
+        return;
+    }
+
+    auto it = std::find_if(assemblies.begin(), assemblies.end(), [&](const Assembly& a) {
+        return a.header.tick == header.tick && a.header.baseTick == header.baseTick &&
+               a.header.hasBase == header.hasBase && a.header.totalSize == header.totalSize;
+    });
+    if (it == assemblies.end()) {
+        // Незавершенные сборки старых снимков уже не нужны
+        if (assemblies.size() >= 8) {
+            assemblies.erase(assemblies.begin());
+        }
+        Assembly assembly;
+        assembly.header = header;
+        assembly.data.resize(header.totalSize);
+        assembly.received.assign(header.fragmentCount, false);
+        assemblies.push_back(std::move(assembly));
+        it = assemblies.end() - 1;
+    }
+    if (it->received[header.fragmentIndex]) {
+        return;
+    }
+    in.bytes(it->data.data() + offset, in.remaining());
+    it->received[header.fragmentIndex] = true;
+    if (++it->receivedCount == header.fragmentCount) {
+        Assembly complete = std::move(*it);
+        assemblies.erase(it);
+        completeSnapshot(complete);
+    }
+}
+
+void GameClient::completeSnapshot(const Assembly& assembly) {
+    const auto& header = assembly.header;
+    if (!states.empty() && header.tick <= states.back().tick) {
+        // Полный снимок намного старше последнего - сервер начал новую партию,
+        // иначе это просто пакет, пришедший не по порядку
+        if (header.hasBase || header.tick + NetProtocol::TICK_RATE > states.back().tick) {
+            return;
+        }
+        states.clear();
+        clockValid = false;
+    }
+
+    GameSnapshot state;
+    if (header.hasBase) {
+        auto base = std::find_if(states.begin(), states.end(),
+                                 [&](const GameSnapshot& s) { return s.tick == header.baseTick; });
+        if (base == states.end()) {
+            ++stats.snapshotsDropped;
+            return;
+        }
+        state = *base;
+    } else {
+        state = emptyWorld;
+    }
+    if (!SnapshotDelta::apply(assembly.data.data(), assembly.data.size(), state) || state.tick != header.tick ||
+        state.mapWidth != emptyWorld.mapWidth || state.mapHeight != emptyWorld.mapHeight) {
+        ++stats.snapshotsDropped;
+        return;
+    }
+
+    states.push_back(std::move(state));
+    if (states.size() > STATE_HISTORY) {
+        states.pop_front();
+    }
+    ++stats.snapshotsReceived;
+    updateClock(header.tick);
+}
+
+void GameClient::updateClock(uint64_t serverTick) {
+    double localTicks = std::chrono::duration<double>(std::chrono::steady_clock::now() - clockOrigin).count() *
+                        NetProtocol::TICK_RATE;
+    double sample = static_cast<double>(serverTick) - localTicks;
+    if (!clockValid || std::abs(sample - clockOffset) > NetProtocol::TICK_RATE) {
+        clockOffset = sample;
+        clockValid = true;
+    } else {
+        // Сглаживаем дрожание доставки; вперед подтягиваемся быстрее, чем назад
+        clockOffset += (sample - clockOffset) * (sample > clockOffset ? 0.1 : 0.01);
+    }
+}
+
+double GameClient::estimatedServerTick() const {
+    double localTicks = std::chrono::duration<double>(std::chrono::steady_clock::now() - clockOrigin).count() *
+                        NetProtocol::TICK_RATE;
+    return localTicks + clockOffset;
+}
+
+bool GameClient::getInterpolatedState(GameSnapshot& outState) const {
+    if (states.empty()) {
+        return false;
+    }
+    double renderTick = estimatedServerTick() - INTERPOLATION_DELAY_TICKS;
+    if (states.size() == 1 || renderTick >= static_cast<double>(states.back().tick)) {
+        outState = states.back();
+        return true;
+    }
+    if (renderTick <= static_cast<double>(states.front().tick)) {
+        outState = states.front();
+        return true;
+    }
+    size_t next = 1;
+    while (static_cast<double>(states[next].tick) < renderTick) {
+        ++next;
+    }
+    const GameSnapshot& from = states[next - 1];
+    const GameSnapshot& to = states[next];
+    float t = static_cast<float>((renderTick - from.tick) / static_cast<double>(to.tick - from.tick));
+
+    // Берем более новый снимок и сдвигаем назад позиции объектов, которые есть в обоих.
+    // Списки упорядочены по id; скачок больше двух тайлов (возрождение) не сглаживаем
+    outState = to;
+    constexpr float MAX_LERP_DISTANCE = GameModel::TILE_SIZE * 2;
+    size_t i = 0;
+    for (auto& object : outState.objects) {
+        while (i < from.objects.size() && from.objects[i].id < object.id) {
+            ++i;
+        }
+        if (i == from.objects.size()) {
+            break;
+        }
+        const auto& previous = from.objects[i];
+        if (previous.id != object.id || std::abs(object.x - previous.x) > MAX_LERP_DISTANCE ||
+            std::abs(object.y - previous.y) > MAX_LERP_DISTANCE) {
+            continue;
+        }
+        object.x = previous.x + (object.x - previous.x) * t;
+        object.y = previous.y + (object.y - previous.y) * t;
+    }
+    return true;
+}
+
+void GameClient::send(const std::vector<uint8_t>& data) {
+    if (socket.sendTo(serverAddress, data.data(), data.size())) {
+        stats.bytesSent += data.size();
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "NetProtocol.h"
+#include "UdpSocket.h"
+#include "../model/GameSnapshot.h"
+#include "../model/PlayerInput.h"
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+class GameMap;
+
+// Клиент сетевой игры: отправляет управление, собирает снимки сервера из фрагментов,
+// восстанавливает их из дельт и отдает состояние, интерполированное между двумя снимками.
+// Предсказания на клиенте нет: свой танк тоже показывается с задержкой интерполяции
+class GameClient {
+public:
+    struct Stats {
+        uint64_t bytesSent = 0;
+        uint64_t bytesReceived = 0;
+        uint64_t snapshotsReceived = 0;
+        uint64_t snapshotsDropped = 0; // Не нашлось базы для дельты или данные повреждены
+    };
+
+    ~GameClient();
+
+    // Подключение к серверу с той же картой; ждет ответа не дольше timeoutSeconds
+    bool connect(const NetAddress& server, const GameMap& map, double timeoutSeconds = 3.0);
+    void disconnect();
+    bool isConnected() const { return connected; }
+    int getPlayerSlot() const { return playerSlot; }
+
+    void sendInput(const PlayerInput& input);
+    void poll(); // Разбирает все пришедшие пакеты
+
+    bool hasState() const { return !states.empty(); }
+    const GameSnapshot& getLatestState() const { return states.back(); }
+    // Состояние на момент "сейчас минус задержка интерполяции"
+    bool getInterpolatedState(GameSnapshot& outState) const;
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    static constexpr size_t STATE_HISTORY = 64;   // Принятых снимков, пригодных как база дельты
+    static constexpr double INTERPOLATION_DELAY_TICKS = 6.0;
+    static constexpr double SERVER_TIMEOUT = 5.0;
+
+    struct Assembly {
+        NetProtocol::SnapshotFragmentHeader header;
+        std::vector<uint8_t> data;
+        std::vector<bool> received;
+        uint16_t receivedCount = 0;
+    };
+
+    void handleSnapshotFragment(const uint8_t* data, size_t size);
+    void completeSnapshot(const Assembly& assembly);
+    void updateClock(uint64_t serverTick);
+    double estimatedServerTick() const;
+    void send(const std::vector<uint8_t>& data);
+
+    UdpSocket socket;
+    NetAddress serverAddress;
+    bool connected = false;
+    int playerSlot = -1;
+    uint32_t inputSequence = 0;
+    std::chrono::steady_clock::time_point lastHeard;
+
+    GameSnapshot emptyWorld;
+    std::deque<GameSnapshot> states; // По возрастанию тика
+    std::vector<Assembly> assemblies; // Снимки, собираемые из фрагментов
+
+    // Оценка тика сервера: тик = время клиента * TICK_RATE + clockOffset
+    std::chrono::steady_clock::time_point clockOrigin = std::chrono::steady_clock::now();
+    double clockOffset = 0;
+    bool clockValid = false;
+
+    std::vector<uint8_t> packet;
+    std::vector<uint8_t> receiveBuffer;
+    Stats stats;
+};
@@ -0,0 +1,270 @@
+#include "GameServer.h"
+#include "../common/ByteStream.h"
+#include <algorithm>
+#include <thread>
+
+using NetProtocol::PacketType;
+
+bool GameServer::start(const GameServerConfig& newConfig) {
+    config = newConfig;
+    if (!model.init(config.mapFile)) {
+        return false;
+    }
+    // Игроки появляются по мере подключения; перемотка серверу не нужна
+    model.setRewindWindow(0);
+    model.preparePathfinding();
+    model.clearPlayers();
+    model.reset();
+    mapChecksum = NetProtocol::mapChecksum(model.getMap());
+
+    emptyWorld = GameSnapshot{};
+    emptyWorld.mapWidth = model.getMap().getWidth();
+    emptyWorld.mapHeight = model.getMap().getHeight();
+    historyValid.fill(false);
+    clients.clear();
+    stats = Stats{};
+    recentTickMs.clear();
+    receiveBuffer.resize(NetProtocol::MAX_PACKET_SIZE * 2);
+    return socket.open(config.port);
+}
+
+void GameServer::stop() {
+    for (auto& client : clients) {
+        sendControl(client.stats.address, PacketType::Disconnect, 0);
+    }
+    socket.close();
+}
+
+void GameServer::run(double seconds) {
+    using Clock = std::chrono::steady_clock;
+    const auto tickLength = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / NetProtocol::TICK_RATE));
+    const auto start = Clock::now();
+    auto nextTick = start;
+    while (seconds <= 0 || Clock::now() - start < std::chrono::duration<double>(seconds)) {
+        tick();
+        nextTick += tickLength;
+        auto now = Clock::now();
+        if (nextTick < now) {
+            nextTick = now; // Не догоняем пропущенные тики пачкой
+        }
+        std::this_thread::sleep_until(nextTick);
+    }
+}
+
+void GameServer::tick() {
+    auto tickStart = std::chrono::steady_clock::now();
+
+    receivePackets();
+    dropTimedOutClients();
+
+    if (model.getState() == GameState::GAME_OVER) {
+        // Все погибли: через паузу начинаем новую партию с теми же игроками
+        if (++gameOverTicks >= static_cast<int>(config.restartDelay * NetProtocol::TICK_RATE)) {
+            gameOverTicks = 0;
+            model.reset();
+            historyValid.fill(false);
+            for (auto& client : clients) {
+                client.hasAck = false; // Тики начались заново: старые базы недействительны
+            }
+        }
+    }
+    model.step(1.0f / NetProtocol::TICK_RATE);
+
+    if (model.getTick() % std::max(config.snapshotInterval, 1) == 0) {
+        broadcastSnapshot();
+    }
+
+    double elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - tickStart).count();
+    if (recentTickMs.size() < RECENT_TICKS) {
+        recentTickMs.push_back(elapsedMs);
+    } else {
+        recentTickMs[stats.ticks % RECENT_TICKS] = elapsedMs;
+    }
+    ++stats.ticks;
+    stats.totalTickMs += elapsedMs;
+    stats.maxTickMs = std::max(stats.maxTickMs, elapsedMs);
+}
+
+void GameServer::receivePackets() {
+    NetAddress from;
+    int size;
+    while ((size = socket.receiveFrom(receiveBuffer.data(), receiveBuffer.size(), from)) >= 0) {
+        stats.bytesReceived += static_cast<uint64_t>(size);
+        handlePacket(from, receiveBuffer.data(), static_cast<size_t>(size));
+    }
+}
+
+void GameServer::handlePacket(const NetAddress& from, const uint8_t* data, size_t size) {
+    PacketType type;
+    if (!NetProtocol::readHeader(data, size, type)) {
+        return;
+    }
+    ByteReader in(data + NetProtocol::PACKET_HEADER_SIZE, size - NetProtocol::PACKET_HEADER_SIZE);
+    Client* client = findClient(from);
+
+    switch (type) {
+        case PacketType::Connect: {
+            uint32_t checksum = in.u32();
+            if (!in.ok()) return;
+            if (client) {
+                sendControl(from, PacketType::Accept, client->stats.slot); // Повтор: Accept потерялся
+                return;
+            }
+            if (checksum != mapChecksum || static_cast<int>(clients.size()) >= config.maxClients) {
+                sendControl(from, PacketType::Reject, 0);
+                return;
+            }
+            int slot = model.addPlayer();
+            if (slot < 0) {
+                sendControl(from, PacketType::Reject, 0);
+                return;
+            }
+            Client newClient;
+            newClient.stats.address = from;
+            newClient.stats.slot = slot;
+            newClient.lastHeard = std::chrono::steady_clock::now();
+            clients.push_back(newClient);
+            sendControl(from, PacketType::Accept, slot);
+            break;
+        }
+        case PacketType::Input: {
+            if (!client) return;
+            uint32_t sequence = in.u32();
+            uint8_t hasAck = in.u8();
+            uint64_t ackedTick = in.u64();
+            uint8_t inputBits = in.u8();
+            if (!in.ok()) return;
+            client->lastHeard = std::chrono::steady_clock::now();
+            // Пакеты могут прийти не по порядку: старое управление не применяем
+            if (sequence > client->lastInputSequence) {
+                client->lastInputSequence = sequence;
+                model.setPlayerInput(client->stats.slot, NetProtocol::unpackInput(inputBits));
+            }
+            // Подтверждение из будущего - запоздалый пакет прошлой партии
+            if (hasAck && ackedTick <= model.getTick() && (!client->hasAck || ackedTick > client->ackedTick)) {
+                client->hasAck = true;
+                client->ackedTick = ackedTick;
+            }
+            break;
+        }
+        case PacketType::Disconnect:
+            if (client) {
+                removeClient(static_cast<size_t>(client - clients.data()));
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void GameServer::dropTimedOutClients() {
+    auto now = std::chrono::steady_clock::now();
+    for (size_t i = clients.size(); i-- > 0;) {
+        if (now - clients[i].lastHeard > std::chrono::duration<double>(config.clientTimeout)) {
+            removeClient(i);
+        }
+    }
+}
+
+void GameServer::removeClient(size_t index) {
+    model.removePlayer(clients[index].stats.slot);
+    stats.departedClients.push_back(clients[index].stats);
+    clients.erase(clients.begin() + static_cast<std::ptrdiff_t>(index));
+}
+
+void GameServer::broadcastSnapshot() {
+    GameSnapshot& current = history[model.getTick() % HISTORY_SIZE];
+    model.captureSnapshot(current, false); // Состояние генератора клиентам не нужно
+    historyValid[model.getTick() % HISTORY_SIZE] = true;
+    for (auto& client : clients) {
+        sendSnapshot(client, current);
+    }
+}
+
+void GameServer::sendSnapshot(Client& client, const GameSnapshot& current) {
+    // База - последний подтвержденный клиентом снимок, если он еще в истории
+    const GameSnapshot* base = &emptyWorld;
+    bool hasBase = false;
+    if (client.hasAck && client.ackedTick < current.tick && current.tick - client.ackedTick < HISTORY_SIZE) {
+        const GameSnapshot& candidate = history[client.ackedTick % HISTORY_SIZE];
+        if (historyValid[client.ackedTick % HISTORY_SIZE] && candidate.tick == client.ackedTick) {
+            base = &candidate;
+            hasBase = true;
+        }
+    }
+    payload.clear();
+    if (!encoder.encode(*base, current, payload)) {
+        payload.clear();
+        if (!encoder.encode(emptyWorld, current, payload)) {
+            return;
+        }
+        hasBase = false;
+    }
+
+    size_t fragmentCount = (payload.size() + NetProtocol::MAX_FRAGMENT_SIZE - 1) / NetProtocol::MAX_FRAGMENT_SIZE;
+    fragmentCount = std::max<size_t>(fragmentCount, 1);
+    if (fragmentCount > NetProtocol::MAX_FRAGMENTS) {
+        return;
+    }
+    for (size_t i = 0; i < fragmentCount; ++i) {
+        size_t offset = i * NetProtocol::MAX_FRAGMENT_SIZE;
+        size_t length = std::min(NetProtocol::MAX_FRAGMENT_SIZE, payload.size() - offset);
+        NetProtocol::writeHeader(packet, PacketType::Snapshot);
+        ByteWriter out(packet);
+        out.u64(current.tick);
+        out.u64(hasBase ? base->tick : 0);
+        out.u8(hasBase ? 1 : 0);
+        out.u16(static_cast<uint16_t>(i));
+        out.u16(static_cast<uint16_t>(fragmentCount));
+        out.u32(static_cast<uint32_t>(payload.size()));
+        out.bytes(payload.data() + offset, length);
+        socket.sendTo(client.stats.address, packet.data(), packet.size());
+        client.stats.bytesSent += packet.size();
+        stats.bytesSent += packet.size();
+    }
+    ++client.stats.snapshotsSent;
+    if (!hasBase) {
+        ++client.stats.fullSnapshotsSent;
+    }
+}
+
+void GameServer::sendControl(const NetAddress& to, PacketType type, int value) {
+    NetProtocol::writeHeader(packet, type);
+    ByteWriter out(packet);
+    if (type == PacketType::Accept) {
+        out.u8(static_cast<uint8_t>(value));
+        out.u16(static_cast<uint16_t>(NetProtocol::TICK_RATE));
+        out.u8(static_cast<uint8_t>(config.snapshotInterval));
+    }
+    socket.sendTo(to, packet.data(), packet.size());
+    stats.bytesSent += packet.size();
+}
+
+GameServer::Client* GameServer::findClient(const NetAddress& address) {
+    for (auto& client : clients) {
+        if (client.stats.address == address) {
+            return &client;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<GameServer::ClientStats> GameServer::getClientStats() const {
+    std::vector<ClientStats> result = stats.departedClients;
+    for (const auto& client : clients) {
+        result.push_back(client.stats);
+    }
+    return result;
+}
+
+double GameServer::getTickPercentile(double fraction) const {
+    if (recentTickMs.empty()) {
+        return 0;
+    }
+    std::vector<double> sorted = recentTickMs;
+    size_t index = std::min(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()));
+    std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(index), sorted.end());
+    return sorted[index];
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "NetProtocol.h"
+#include "UdpSocket.h"
+#include "../model/GameModel.h"
+#include "../model/SnapshotDelta.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct GameServerConfig {
+    uint16_t port = 47000;
+    std::string mapFile = "../resources/map.txt";
+    int maxClients = 8;
+    int snapshotInterval = 2;     // Снимок клиентам раз в столько тиков
+    double clientTimeout = 5.0;   // Секунд без пакетов до отключения
+    double restartDelay = 3.0;    // Пауза после гибели всех игроков перед новой партией
+};
+
+// Авторитетный сервер: симулирует GameModel с фиксированным шагом,
+// применяет управление клиентов и рассылает им снимки дельтой от подтвержденных
+class GameServer {
+public:
+    struct ClientStats {
+        NetAddress address;
+        int slot = -1;
+        uint64_t bytesSent = 0;
+        uint64_t snapshotsSent = 0;
+        uint64_t fullSnapshotsSent = 0;
+    };
+
+    struct Stats {
+        uint64_t ticks = 0;
+        double totalTickMs = 0;
+        double maxTickMs = 0;
+        uint64_t bytesSent = 0;
+        uint64_t bytesReceived = 0;
+        std::vector<ClientStats> departedClients; // Статистика отключившихся
+    };
+
+    bool start(const GameServerConfig& config);
+    void stop();
+
+    void tick();                  // Один шаг: прием, симуляция, рассылка
+    void run(double seconds);     // Тики с частотой TICK_RATE; seconds <= 0 - бесконечно
+
+    const GameModel& getModel() const { return model; }
+    int getClientCount() const { return static_cast<int>(clients.size()); }
+    std::vector<ClientStats> getClientStats() const;
+    const Stats& getStats() const { return stats; }
+    // Перцентиль времени тика (0..1) по последним RECENT_TICKS тикам, мс
+    double getTickPercentile(double fraction) const;
+
+private:
+    static constexpr int HISTORY_SIZE = 64; // Тиков, от которых можно строить дельту
+    static constexpr size_t RECENT_TICKS = 60 * NetProtocol::TICK_RATE;
+
+    struct Client {
+        ClientStats stats;
+        uint32_t lastInputSequence = 0;
+        bool hasAck = false;
+        uint64_t ackedTick = 0;
+        std::chrono::steady_clock::time_point lastHeard;
+    };
+
+    void receivePackets();
+    void handlePacket(const NetAddress& from, const uint8_t* data, size_t size);
+    void dropTimedOutClients();
+    void removeClient(size_t index);
+    void broadcastSnapshot();
+    void sendSnapshot(Client& client, const GameSnapshot& current);
+    void sendControl(const NetAddress& to, NetProtocol::PacketType type, int value);
+    Client* findClient(const NetAddress& address);
+
+    GameServerConfig config;
+    GameModel model;
+    UdpSocket socket;
+    uint32_t mapChecksum = 0;
+    std::vector<Client> clients;
+
+    std::array<GameSnapshot, HISTORY_SIZE> history; // history[tick % HISTORY_SIZE]
+    std::array<bool, HISTORY_SIZE> historyValid{};
+    GameSnapshot emptyWorld; // База полного снимка
+    SnapshotDelta encoder;
+    std::vector<uint8_t> payload;
+    std::vector<uint8_t> packet;
+    std::vector<uint8_t> receiveBuffer;
+    int gameOverTicks = 0;
+
+    Stats stats;
+    std::vector<double> recentTickMs; // Кольцо по stats.ticks % RECENT_TICKS
+};
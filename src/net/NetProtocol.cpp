@@ -0,0 +1,59 @@
+#include "NetProtocol.h"
+#include "../common/ByteStream.h"
+#include "../model/GameMap.h"
+
+namespace NetProtocol {
+
+uint32_t mapChecksum(const GameMap& map) {
+    // FNV-1a по размерам и тайлам
+    uint32_t hash = 2166136261u;
+    auto mix = [&hash](uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            hash ^= (value >> (8 * i)) & 0xFF;
+            hash *= 16777619u;
+        }
+    };
+    mix(static_cast<uint32_t>(map.getWidth()));
+    mix(static_cast<uint32_t>(map.getHeight()));
+    for (int y = 0; y < map.getHeight(); ++y) {
+        for (int x = 0; x < map.getWidth(); ++x) {
+            hash ^= static_cast<uint32_t>(map.getTile(x, y));
+            hash *= 16777619u;
+        }
+    }
+    return hash;
+}
+
+void writeHeader(std::vector<uint8_t>& out, PacketType type) {
+    out.clear();
+    ByteWriter writer(out);
+    writer.u32(PROTOCOL_ID);
+    writer.u8(static_cast<uint8_t>(type));
+}
+
+bool readHeader(const uint8_t* data, size_t size, PacketType& outType) {
+    ByteReader reader(data, size);
+    uint32_t protocol = reader.u32();
+    uint8_t type = reader.u8();
+    if (!reader.ok() || protocol != PROTOCOL_ID ||
+        type < static_cast<uint8_t>(PacketType::Connect) || type > static_cast<uint8_t>(PacketType::Disconnect)) {
+        return false;
+    }
+    outType = static_cast<PacketType>(type);
+    return true;
+}
+
+uint8_t packInput(const PlayerInput& input) {
+    return static_cast<uint8_t>((input.move ? 1 : 0) | (static_cast<uint8_t>(input.moveDirection) << 1) |
+                                (input.fire ? 8 : 0));
+}
+
+PlayerInput unpackInput(uint8_t bits) {
+    PlayerInput input;
+    input.move = (bits & 1) != 0;
+    input.moveDirection = static_cast<Direction>((bits >> 1) & 3);
+    input.fire = (bits & 8) != 0;
+    return input;
+}
+
+} // namespace NetProtocol
@@ -0,0 +1,53 @@
+#pragma once
+#include "../common/Direction.h"
+#include "../model/PlayerInput.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+class GameMap;
+
+// Протокол сетевой игры поверх UDP.
+// Клиент шлет каждый тик состояние управления и номер последнего полностью принятого снимка.
+// Сервер шлет снимки дельтой от этого подтвержденного снимка (или полностью, если его
+// уже нет в истории). Снимок больше одного пакета режется на фрагменты
+namespace NetProtocol {
+
+constexpr uint32_t PROTOCOL_ID = 0x544E4B31; // "TNK1"
+constexpr int TICK_RATE = 60;
+constexpr size_t MAX_PACKET_SIZE = 1200;     // Без фрагментации IP на обычных сетях
+constexpr size_t PACKET_HEADER_SIZE = 5;     // Идентификатор протокола и тип
+constexpr size_t SNAPSHOT_HEADER_SIZE = PACKET_HEADER_SIZE + 8 + 8 + 1 + 2 + 2 + 4;
+constexpr size_t MAX_FRAGMENT_SIZE = MAX_PACKET_SIZE - SNAPSHOT_HEADER_SIZE;
+constexpr int MAX_FRAGMENTS = 4096;
+
+enum class PacketType : uint8_t {
+    Connect = 1,    // Клиент -> сервер: контрольная сумма карты
+    Accept,         // Сервер -> клиент: номер игрока
+    Reject,         // Сервер -> клиент: мест нет или карта другая
+    Input,          // Клиент -> сервер: управление и подтверждение снимка
+    Snapshot,       // Сервер -> клиент: фрагмент снимка
+    Disconnect      // В обе стороны
+};
+
+struct SnapshotFragmentHeader {
+    uint64_t tick = 0;
+    uint64_t baseTick = 0;  // Снимок, от которого построена дельта
+    bool hasBase = false;   // false - полный снимок (дельта от пустого мира)
+    uint16_t fragmentIndex = 0;
+    uint16_t fragmentCount = 0;
+    uint32_t totalSize = 0;
+};
+
+// Контрольная сумма карты: клиент и сервер должны загрузить одну и ту же
+uint32_t mapChecksum(const GameMap& map);
+
+void writeHeader(std::vector<uint8_t>& out, PacketType type);
+// Тип пакета, если идентификатор протокола совпал
+bool readHeader(const uint8_t* data, size_t size, PacketType& outType);
+
+// Управление упаковывается в байт: движение, направление, стрельба
+uint8_t packInput(const PlayerInput& input);
+PlayerInput unpackInput(uint8_t bits);
+
+} // namespace NetProtocol
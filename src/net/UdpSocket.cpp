@@ -0,0 +1,186 @@
+#include "UdpSocket.h"
+#include <cstring>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+using SocketHandle = SOCKET;
+constexpr intptr_t INVALID_HANDLE = static_cast<intptr_t>(INVALID_SOCKET);
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+using SocketHandle = int;
+constexpr intptr_t INVALID_HANDLE = -1;
+#endif
+
+namespace {
+
+#ifdef _WIN32
+// Winsock инициализируется один раз на процесс
+struct WinsockInit {
+    WinsockInit() {
+        WSADATA data;
+        WSAStartup(MAKEWORD(2, 2), &data);
+    }
+    ~WinsockInit() { WSACleanup(); }
+};
+
+void ensureNetworkStarted() {
+    static WinsockInit init;
+}
+#else
+void ensureNetworkStarted() {}
+#endif
+
+sockaddr_in toSockaddr(const NetAddress& address) {
+    sockaddr_in result;
+    std::memset(&result, 0, sizeof(result));
+    result.sin_family = AF_INET;
+    result.sin_addr.s_addr = htonl(address.ip);
+    result.sin_port = htons(address.port);
+    return result;
+}
+
+} // namespace
+
+bool NetAddress::parse(const std::string& text, NetAddress& outAddress) {
+    ensureNetworkStarted();
+    size_t colon = text.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == text.size()) {
+        return false;
+    }
+    std::string host = text.substr(0, colon);
+    int port = 0;
+    for (size_t i = colon + 1; i < text.size(); ++i) {
+        if (text[i] < '0' || text[i] > '9') return false;
+        port = port * 10 + (text[i] - '0');
+        if (port > 65535) return false;
+    }
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* found = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &found) != 0 || !found) {
+        return false;
+    }
+    const sockaddr_in* resolved = reinterpret_cast<const sockaddr_in*>(found->ai_addr);
+    outAddress.ip = ntohl(resolved->sin_addr.s_addr);
+    outAddress.port = static_cast<uint16_t>(port);
+    freeaddrinfo(found);
+    return true;
+}
+
+std::string NetAddress::toString() const {
+    return std::to_string((ip >> 24) & 0xFF) + "." + std::to_string((ip >> 16) & 0xFF) + "." +
+           std::to_string((ip >> 8) & 0xFF) + "." + std::to_string(ip & 0xFF) + ":" + std::to_string(port);
+}
+
+UdpSocket::UdpSocket() : handle(INVALID_HANDLE) {}
+
+UdpSocket::~UdpSocket() {
+    close();
+}
+
+bool UdpSocket::open(uint16_t port) {
+    close();
+    ensureNetworkStarted();
+    SocketHandle sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (static_cast<intptr_t>(sock) == INVALID_HANDLE) {
+        return false;
+    }
+    handle = static_cast<intptr_t>(sock);
+
+    // Снимки приходят пачками фрагментов - увеличиваем буферы
+    int bufferSize = 4 * 1024 * 1024;
+    setsockopt(sock, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&bufferSize), sizeof(bufferSize));
+    setsockopt(sock, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>(&bufferSize), sizeof(bufferSize));
+
+    NetAddress any;
+    any.port = port;
+    sockaddr_in local = toSockaddr(any);
+    if (bind(sock, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0) {
+        close();
+        return false;
+    }
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    ioctlsocket(sock, FIONBIO, &nonBlocking);
+#else
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+#endif
+    return true;
+}
+
+void UdpSocket::close() {
+    if (handle == INVALID_HANDLE) {
+        return;
+    }
+#ifdef _WIN32
+    closesocket(static_cast<SocketHandle>(handle));
+#else
+    ::close(static_cast<SocketHandle>(handle));
+#endif
+    handle = INVALID_HANDLE;
+}
+
+bool UdpSocket::isOpen() const {
+    return handle != INVALID_HANDLE;
+}
+
+uint16_t UdpSocket::getLocalPort() const {
+    if (!isOpen()) {
+        return 0;
+    }
+    sockaddr_in local;
+    socklen_t length = sizeof(local);
+    if (getsockname(static_cast<SocketHandle>(handle), reinterpret_cast<sockaddr*>(&local), &length) != 0) {
+        return 0;
+    }
+    return ntohs(local.sin_port);
+}
+
+bool UdpSocket::sendTo(const NetAddress& address, const uint8_t* data, size_t size) {
+    if (!isOpen()) {
+        return false;
+    }
+    sockaddr_in target = toSockaddr(address);
+    auto sent = sendto(static_cast<SocketHandle>(handle), reinterpret_cast<const char*>(data),
+                       static_cast<int>(size), 0, reinterpret_cast<const sockaddr*>(&target), sizeof(target));
+    return sent == static_cast<decltype(sent)>(size);
+}
+
+int UdpSocket::receiveFrom(uint8_t* buffer, size_t capacity, NetAddress& outFrom) {
+    if (!isOpen()) {
+        return -1;
+    }
+    sockaddr_in from;
+    socklen_t length = sizeof(from);
+    auto received = recvfrom(static_cast<SocketHandle>(handle), reinterpret_cast<char*>(buffer),
+                             static_cast<int>(capacity), 0, reinterpret_cast<sockaddr*>(&from), &length);
+    if (received < 0) {
+        return -1; // Нет данных (EWOULDBLOCK) или ошибка - для UDP это одно и то же
+    }
+    outFrom.ip = ntohl(from.sin_addr.s_addr);
+    outFrom.port = ntohs(from.sin_port);
+    return static_cast<int>(received);
+}
+
+bool UdpSocket::waitReadable(int timeoutMs) {
+    if (!isOpen()) {
+        return false;
+    }
+#ifdef _WIN32
+    WSAPOLLFD descriptor{static_cast<SocketHandle>(handle), POLLRDNORM, 0};
+    return WSAPoll(&descriptor, 1, timeoutMs) > 0;
+#else
+    pollfd descriptor{static_cast<SocketHandle>(handle), POLLIN, 0};
+    return poll(&descriptor, 1, timeoutMs) > 0;
+#endif
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// IPv4-адрес и порт в порядке байтов хоста
+struct NetAddress {
+    uint32_t ip = 0;
+    uint16_t port = 0;
+
+    // "хост:порт"; хост - IPv4-адрес или имя
+    static bool parse(const std::string& text, NetAddress& outAddress);
+    std::string toString() const;
+
+    bool operator==(const NetAddress& other) const { return ip == other.ip && port == other.port; }
+    bool operator!=(const NetAddress& other) const { return !(*this == other); }
+};
+
+// Неблокирующий UDP-сокет (POSIX и Winsock)
+class UdpSocket {
+public:
+    UdpSocket();
+    ~UdpSocket();
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    bool open(uint16_t port = 0); // 0 - любой свободный порт
+    void close();
+    bool isOpen() const;
+    uint16_t getLocalPort() const;
+
+    bool sendTo(const NetAddress& address, const uint8_t* data, size_t size);
+    // Размер принятого пакета или -1, если очередь пуста
+    int receiveFrom(uint8_t* buffer, size_t capacity, NetAddress& outFrom);
+    // Ждет входящий пакет не дольше timeoutMs; true, если что-то пришло
+    bool waitReadable(int timeoutMs);
+
+private:
+    intptr_t handle;
+};
@@ -0,0 +1,220 @@
+#include "BatchEnvironment.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+constexpr float TICK_SECONDS = 1.0f / 60.0f;
+
+const Tank* findPlayerTank(const GameModel& model) {
+    for (const auto& obj : model.getObjects()) {
+        const Tank* tank = dynamic_cast<const Tank*>(obj.get());
+        if (tank && tank->isPlayer() && !tank->isDestroyed()) {
+            return tank;
+        }
+    }
+    return nullptr;
+}
+
+PlayerInput decodeAction(uint8_t action) {
+    static constexpr Direction DIRECTIONS[4] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+    PlayerInput input;
+    if (action >= BatchEnvironment::MOVE_UP && action <= BatchEnvironment::MOVE_RIGHT) {
+        input.move = true;
+        input.moveDirection = DIRECTIONS[action - BatchEnvironment::MOVE_UP];
+    } else if (action >= BatchEnvironment::FIRE_UP && action <= BatchEnvironment::FIRE_RIGHT) {
+        input.move = true;
+        input.moveDirection = DIRECTIONS[action - BatchEnvironment::FIRE_UP];
+        input.fire = true;
+    } else if (action == BatchEnvironment::FIRE) {
+        input.fire = true;
+    }
+    return input;
+}
+
+} // namespace
+
+bool BatchEnvironment::init(const BatchEnvironmentConfig& newConfig) {
+    config = newConfig;
+    config.envCount = std::max(1, config.envCount);
+    config.viewRadius = std::max(0, config.viewRadius);
+    config.ticksPerStep = std::max(1, config.ticksPerStep);
+    layout = MapLayout::fromFile(config.mapFile);
+    if (!layout) {
+        return false;
+    }
+    int threads = config.threads > 0 ? config.threads : static_cast<int>(std::thread::hardware_concurrency());
+    pool = std::make_unique<ThreadPool>(std::clamp(threads, 1, config.envCount), config.pinThreads);
+    envs.clear();
+    envs.resize(config.envCount);
+    rangeJob = [this](int worker) { runRange(worker); };
+
+    // Модели создаются на потоках, которые будут их шагать
+    std::atomic<bool> ok{true}; // Пишут несколько потоков пула
+    std::function<void(int)> create = [this, &ok](int worker) {
+        int count = static_cast<int>(envs.size());
+        int threads = pool->getThreadCount();
+        for (int i = worker * count / threads; i < (worker + 1) * count / threads; ++i) {
+            envs[i] = std::make_unique<Env>();
+            if (!envs[i]->model.init(layout)) {
+                ok.store(false, std::memory_order_relaxed); // Карта уже проверена, сюда попасть не должны
+                continue;
+            }
+            envs[i]->model.setRewindWindow(0);
+            envs[i]->model.preparePathfinding();
+        }
+    };
+    pool->runOnAll(create);
+    return ok.load();
+}
+
+size_t BatchEnvironment::getObservationSize() const {
+    size_t side = static_cast<size_t>(getViewSide());
+    return CHANNELS * side * side;
+}
+
+uint64_t BatchEnvironment::getEpisodeCount() const {
+    uint64_t total = 0;
+    for (const auto& env : envs) {
+        total += env->episode;
+    }
+    return total;
+}
+
+void BatchEnvironment::reset(uint8_t* observations) {
+    stepActions = nullptr;
+    stepObservations = observations;
+    pool->runOnAll(rangeJob);
+}
+
+void BatchEnvironment::step(const uint8_t* actions, uint8_t* observations, float* rewards, uint8_t* dones) {
+    stepActions = actions;
+    stepObservations = observations;
+    stepRewards = rewards;
+    stepDones = dones;
+    pool->runOnAll(rangeJob);
+}
+
+void BatchEnvironment::runRange(int worker) {
+    int count = static_cast<int>(envs.size());
+    int threads = pool->getThreadCount();
+    int begin = worker * count / threads;
+    int end = (worker + 1) * count / threads;
+    size_t observationSize = getObservationSize();
+    for (int i = begin; i < end; ++i) {
+        if (stepActions) {
+            stepEnv(i, stepActions[i], stepRewards[i], stepDones[i]);
+        } else {
+            resetEnv(i);
+        }
+        writeObservation(i, stepObservations + i * observationSize);
+    }
+}
+
+void BatchEnvironment::resetEnv(int index) {
+    Env& env = *envs[index];
+    // Свой seed у каждого эпизода каждой среды: прогон воспроизводим при любом числе потоков
+    env.model.setSeed(config.seed + static_cast<uint32_t>(index) * 0x9E3779B9u + static_cast<uint32_t>(env.episode));
+    env.model.reset();
+    env.episodeTicks = 0;
+    env.lastScore = env.model.getScore();
+    env.lastHealth = env.model.getPlayerHealth();
+    if (const Tank* tank = findPlayerTank(env.model)) {
+        env.centerX = tank->getX() + GameModel::TANK_SIZE / 2;
+        env.centerY = tank->getY() + GameModel::TANK_SIZE / 2;
+    }
+}
+
+void BatchEnvironment::stepEnv(int index, uint8_t action, float& reward, uint8_t& done) {
+    Env& env = *envs[index];
+    env.model.setPlayerInput(decodeAction(action));
+    for (int t = 0; t < config.ticksPerStep && env.model.getState() == GameState::PLAYING; ++t) {
+        env.model.step(TICK_SECONDS);
+        ++env.episodeTicks;
+    }
+
+    int score = env.model.getScore();
+    int health = env.model.getPlayerHealth();
+    reward = (score - env.lastScore) / 100.0f;
+    if (health < env.lastHealth) {
+        const Tank* tank = findPlayerTank(env.model);
+        int maxHealth = tank ? tank->getMaxHealth() : std::max(env.lastHealth, 1);
+        reward -= static_cast<float>(env.lastHealth - health) / maxHealth;
+    }
+    env.lastScore = score;
+    env.lastHealth = health;
+
+    done = RUNNING;
+    if (env.model.getState() == GameState::GAME_OVER) {
+        reward -= 1.0f;
+        done = TERMINATED;
+    } else if (env.episodeTicks >= config.maxEpisodeTicks) {
+        done = TRUNCATED;
+    }
+    if (done != RUNNING) {
+        ++env.episode;
+        resetEnv(index);
+    }
+}
+
+void BatchEnvironment::writeObservation(int index, uint8_t* out) {
+    Env& env = *envs[index];
+    const GameMap& map = env.model.getMap();
+    const int radius = config.viewRadius;
+    const int side = getViewSide();
+    const size_t plane = static_cast<size_t>(side) * side;
+    std::memset(out, 0, CHANNELS * plane);
+
+    const Tank* self = findPlayerTank(env.model);
+    if (self) {
+        env.centerX = self->getX() + GameModel::TANK_SIZE / 2;
+        env.centerY = self->getY() + GameModel::TANK_SIZE / 2;
+    }
+    const int centerTileX = static_cast<int>(env.centerX / GameModel::TILE_SIZE);
+    const int centerTileY = static_cast<int>(env.centerY / GameModel::TILE_SIZE);
+
+    uint8_t* walls = out + WALLS * plane;
+    for (int dy = -radius; dy <= radius; ++dy) {
+        for (int dx = -radius; dx <= radius; ++dx) {
+            // За краем карты getTile возвращает стену
+            if (map.getTile(centerTileX + dx, centerTileY + dy) == TileType::Wall) {
+                walls[(dy + radius) * side + dx + radius] = 1;
+            }
+        }
+    }
+
+    // Объект попадает в клетку окна по своему центру
+    auto cellOf = [&](float x, float y, float size, size_t& outCell) {
+        int tileX = static_cast<int>(std::floor((x + size / 2) / GameModel::TILE_SIZE)) - centerTileX + radius;
+        int tileY = static_cast<int>(std::floor((y + size / 2) / GameModel::TILE_SIZE)) - centerTileY + radius;
+        if (tileX < 0 || tileX >= side || tileY < 0 || tileY >= side) {
+            return false;
+        }
+        outCell = static_cast<size_t>(tileY) * side + tileX;
+        return true;
+    };
+    for (const auto& obj : env.model.getObjects()) {
+        if (obj->isDestroyed()) {
+            continue;
+        }
+        size_t cell;
+        const Tank* tank = dynamic_cast<const Tank*>(obj.get());
+        if (tank && !tank->isPlayer() && cellOf(tank->getX(), tank->getY(), GameModel::TANK_SIZE, cell)) {
+            out[ENEMIES * plane + cell] = 1;
+        }
+    }
+    const BulletArray& bullets = env.model.getBullets();
+    for (size_t i = 0; i < bullets.size(); ++i) {
+        size_t cell;
+        if (!bullets.isDestroyed(i) && cellOf(bullets.getX(i), bullets.getY(i), 0, cell)) {
+            out[(bullets.isFromPlayer(i) ? PLAYER_BULLETS : ENEMY_BULLETS) * plane + cell] = 1;
+        }
+    }
+    if (self) {
+        out[SELF * plane + static_cast<size_t>(radius) * side + radius] =
+            static_cast<uint8_t>(255 * self->getHealth() / std::max(self->getMaxHealth(), 1));
+    }
+}
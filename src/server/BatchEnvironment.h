@@ -0,0 +1,92 @@
+#pragma once
+#include "../common/ThreadPool.h"
+#include "../model/GameModel.h"
+#include "../model/MapLayout.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct BatchEnvironmentConfig {
+    std::string mapFile = "../resources/map.txt";
+    int envCount = 64;
+    int threads = 0;                // 0 - по числу ядер
+    bool pinThreads = true;
+    int viewRadius = 7;             // Наблюдение - окно (2R+1)x(2R+1) тайлов вокруг танка
+    int ticksPerStep = 1;           // Действие повторяется столько тиков
+    uint64_t maxEpisodeTicks = 60 * 60 * 2; // Дольше - эпизод обрывается (done = TRUNCATED)
+    uint32_t seed = 1;
+};
+
+// K независимых партий для обучения ботов: одно действие на среду за шаг,
+// наблюдения, награды и флаги окончания пишутся в буферы вызывающего.
+// Среды делятся между потоками пула постоянными диапазонами, шаг не выделяет память.
+//
+// Действия (uint8_t на среду): 0 - стоять, 1..4 - ехать вверх/вниз/влево/вправо,
+// 5..8 - ехать и стрелять, 9 - стрелять на месте.
+// Наблюдение среды - CHANNELS плоскостей uint8_t размером side x side (side = 2R+1),
+// центр - тайл танка игрока: стены (за краем карты - тоже стены), враги, пули врагов,
+// пули игрока и сам игрок (значение в центре - здоровье, 255 - полное).
+// Награда: +1 за каждые 100 очков, минус доля потерянного здоровья, -1 за гибель.
+// Закончившаяся среда сразу сбрасывается через GameModel::reset: done описывает
+// закончившийся эпизод, а наблюдение - уже первое состояние нового
+class BatchEnvironment {
+public:
+    enum Action : uint8_t {
+        NOOP = 0,
+        MOVE_UP, MOVE_DOWN, MOVE_LEFT, MOVE_RIGHT,
+        FIRE_UP, FIRE_DOWN, FIRE_LEFT, FIRE_RIGHT,
+        FIRE,
+        ACTION_COUNT
+    };
+    enum Done : uint8_t {
+        RUNNING = 0,
+        TERMINATED = 1, // Игрок погиб
+        TRUNCATED = 2   // Достигнут maxEpisodeTicks
+    };
+    enum Channel { WALLS, ENEMIES, ENEMY_BULLETS, PLAYER_BULLETS, SELF, CHANNELS };
+
+    bool init(const BatchEnvironmentConfig& config);
+
+    int getEnvCount() const { return static_cast<int>(envs.size()); }
+    int getViewSide() const { return 2 * config.viewRadius + 1; }
+    size_t getObservationSize() const; // Байт на одну среду
+
+    // Сбрасывает все среды; observations - envCount * getObservationSize() байт
+    void reset(uint8_t* observations);
+    // actions - envCount байт, rewards - envCount float, dones - envCount байт
+    void step(const uint8_t* actions, uint8_t* observations, float* rewards, uint8_t* dones);
+
+    uint64_t getEpisodeCount() const; // Закончившихся эпизодов во всех средах
+    const GameModel& getModel(int env) const { return envs[env]->model; }
+
+private:
+    struct Env {
+        GameModel model;
+        uint64_t episode = 0;
+        uint64_t episodeTicks = 0;
+        int lastScore = 0;
+        int lastHealth = 0;
+        float centerX = 0; // Последняя известная позиция танка (после гибели окно остается на месте)
+        float centerY = 0;
+    };
+
+    void resetEnv(int index);
+    void stepEnv(int index, uint8_t action, float& reward, uint8_t& done);
+    void writeObservation(int index, uint8_t* out);
+    void runRange(int worker);
+
+    BatchEnvironmentConfig config;
+    std::shared_ptr<const MapLayout> layout;
+    std::vector<std::unique_ptr<Env>> envs;
+    std::unique_ptr<ThreadPool> pool;
+
+    // Аргументы текущего вызова для потоков пула
+    const uint8_t* stepActions = nullptr;
+    uint8_t* stepObservations = nullptr;
+    float* stepRewards = nullptr;
+    uint8_t* stepDones = nullptr;
+    std::function<void(int)> rangeJob; // Создается один раз в init
+};
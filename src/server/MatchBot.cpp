@@ -0,0 +1,85 @@
+#include "MatchBot.h"
+#include "../model/GameModel.h"
+#include <cmath>
+#include <limits>
+
+MatchBot::MatchBot(int slot, uint32_t seed) {
+    reset(slot, seed);
+}
+
+void MatchBot::reset(int newSlot, uint32_t seed) {
+    slot = newSlot;
+    rng.seed(seed);
+    lastX = lastY = -1;
+    triedToMove = false;
+    detourTicks = 0;
+}
+
+PlayerInput MatchBot::decide(const GameModel& model) {
+    PlayerInput input;
+    const Tank* self = nullptr;
+    const Tank* target = nullptr;
+    float bestDistance = std::numeric_limits<float>::max();
+    for (const auto& obj : model.getObjects()) {
+        const Tank* tank = dynamic_cast<const Tank*>(obj.get());
+        if (!tank || tank->isDestroyed()) {
+            continue;
+        }
+        if (tank->isPlayer() && tank->getPlayerSlot() == slot) {
+            self = tank;
+        }
+    }
+    if (!self) {
+        return input;
+    }
+    for (const auto& obj : model.getObjects()) {
+        const Tank* tank = dynamic_cast<const Tank*>(obj.get());
+        if (!tank || tank->isPlayer() || tank->isDestroyed()) {
+            continue;
+        }
+        float distance = std::abs(tank->getX() - self->getX()) + std::abs(tank->getY() - self->getY());
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            target = tank;
+        }
+    }
+
+    // Ехали, но остались на месте - уперлись в стену или танк
+    bool stuck = triedToMove && self->getX() == lastX && self->getY() == lastY;
+    lastX = self->getX();
+    lastY = self->getY();
+    triedToMove = false;
+    if (stuck && detourTicks == 0) {
+        detourTicks = 20 + static_cast<int>(rng() % 40);
+        detourDirection = static_cast<Direction>(rng() % 4);
+    }
+    if (detourTicks > 0) {
+        --detourTicks;
+        input.move = triedToMove = true;
+        input.moveDirection = detourDirection;
+        input.fire = rng() % 8 == 0;
+        return input;
+    }
+    if (!target) {
+        return input;
+    }
+
+    // Враг на одной линии - разворачиваемся к нему и стреляем, иначе сближаемся по большей оси
+    const float aligned = GameModel::TANK_SIZE / 2;
+    float dx = target->getX() - self->getX();
+    float dy = target->getY() - self->getY();
+    if (std::abs(dx) < aligned) {
+        input.moveDirection = dy < 0 ? Direction::UP : Direction::DOWN;
+        input.fire = true;
+    } else if (std::abs(dy) < aligned) {
+        input.moveDirection = dx < 0 ? Direction::LEFT : Direction::RIGHT;
+        input.fire = true;
+    } else if (std::abs(dx) > std::abs(dy)) {
+        input.moveDirection = dx < 0 ? Direction::LEFT : Direction::RIGHT;
+    } else {
+        input.moveDirection = dy < 0 ? Direction::UP : Direction::DOWN;
+    }
+    // Танк поворачивается только вместе с шагом, поэтому на линии огня шагаем лишь для разворота
+    input.move = triedToMove = !input.fire || self->getDirection() != input.moveDirection;
+    return input;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "../model/PlayerInput.h"
+#include <cstdint>
+#include <random>
+
+class GameModel;
+
+// Простой бот за игрока для матчей без людей: едет к ближайшему врагу по большей оси,
+// стреляет, когда враг на одной линии, и объезжает препятствие в случайную сторону,
+// если уперся. Решения зависят только от состояния модели и seed
+class MatchBot {
+public:
+    explicit MatchBot(int slot = 0, uint32_t seed = 1);
+
+    void reset(int slot, uint32_t seed);
+    PlayerInput decide(const GameModel& model);
+
+private:
+    int slot;
+    std::mt19937 rng;
+    float lastX = -1;
+    float lastY = -1;
+    bool triedToMove = false;
+    int detourTicks = 0; // Сколько тиков еще ехать в сторону объезда
+    Direction detourDirection = Direction::UP;
+};
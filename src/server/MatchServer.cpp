@@ -0,0 +1,176 @@
+#include "MatchServer.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+constexpr float TICK_SECONDS = 1.0f / 60.0f;
+}
+
+bool MatchServer::start(const MatchServerConfig& newConfig) {
+    config = newConfig;
+    config.matchesPerThread = std::max(1, config.matchesPerThread);
+    config.playersPerMatch = std::clamp(config.playersPerMatch, 1, GameModel::MAX_PLAYERS);
+    config.ticksPerSlice = std::max(1, config.ticksPerSlice);
+    layout = MapLayout::fromFile(config.mapFile);
+    if (!layout) {
+        return false;
+    }
+    pool = std::make_unique<ThreadPool>(config.threads, config.pinThreads);
+    counters = std::make_unique<ThreadCounters[]>(pool->getThreadCount());
+    return true;
+}
+
+MatchThroughput MatchServer::run(double seconds, uint64_t newMatchLimit,
+                                 ProgressCallback progress, double progressInterval) {
+    matchLimit = newMatchLimit;
+    nextMatchIndex = 0;
+    matchesCompleted = 0;
+    budgetOverruns = 0;
+    stopRequested = false;
+    for (int i = 0; i < pool->getThreadCount(); ++i) {
+        counters[i].ticks = 0;
+        counters[i].busyNanoseconds = 0;
+    }
+
+    // Поток выполняет одну долгую задачу со своими матчами до конца прогона
+    std::atomic<int> runningWorkers{pool->getThreadCount()};
+    auto start = Clock::now();
+    for (int worker = 0; worker < pool->getThreadCount(); ++worker) {
+        pool->submit(worker, [this, worker, &runningWorkers] {
+            workerLoop(worker);
+            --runningWorkers;
+        });
+    }
+
+    auto nextProgress = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(progressInterval));
+    while (runningWorkers > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        auto now = Clock::now();
+        double elapsed = std::chrono::duration<double>(now - start).count();
+        if (seconds > 0 && elapsed >= seconds) {
+            stopRequested = true;
+        }
+        if (progress && now >= nextProgress) {
+            progress(collect(elapsed));
+            nextProgress += std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(progressInterval));
+        }
+    }
+    pool->wait();
+    return collect(std::chrono::duration<double>(Clock::now() - start).count());
+}
+
+void MatchServer::workerLoop(int worker) {
+    // Модели создаются на своем потоке: их память оказывается рядом с ядром, которое их считает
+    std::vector<std::unique_ptr<Match>> matches;
+    for (int i = 0; i < config.matchesPerThread; ++i) {
+        auto match = std::make_unique<Match>();
+        if (!match->model.init(layout)) {
+            return;
+        }
+        match->model.setRewindWindow(0);
+        match->model.preparePathfinding(); // До замера: граф строится один раз на карту, модели его копируют
+        match->model.clearPlayers();
+        for (int p = 0; p < config.playersPerMatch; ++p) {
+            match->model.addPlayer();
+        }
+        match->bots.resize(config.playersPerMatch);
+        if (beginMatch(*match, worker)) {
+            matches.push_back(std::move(match));
+        }
+    }
+
+    ThreadCounters& counter = counters[worker];
+    const double budgetMs = config.tickBudgetMs;
+    bool anyActive = !matches.empty();
+    while (anyActive && !stopRequested) {
+        anyActive = false;
+        for (auto& match : matches) {
+            if (!match->active) {
+                continue;
+            }
+            MatchResult& result = match->result;
+            auto sliceStart = Clock::now();
+            auto tickStart = sliceStart;
+            uint64_t sliceTicks = 0;
+            for (int t = 0; t < config.ticksPerSlice; ++t) {
+                for (int p = 0; p < config.playersPerMatch; ++p) {
+                    match->model.setPlayerInput(p, match->bots[p].decide(match->model));
+                }
+                match->model.step(TICK_SECONDS);
+                auto tickEnd = Clock::now();
+                double tickMs = std::chrono::duration<double, std::milli>(tickEnd - tickStart).count();
+                tickStart = tickEnd;
+                ++result.ticks;
+                ++sliceTicks;
+                result.totalTickMs += tickMs;
+                result.maxTickMs = std::max(result.maxTickMs, tickMs);
+                if (tickMs > budgetMs) {
+                    ++result.budgetOverruns;
+                }
+                if (match->model.getState() == GameState::GAME_OVER || result.ticks >= config.maxTicksPerMatch) {
+                    break;
+                }
+            }
+            counter.ticks.fetch_add(sliceTicks, std::memory_order_relaxed);
+            counter.busyNanoseconds.fetch_add(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(tickStart - sliceStart).count()),
+                std::memory_order_relaxed);
+
+            if (match->model.getState() == GameState::GAME_OVER || result.ticks >= config.maxTicksPerMatch) {
+                finishMatch(*match);
+                beginMatch(*match, worker);
+            }
+            anyActive = anyActive || match->active;
+        }
+    }
+}
+
+bool MatchServer::beginMatch(Match& match, int worker) {
+    uint64_t index = nextMatchIndex.fetch_add(1);
+    if (matchLimit != 0 && index >= matchLimit) {
+        match.active = false;
+        return false;
+    }
+    uint32_t seed = config.seed + static_cast<uint32_t>(index);
+    match.result = MatchResult{};
+    match.result.matchIndex = index;
+    match.result.seed = seed;
+    match.result.worker = worker;
+    match.model.setSeed(seed);
+    match.model.reset();
+    for (int p = 0; p < static_cast<int>(match.bots.size()); ++p) {
+        match.bots[p].reset(p, seed * 31u + static_cast<uint32_t>(p));
+    }
+    match.active = true;
+    return true;
+}
+
+void MatchServer::finishMatch(Match& match) {
+    match.result.score = match.model.getScore();
+    match.result.timedOut = match.model.getState() != GameState::GAME_OVER;
+    budgetOverruns += match.result.budgetOverruns;
+    ++matchesCompleted;
+    if (resultCallback) {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        resultCallback(match.result);
+    }
+}
+
+MatchThroughput MatchServer::collect(double seconds) const {
+    MatchThroughput report;
+    report.seconds = seconds;
+    report.matchesCompleted = matchesCompleted;
+    report.budgetOverruns = budgetOverruns;
+    for (int i = 0; i < pool->getThreadCount(); ++i) {
+        uint64_t ticks = counters[i].ticks.load(std::memory_order_relaxed);
+        report.ticks += ticks;
+        report.ticksPerThread.push_back(ticks);
+        report.busySecondsPerThread.push_back(counters[i].busyNanoseconds.load(std::memory_order_relaxed) * 1e-9);
+        report.threadPinned.push_back(pool->isPinned(i));
+    }
+    return report;
+}
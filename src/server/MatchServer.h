@@ -0,0 +1,106 @@
+#pragma once
+#include "MatchBot.h"
+#include "../common/ThreadPool.h"
+#include "../model/GameModel.h"
+#include "../model/MapLayout.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct MatchServerConfig {
+    std::string mapFile = "../resources/map.txt";
+    int threads = 0;               // 0 - по числу ядер
+    bool pinThreads = true;
+    int matchesPerThread = 4;      // Сколько матчей одновременно ведет один поток
+    int playersPerMatch = 2;       // Танки игроков под управлением MatchBot
+    int ticksPerSlice = 60;        // Тиков одного матча подряд, прежде чем перейти к следующему
+    uint64_t maxTicksPerMatch = 3 * 60 * 60; // Дольше - матч заканчивается по времени
+    double tickBudgetMs = 1.0;     // Тик дольше этого считается превышением бюджета
+    uint32_t seed = 1;             // Матч i играется с seed + i
+};
+
+struct MatchResult {
+    uint64_t matchIndex = 0;
+    uint32_t seed = 0;
+    int worker = -1;
+    uint64_t ticks = 0;
+    int score = 0;
+    bool timedOut = false;         // Достиг maxTicksPerMatch, игроки живы
+    double totalTickMs = 0;
+    double maxTickMs = 0;
+    uint64_t budgetOverruns = 0;   // Тиков дольше tickBudgetMs
+};
+
+// Сводка за прогон; per-thread значения - по потокам пула
+struct MatchThroughput {
+    double seconds = 0;
+    uint64_t matchesCompleted = 0;
+    uint64_t ticks = 0;
+    uint64_t budgetOverruns = 0;
+    std::vector<uint64_t> ticksPerThread;
+    std::vector<double> busySecondsPerThread; // Время внутри шагов симуляции
+    std::vector<bool> threadPinned;
+
+    double matchesPerSecond() const { return seconds > 0 ? matchesCompleted / seconds : 0; }
+    double ticksPerSecond() const { return seconds > 0 ? ticks / seconds : 0; }
+};
+
+// Сервер матчей без окна: много независимых GameModel на пуле потоков.
+// Каждый поток ведет свои матчи (они не переходят между ядрами), матч играется
+// порциями по ticksPerSlice тиков без привязки к реальному времени. Карта разбирается
+// один раз, все модели разделяют ее MapLayout
+class MatchServer {
+public:
+    using ResultCallback = std::function<void(const MatchResult&)>;
+    using ProgressCallback = std::function<void(const MatchThroughput&)>;
+
+    bool start(const MatchServerConfig& config);
+
+    // Вызывается из потоков пула, но никогда одновременно
+    void setResultCallback(ResultCallback callback) { resultCallback = std::move(callback); }
+
+    // Блокирует до истечения seconds (<= 0 - без ограничения) или до завершения matchLimit
+    // матчей (0 - без ограничения). progress вызывается на вызывающем потоке раз в progressInterval
+    MatchThroughput run(double seconds, uint64_t matchLimit,
+                        ProgressCallback progress = nullptr, double progressInterval = 1.0);
+
+    const std::shared_ptr<const MapLayout>& getLayout() const { return layout; }
+    int getThreadCount() const { return pool ? pool->getThreadCount() : 0; }
+
+private:
+    struct Match {
+        GameModel model;
+        std::vector<MatchBot> bots;
+        MatchResult result;
+        bool active = false;
+    };
+
+    // Счетчики потока; каждый в своей кэш-линии, чтобы потоки не мешали друг другу
+    struct alignas(64) ThreadCounters {
+        std::atomic<uint64_t> ticks{0};
+        std::atomic<uint64_t> busyNanoseconds{0};
+    };
+
+    void workerLoop(int worker);
+    bool beginMatch(Match& match, int worker);
+    void finishMatch(Match& match);
+    MatchThroughput collect(double seconds) const;
+
+    MatchServerConfig config;
+    std::shared_ptr<const MapLayout> layout;
+    std::unique_ptr<ThreadPool> pool;
+    std::unique_ptr<ThreadCounters[]> counters;
+
+    uint64_t matchLimit = 0;
+    std::atomic<uint64_t> nextMatchIndex{0};
+    std::atomic<uint64_t> matchesCompleted{0};
+    std::atomic<uint64_t> budgetOverruns{0};
+    std::atomic<bool> stopRequested{false};
+
+    std::mutex resultMutex;
+    ResultCallback resultCallback;
+};
@@ -4,7 +4,6 @@
 #include <FL/Fl_Text_Display.H>
 #include <FL/Fl_Text_Buffer.H>
 #include <memory>
-#include <FL/Fl_Double_Window.H>
 #include <FL/Fl.H>
 
 AboutView::AboutView() : model(nullptr), textBuffer(nullptr), textDisplay(nullptr), backBtn(nullptr) {
@@ -15,25 +14,20 @@ AboutView::~AboutView() {
     // Сначала очищаем callback, чтобы избежать вызовов после удаления
     backCallbackFunc = nullptr;
     
-    // Удаляем виджеты
-    if (window) {
-        window->hide();
-        
-        // Удаляем все виджеты
-        window->clear();
-        
-        // Удаляем текстовый буфер отдельно, так как он не является виджетом
-        if (textBuffer) {
-            delete textBuffer;
-            textBuffer = nullptr;
-        }
+    // Виджеты удалит окно SceneManager; текстовый буфер не виджет, его удаляем сами
+    if (backBtn) {
+        backBtn->callback(nullptr, nullptr);
+    }
+    if (textDisplay) {
+        textDisplay->buffer(nullptr);
     }
+    delete textBuffer;
+    textBuffer = nullptr;
 }
 
-void AboutView::setupUI() {
-    window = std::make_unique<Fl_Double_Window>(WINDOW_WIDTH, WINDOW_HEIGHT, "О программе");
-    window->size_range(WINDOW_WIDTH, WINDOW_HEIGHT, WINDOW_WIDTH, WINDOW_HEIGHT);
-    window->callback(windowCallback, this);
+void AboutView::setupUI(SceneManager& sceneManager) {
+    scenes = &sceneManager;
+    scene = new Fl_Group(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
     
     createContent();
     
@@ -41,7 +35,14 @@ void AboutView::setupUI() {
     model = std::make_unique<AboutModel>();
     updateContent();
     
-    window->end();
+    scene->end();
+    scenes->addScene(scene, "О программе");
+    // Esc возвращает в меню, как раньше закрытие отдельного окна
+    scenes->setEscapeHandler(scene, [this]() {
+        if (backCallbackFunc) {
+            scheduleCallback(backCallbackFunc);
+        }
+    });
 }
 
 void AboutView::createContent() {
@@ -70,20 +71,15 @@ void AboutView::updateContent() {
 }
 
 void AboutView::show() {
-    if (window) {
-        window->show();
+    if (scenes) {
+        scenes->showScene(scene);
     }
 }
 
 void AboutView::hide() {
-    if (window) {
-        // Отключаем все обработчики событий
-        if (backBtn) {
-            backBtn->callback(nullptr, nullptr);
-        }
-        
-        // Скрываем окно
-        window->hide();
+    // Сцена остается в окне и будет показана снова, поэтому обработчик кнопки сохраняется
+    if (scenes) {
+        scenes->hideScene(scene);
     }
 }
 
@@ -104,13 +100,6 @@ void AboutView::backCallback(Fl_Widget*, void* data) {
     }
 }
 
-void AboutView::windowCallback(Fl_Widget* w, void* data) {
-    AboutView* view = static_cast<AboutView*>(data);
-    if (view && view->backCallbackFunc) {
-        view->scheduleCallback(view->backCallbackFunc);
-    }
-}
-
 void AboutView::scheduledCallbackHandler(void* data) {
     auto callback = static_cast<CallbackFunc*>(data);
     if (callback) {
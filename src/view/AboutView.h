@@ -12,7 +12,7 @@ public:
     AboutView();
     ~AboutView();
     
-    void setupUI() override;
+    void setupUI(SceneManager& scenes) override;
     void show() override;
     void hide() override;
     void scheduleCallback(CallbackFunc callback) override;
@@ -24,7 +24,6 @@ private:
     void updateContent();
     
     static void backCallback(Fl_Widget*, void*);
-    static void windowCallback(Fl_Widget*, void*);
     static void scheduledCallbackHandler(void* data);
     
     std::unique_ptr<AboutModel> model;
@@ -1,5 +1,6 @@
 #pragma once
-#include <FL/Fl_Double_Window.H>
+#include "SceneManager.h"
+#include <FL/Fl_Group.H>
 #include <functional>
 #include <memory>
 
@@ -8,11 +9,12 @@ public:
     using CallbackFunc = std::function<void()>;
     
     virtual ~BaseView() = default;
-    virtual void setupUI() = 0;
+    virtual void setupUI(SceneManager& scenes) = 0; // Создает сцену представления в общем окне
     virtual void show() = 0;
     virtual void hide() = 0;
     virtual void scheduleCallback(CallbackFunc callback) = 0;
 
 protected:
-    std::unique_ptr<Fl_Double_Window> window;
+    SceneManager* scenes = nullptr;
+    Fl_Group* scene = nullptr; // Принадлежит окну SceneManager
 };
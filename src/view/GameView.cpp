@@ -1,12 +1,11 @@
 #include "GameView.h"
 #include "../model/GameModel.h"
 #include "../model/Tank.h"
-#include "../model/Bullet.h"
+#include "../common/AllocationTracker.h"
+#include "../common/TraceEvents.h"
 #include <FL/fl_draw.H>
 #include <FL/Enumerations.H>
 #include <FL/Fl.H>
-#include <sstream>
-#include <iomanip>
 #include <cmath>
 #include <memory>
 #include "../model/TileType.h"
@@ -20,50 +19,71 @@ GameView::~GameView() {
     // Останавливаем все таймеры и игровой цикл
     stopGame();
     stopResultsTimer();
+    Fl::remove_timeout(scheduledCallbackHandler, this);
     
     // Очищаем callback'и
     keyPressCallbackFunc = nullptr;
+    keyReleaseCallbackFunc = nullptr;
+    focusLostCallbackFunc = nullptr;
+    tickCallbackFunc = nullptr;
     gameOverCallbackFunc = nullptr;
     
-    // Скрываем окно
-    if (window) {
-        window->hide();
+    // Сцену удалит окно SceneManager; до тех пор она не должна обращаться к представлению
+    if (scene) {
+        static_cast<GameScene*>(scene)->setView(nullptr);
     }
 }
 
-void GameView::setupUI() {
-    // Размеры окна будут установлены после загрузки модели
-    window = std::make_unique<GameWindow>(1200, 900, "Tanks Game");
+void GameView::setupUI(SceneManager& sceneManager) {
+    // Размеры сцены будут установлены после загрузки модели
+    scenes = &sceneManager;
+    GameScene* gameScene = new GameScene(1200, 900);
+    gameScene->end();
     
     // Настраиваем обработку событий
-    static_cast<GameWindow*>(window.get())->setView(this);
+    gameScene->setView(this);
+    scene = gameScene;
+    scenes->addScene(scene, "Tanks Game");
+}
+
+void GameView::preloadFonts() {
+    const std::pair<Fl_Font, int> fonts[] = {
+        {FL_HELVETICA_BOLD, 20}, {FL_HELVETICA_BOLD, 48}, {FL_HELVETICA, 32}, {FL_HELVETICA, 24}, {FL_COURIER, 14},
+    };
+    for (const auto& font : fonts) {
+        fl_font(font.first, font.second);
+        fl_width("0"); // Шрифт загружается при первом измерении
+    }
 }
 
 void GameView::show() {
-    if (window) {
-        window->show();
+    if (scenes) {
+        scenes->showScene(scene);
+        Fl::focus(scene); // Клавиши идут в сцену игры, а не в окно
     }
 }
 
 void GameView::hide() {
     stopGame();
     stopResultsTimer();
-    if (window) {
-        window->hide();
+    if (scenes) {
+        scenes->hideScene(scene);
     }
 }
 
 void GameView::scheduleCallback(CallbackFunc callback) {
     if (callback) {
-        Fl::add_timeout(0.01, scheduledCallbackHandler, new CallbackFunc(callback));
+        // Обработчики хранятся в очереди представления, а не в куче по одному
+        scheduledCallbacks.push_back(std::move(callback));
+        Fl::add_timeout(0.01, scheduledCallbackHandler, this);
     }
 }
 
 void GameView::setModel(GameModel* model) {
     gameModel = model;
     
-    if (gameModel && window) {
-        // Подгоняем размер окна под карту
+    if (gameModel && scenes) {
+        // Подгоняем размер сцены (и окна, когда она показана) под карту
         const GameMap& map = gameModel->getMap();
         int gamePixelWidth = static_cast<int>(map.getWidth() * GameModel::TILE_SIZE);
         int gamePixelHeight = static_cast<int>(map.getHeight() * GameModel::TILE_SIZE);
@@ -75,8 +95,7 @@ void GameView::setModel(GameModel* model) {
         int minWidth = std::max(newWidth, 800);
         int minHeight = std::max(newHeight, 600);
         
-        window->resize(window->x(), window->y(), minWidth, minHeight);
-        window->size_range(minWidth, minHeight, minWidth, minHeight);
+        scenes->resizeScene(scene, minWidth, minHeight);
     }
 }
 
@@ -86,6 +105,9 @@ void GameView::startGame() {
         showResults = false;
         playerFinalScore = 0;
         resultsDisplayTime = 0.0;
+#ifdef ARCADE_TRACK_ALLOCATIONS
+        AllocationTracker::skipFrames(ALLOCATION_WARMUP_FRAMES); // Первые тики партии заполняют буферы
+#endif
         Fl::add_timeout(0.016, gameLoopCallback, this);
     }
 }
@@ -108,6 +130,22 @@ void GameView::setKeyPressCallback(KeyCallbackFunc cb) {
     keyPressCallbackFunc = std::move(cb);
 }
 
+void GameView::setKeyReleaseCallback(KeyCallbackFunc cb) {
+    keyReleaseCallbackFunc = std::move(cb);
+}
+
+void GameView::setFocusLostCallback(CallbackFunc cb) {
+    focusLostCallbackFunc = std::move(cb);
+}
+
+void GameView::setTickCallback(CallbackFunc cb) {
+    tickCallbackFunc = std::move(cb);
+}
+
+void GameView::setSimulationEnabled(bool enabled) {
+    simulationEnabled = enabled;
+}
+
 void GameView::setGameOverCallback(CallbackFunc cb) {
     gameOverCallbackFunc = std::move(cb);
 }
@@ -119,19 +157,33 @@ bool GameView::handleKeyPress(int key) {
     return false;
 }
 
+bool GameView::handleKeyRelease(int key) {
+    if (keyReleaseCallbackFunc) {
+        return keyReleaseCallbackFunc(key);
+    }
+    return false;
+}
+
 void GameView::draw() {
     if (!gameModel) return;
+    ARCADE_TRACE_ZONE("GameView::draw");
+    ARCADE_ALLOC_PHASE("draw");
+    frameArena.reset(); // Строки прошлого кадра уже нарисованы
     
     // Очищаем фон
     fl_color(FL_BLACK);
-    fl_rectf(0, 0, window->w(), window->h());
+    fl_rectf(0, 0, scene->w(), scene->h());
 
-    // Рисуем карту
+    // Рисуем карту; поврежденные стены темнеют по мере потери прочности
     const GameMap& map = gameModel->getMap();
+    const DestructibleWalls& walls = gameModel->getWalls();
     for (int r = 0; r < map.getHeight(); ++r) {
         for (int c = 0; c < map.getWidth(); ++c) {
             if (map.getTile(c, r) == TileType::Wall) {
-                fl_color(FL_BLUE);
+                const int damage = walls.getDamage(c, r);
+                fl_color(damage > 0 ? fl_color_average(FL_BLACK, FL_BLUE,
+                                                       0.7f * damage / walls.getWallHealth())
+                                    : FL_BLUE);
                 fl_rectf(static_cast<int>(c * GameModel::TILE_SIZE), 
                         static_cast<int>(r * GameModel::TILE_SIZE), 
                         static_cast<int>(GameModel::TILE_SIZE), 
@@ -146,11 +198,15 @@ void GameView::draw() {
             // Проверяем тип объекта и рисуем соответственно
             if (Tank* tank = dynamic_cast<Tank*>(obj.get())) {
                 drawTank(tank);
-            } else if (Bullet* bullet = dynamic_cast<Bullet*>(obj.get())) {
-                drawBullet(bullet);
             }
         }
     }
+    const BulletArray& bullets = gameModel->getBullets();
+    for (size_t i = 0; i < bullets.size(); ++i) {
+        if (!bullets.isDestroyed(i)) {
+            drawBullet(bullets, i);
+        }
+    }
 
     // Рисуем HUD
     drawHUD();
@@ -161,9 +217,96 @@ void GameView::draw() {
     // Рисуем экран результатов
     if (showResults) {
         drawResultsScreen();
+    } else if (profilerOverlayVisible) {
+        drawProfilerOverlay();
+    }
+
+    recordInputLatency();
+}
+
+void GameView::recordInputLatency() {
+    // Первый кадр после тика, применившего новое событие ввода, завершает замер
+    const InputTiming& timing = gameModel->getInputTiming();
+    if (timing.sequence != presentedInputSequence) {
+        presentedInputSequence = timing.sequence;
+        if (timing.sequence != 0) {
+            latencyTracker.record(timing.eventTime, timing.tickTime, LatencyTracker::Clock::now());
+        }
+    }
+}
+
+void GameView::toggleProfilerOverlay() {
+    profilerOverlayVisible = !profilerOverlayVisible;
+    if (scene) {
+        scene->redraw();
     }
 }
 
+bool GameView::dumpLatencyReport(const std::string& filename) const {
+    return latencyTracker.dumpToFile(filename);
+}
+
+void GameView::drawProfilerOverlay() {
+    const int overlayW = 330;
+#ifdef ARCADE_TRACK_ALLOCATIONS
+    const int overlayH = 200;
+#else
+    const int overlayH = 180;
+#endif
+    const int overlayX = scene->w() - overlayW - 10;
+    const int overlayY = HUD_AREA_HEIGHT;
+
+    fl_color(FL_BLACK);
+    fl_rectf(overlayX, overlayY, overlayW, overlayH);
+    fl_color(FL_WHITE);
+    fl_rect(overlayX, overlayY, overlayW, overlayH);
+
+    fl_font(FL_COURIER, 14);
+    int lineY = overlayY + 20;
+    fl_draw("Задержка ввода, мс: p50 / p95 / p99", overlayX + 10, lineY);
+
+    const std::pair<const char*, LatencyTracker::Stage> rows[] = {
+        {"ввод->тик ", LatencyTracker::Stage::InputToTick},
+        {"тик->кадр ", LatencyTracker::Stage::TickToDraw},
+        {"итого     ", LatencyTracker::Stage::Total},
+    };
+    for (const auto& row : rows) {
+        LatencyTracker::Percentiles p = latencyTracker.getPercentiles(row.second);
+        lineY += 20;
+        fl_draw(frameArena.format("%s%.1f / %.1f / %.1f", row.first, p.p50, p.p95, p.p99), overlayX + 10, lineY);
+    }
+
+    lineY += 20;
+    fl_draw(frameArena.format("замеров: %zu  (F4 - в файл)", latencyTracker.getSampleCount()), overlayX + 10, lineY);
+
+    // Временная память: тик модели и предыдущая перерисовка (текущая еще идет)
+    const FrameArena& tickArena = gameModel->getFrameArena();
+    lineY += 20;
+    fl_draw(frameArena.format("тик:  %zu выд., %zu Б, куча %zu", tickArena.getLastFrame().allocations,
+                              tickArena.getLastFrame().bytes, tickArena.getLastFrame().heapAllocations),
+            overlayX + 10, lineY);
+    lineY += 20;
+    fl_draw(frameArena.format("кадр: %zu выд., %zu Б, куча %zu", frameArena.getLastFrame().allocations,
+                              frameArena.getLastFrame().bytes, frameArena.getLastFrame().heapAllocations),
+            overlayX + 10, lineY);
+
+    // Планировщик ИИ: сколько врагов не уложилось в бюджет и насколько устарели решения
+    const AiScheduler::Stats& ai = gameModel->getAiScheduler().getStats();
+    lineY += 20;
+    fl_draw(frameArena.format("ИИ: %d+%d отл., %lld мкс, возраст %.1f/%llu", ai.thought, ai.deferred,
+                              static_cast<long long>(ai.elapsedMicroseconds), ai.meanStaleness,
+                              static_cast<unsigned long long>(ai.maxStaleness)),
+            overlayX + 10, lineY);
+#ifdef ARCADE_TRACK_ALLOCATIONS
+    // Все operator new прошлого кадра, а не только то, что прошло мимо арен
+    const AllocationTracker::Usage heap = AllocationTracker::getLastFrame().total;
+    lineY += 20;
+    fl_draw(frameArena.format("new:  %llu выд., %llu Б", static_cast<unsigned long long>(heap.allocations),
+                              static_cast<unsigned long long>(heap.bytes)),
+            overlayX + 10, lineY);
+#endif
+}
+
 void GameView::drawTank(const Tank* tank) {
     if (!tank) return;
     
@@ -203,11 +346,9 @@ void GameView::drawTank(const Tank* tank) {
     }
 }
 
-void GameView::drawBullet(const Bullet* bullet) {
-    if (!bullet) return;
-    
-    fl_color(bullet->isFromPlayer() ? FL_YELLOW : FL_MAGENTA);
-    fl_circle(static_cast<int>(bullet->getX()), static_cast<int>(bullet->getY()), 6);
+void GameView::drawBullet(const BulletArray& bullets, size_t index) {
+    fl_color(bullets.isFromPlayer(index) ? FL_YELLOW : FL_MAGENTA);
+    fl_circle(static_cast<int>(bullets.getX(index)), static_cast<int>(bullets.getY(index)), 6);
 }
 
 void GameView::drawHealthBar(const Tank* tank) {
@@ -260,17 +401,13 @@ void GameView::drawHUD() {
     fl_font(FL_HELVETICA_BOLD, 20);
     
     // Счет
-    std::string scoreText = "Очки: " + std::to_string(gameModel->getScore());
-    fl_draw(scoreText.c_str(), 15, 35);
+    fl_draw(frameArena.format("Очки: %d", gameModel->getScore()), 15, 35);
     
     // Здоровье
-    std::string healthText = "Жизни: " + std::to_string(gameModel->getPlayerHealth());
-    fl_draw(healthText.c_str(), 200, 35);
+    fl_draw(frameArena.format("Жизни: %d", gameModel->getPlayerHealth()), 200, 35);
     
     // FPS
-    std::ostringstream fpsStream;
-    fpsStream << "FPS: " << std::fixed << std::setprecision(1) << gameModel->getFPS();
-    fl_draw(fpsStream.str().c_str(), window->w() - 120, 35);
+    fl_draw(frameArena.format("FPS: %.1f", gameModel->getFPS()), scene->w() - 120, 35);
 }
 
 void GameView::drawGameStateMessages() {
@@ -279,62 +416,77 @@ void GameView::drawGameStateMessages() {
         fl_font(FL_HELVETICA_BOLD, 48);
         const char* pauseMsg = "ПАУЗА";
         int msgW = static_cast<int>(fl_width(pauseMsg));
-        fl_draw(pauseMsg, (window->w() - msgW)/2, window->h()/2);
+        fl_draw(pauseMsg, (scene->w() - msgW)/2, scene->h()/2);
     } else if (gameModel->getState() == GameState::GAME_OVER && !showResults) {
         fl_color(FL_RED);
         fl_font(FL_HELVETICA_BOLD, 48);
         const char* gameOverMsg = "ИГРА ОКОНЧЕНА";
         int msgW_go = static_cast<int>(fl_width(gameOverMsg));
-        fl_draw(gameOverMsg, (window->w() - msgW_go)/2, window->h()/2 - 30);
+        fl_draw(gameOverMsg, (scene->w() - msgW_go)/2, scene->h()/2 - 30);
         
         fl_color(FL_WHITE);
         fl_font(FL_HELVETICA, 32);
-        std::string finalScore = "Ваш счет: " + std::to_string(gameModel->getScore());
-        int msgW_fs = static_cast<int>(fl_width(finalScore.c_str()));
-        fl_draw(finalScore.c_str(), (window->w() - msgW_fs)/2, window->h()/2 + 35);
+        const char* finalScore = frameArena.format("Ваш счет: %d", gameModel->getScore());
+        int msgW_fs = static_cast<int>(fl_width(finalScore));
+        fl_draw(finalScore, (scene->w() - msgW_fs)/2, scene->h()/2 + 35);
     }
 }
 
 void GameView::drawResultsScreen() {
     // Черный фон
     fl_color(FL_BLACK);
-    fl_rectf(0, 0, window->w(), window->h());
+    fl_rectf(0, 0, scene->w(), scene->h());
     
     // Текст результатов
     fl_color(FL_WHITE);
     fl_font(FL_HELVETICA_BOLD, 48);
     
-    std::string gameOverText = "ИГРА ОКОНЧЕНА";
-    int textWidth_go = static_cast<int>(fl_width(gameOverText.c_str()));
-    fl_draw(gameOverText.c_str(), (window->w() - textWidth_go) / 2, window->h() / 2 - 80);
+    const char* gameOverText = "ИГРА ОКОНЧЕНА";
+    int textWidth_go = static_cast<int>(fl_width(gameOverText));
+    fl_draw(gameOverText, (scene->w() - textWidth_go) / 2, scene->h() / 2 - 80);
     
-    std::string scoreMsgText = "Счет: " + std::to_string(playerFinalScore);
-    int textWidth_score = static_cast<int>(fl_width(scoreMsgText.c_str()));
-    fl_draw(scoreMsgText.c_str(), (window->w() - textWidth_score) / 2, window->h() / 2 - 15);
+    const char* scoreMsgText = frameArena.format("Счет: %d", playerFinalScore);
+    int textWidth_score = static_cast<int>(fl_width(scoreMsgText));
+    fl_draw(scoreMsgText, (scene->w() - textWidth_score) / 2, scene->h() / 2 - 15);
     
     // Таймер обратного отсчета
     int secondsLeft = static_cast<int>(std::floor(3.0 - resultsDisplayTime)) + 1;
     if (secondsLeft < 1) secondsLeft = 1;
-    std::string timerText = "Возврат в меню через: " + std::to_string(secondsLeft);
+    const char* timerText = frameArena.format("Возврат в меню через: %d", secondsLeft);
     fl_font(FL_HELVETICA, 24);
-    int textWidth_timer = static_cast<int>(fl_width(timerText.c_str()));
-    fl_draw(timerText.c_str(), (window->w() - textWidth_timer) / 2, window->h() / 2 + 50);
+    int textWidth_timer = static_cast<int>(fl_width(timerText));
+    fl_draw(timerText, (scene->w() - textWidth_timer) / 2, scene->h() / 2 + 50);
 }
 
 void GameView::gameLoopCallback(void* data) {
+    ARCADE_TRACE_ZONE("gameLoopCallback");
+#ifdef ARCADE_TRACK_ALLOCATIONS
+    // Кадр - от тика до тика: сюда входят отрисовка и обработчики событий между ними
+    AllocationTracker::endFrame();
+#endif
+    ARCADE_ALLOC_PHASE("callbacks");
     GameView* view = static_cast<GameView*>(data);
     if (!view || !view->gameLoopRunning || !view->gameModel) {
         return;
     }
 
-    // Обновляем модель только если игра идет
-    if (view->gameModel->getState() == GameState::PLAYING) {
+    if (!view->simulationEnabled) {
+        // Состояние приходит извне (сетевая игра): модель обновляет обработчик тика
+        if (view->tickCallbackFunc) {
+            view->tickCallbackFunc();
+        }
+    } else if (view->gameModel->getState() == GameState::PLAYING) {
+        // Обновляем модель только если игра идет.
+        // Ввод опрашивается ровно один раз за тик, прямо перед симуляцией
+        if (view->tickCallbackFunc) {
+            view->tickCallbackFunc();
+        }
         view->gameModel->update();
     }
     
     // Проверяем, что окно еще существует перед перерисовкой
-    if (view->window) {
-        view->window->redraw();
+    if (view->scene) {
+        view->scene->redraw();
     }
 
     // Проверяем окончание игры
@@ -358,6 +510,8 @@ void GameView::gameLoopCallback(void* data) {
 }
 
 void GameView::resultsCallback(void* data) {
+    ARCADE_TRACE_ZONE("resultsCallback");
+    ARCADE_ALLOC_PHASE("callbacks");
     GameView* view = static_cast<GameView*>(data);
     if (!view || !view->showResults) {
         return;
@@ -366,8 +520,8 @@ void GameView::resultsCallback(void* data) {
     view->resultsDisplayTime += 0.1;
     
     // Проверяем, что окно еще существует перед перерисовкой
-    if (view->window) {
-        view->window->redraw();
+    if (view->scene) {
+        view->scene->redraw();
     }
     
     if (view->resultsDisplayTime < 3.0) {
@@ -384,35 +538,65 @@ void GameView::resultsCallback(void* data) {
 }
 
 void GameView::scheduledCallbackHandler(void* data) {
-    auto callback = static_cast<CallbackFunc*>(data);
-    if (callback) {
-        (*callback)();
-        delete callback;
+    ARCADE_TRACE_ZONE("scheduledCallback");
+    ARCADE_ALLOC_PHASE("callbacks");
+    GameView* view = static_cast<GameView*>(data);
+    if (!view || view->nextScheduledCallback >= view->scheduledCallbacks.size()) {
+        return;
     }
+    CallbackFunc callback = std::move(view->scheduledCallbacks[view->nextScheduledCallback++]);
+    if (view->nextScheduledCallback == view->scheduledCallbacks.size()) {
+        view->scheduledCallbacks.clear();
+        view->nextScheduledCallback = 0;
+    }
+    // Обработчик может удалить представление, поэтому после вызова его поля не используются
+    callback();
 }
 
-// Вложенный класс GameWindow
-GameView::GameWindow::GameWindow(int w, int h, const char* title)
-    : Fl_Double_Window(w, h, title), view(nullptr) {}
+// Вложенный класс GameScene
+GameView::GameScene::GameScene(int w, int h)
+    : Fl_Group(0, 0, w, h), view(nullptr) {}
 
-void GameView::GameWindow::setView(GameView* v) {
+void GameView::GameScene::setView(GameView* v) {
     view = v;
 }
 
-int GameView::GameWindow::handle(int event) {
-    if (view && event == FL_KEYDOWN) {
-        int key = Fl::event_key();
-        if (view->handleKeyPress(key)) {
-            return 1;
+int GameView::GameScene::handle(int event) {
+    if (view) {
+        view->eventTime = LatencyTracker::Clock::now(); // Начало замера задержки ввода
+        switch (event) {
+            case FL_KEYDOWN:
+                if (view->handleKeyPress(Fl::event_key())) {
+                    return 1;
+                }
+                break;
+            case FL_KEYUP:
+                if (view->handleKeyRelease(Fl::event_key())) {
+                    return 1;
+                }
+                break;
+            case FL_PUSH:
+                Fl::focus(this); // Щелчок по сцене возвращает ей клавиатуру
+                return 1;
+            case FL_FOCUS:
+                return 1; // Принимаем фокус, чтобы получать и отпускания клавиш
+            case FL_UNFOCUS:
+                // Отпускания клавиш вне окна не придут - сбрасываем все нажатия
+                if (view->focusLostCallbackFunc) {
+                    view->focusLostCallbackFunc();
+                }
+                return 1;
+            default:
+                break;
         }
     }
-    return Fl_Double_Window::handle(event);
+    return Fl_Group::handle(event);
 }
 
-void GameView::GameWindow::draw() {
+void GameView::GameScene::draw() {
     if (view) {
         view->draw();
     } else {
-        Fl_Double_Window::draw();
+        Fl_Group::draw();
     }
 }
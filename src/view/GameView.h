@@ -1,11 +1,16 @@
 #pragma once
 #include "BaseView.h"
-#include <FL/Fl_Double_Window.H>
+#include "../common/FrameArena.h"
+#include "../common/LatencyTracker.h"
+#include <FL/Fl_Group.H>
 #include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
 class GameModel;
 class Tank;
-class Bullet;
+class BulletArray;
 
 class GameView : public BaseView {
 public:
@@ -14,7 +19,9 @@ public:
     GameView();
     ~GameView();
     
-    void setupUI() override;
+    void setupUI(SceneManager& scenes) override;
+    // Загружает шрифты HUD заранее, чтобы первый кадр игры не ждал их с диска
+    static void preloadFonts();
     void show() override;
     void hide() override;
     void scheduleCallback(CallbackFunc callback) override;
@@ -25,16 +32,27 @@ public:
     void stopResultsTimer();
     
     void setKeyPressCallback(KeyCallbackFunc cb);
+    void setKeyReleaseCallback(KeyCallbackFunc cb);
+    void setFocusLostCallback(CallbackFunc cb);
+    void setTickCallback(CallbackFunc cb); // Вызывается перед каждым обновлением модели
     void setGameOverCallback(CallbackFunc cb);
+    // false - модель не симулируется в цикле, тик только вызывает обработчик (клиент сетевой игры)
+    void setSimulationEnabled(bool enabled);
     
     bool handleKeyPress(int key);
+    bool handleKeyRelease(int key);
     void draw();
 
+    // Время получения окном обрабатываемого сейчас события
+    LatencyTracker::Clock::time_point getEventTime() const { return eventTime; }
+    void toggleProfilerOverlay();
+    bool dumpLatencyReport(const std::string& filename) const;
+
 private:
-    // Вложенный класс для окна игры
-    class GameWindow : public Fl_Double_Window {
+    // Вложенный класс для сцены игры: рисует модель и принимает клавиатуру
+    class GameScene : public Fl_Group {
     public:
-        GameWindow(int w, int h, const char* title);
+        GameScene(int w, int h);
         void setView(GameView* view);
         int handle(int event) override;
         void draw() override;
@@ -44,11 +62,13 @@ private:
     };
     
     void drawTank(const Tank* tank);
-    void drawBullet(const Bullet* bullet);
+    void drawBullet(const BulletArray& bullets, size_t index);
     void drawHealthBar(const Tank* tank);
     void drawHUD();
     void drawGameStateMessages();
     void drawResultsScreen();
+    void drawProfilerOverlay();
+    void recordInputLatency();
     
     static void gameLoopCallback(void* data);
     static void resultsCallback(void* data);
@@ -56,9 +76,24 @@ private:
     
     GameModel* gameModel;
     bool gameLoopRunning;
+    bool simulationEnabled = true;
     
     KeyCallbackFunc keyPressCallbackFunc;
+    KeyCallbackFunc keyReleaseCallbackFunc;
+    CallbackFunc focusLostCallbackFunc;
+    CallbackFunc tickCallbackFunc;
     CallbackFunc gameOverCallbackFunc;
+    // Отложенные вызовы scheduleCallback по порядку; буфер не освобождается между вызовами
+    std::vector<CallbackFunc> scheduledCallbacks;
+    size_t nextScheduledCallback = 0;
+
+    FrameArena frameArena; // Строки и буферы одной перерисовки
+    
+    // Замер задержки ввода
+    LatencyTracker latencyTracker;
+    LatencyTracker::Clock::time_point eventTime;
+    uint64_t presentedInputSequence = 0;
+    bool profilerOverlayVisible = false;
     
     // Экран результатов
     bool showResults;
@@ -66,4 +101,5 @@ private:
     double resultsDisplayTime;
     
     static constexpr int HUD_AREA_HEIGHT = 60;
+    static constexpr int ALLOCATION_WARMUP_FRAMES = 60; // Тики новой партии вне бюджета выделений
 };
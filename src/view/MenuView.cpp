@@ -1,6 +1,5 @@
 #include "MenuView.h"
 #include <FL/Fl_Button.H>
-#include <FL/Fl_Double_Window.H>
 #include <FL/Fl.H>
 #include <memory>
 
@@ -15,22 +14,21 @@ MenuView::~MenuView() {
     aboutCallbackFunc = nullptr;
     exitCallbackFunc = nullptr;
     
-    // Удаляем виджеты
-    if (window) {
-        window->hide();
-        window->clear();
-    }
+    // Кнопки принадлежат сцене, а сцена - окну SceneManager: отключаем только обработчики
+    if (newGameBtn) newGameBtn->callback(nullptr, nullptr);
+    if (aboutBtn) aboutBtn->callback(nullptr, nullptr);
+    if (exitBtn) exitBtn->callback(nullptr, nullptr);
 }
 
-void MenuView::setupUI() {
-    // Создаем окно
-    window = std::make_unique<Fl_Double_Window>(WINDOW_WIDTH, WINDOW_HEIGHT, "Tanks Game - Меню");
-    window->size_range(WINDOW_WIDTH, WINDOW_HEIGHT, WINDOW_WIDTH, WINDOW_HEIGHT);
+void MenuView::setupUI(SceneManager& sceneManager) {
+    scenes = &sceneManager;
+    scene = new Fl_Group(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
     
     // Создаем кнопки
     createButtons();
     
-    window->end();
+    scene->end();
+    scenes->addScene(scene, "Tanks Game - Меню");
 }
 
 void MenuView::createButtons() {
@@ -51,20 +49,15 @@ void MenuView::createButtons() {
 }
 
 void MenuView::show() {
-    if (window) {
-        window->show();
+    if (scenes) {
+        scenes->showScene(scene);
     }
 }
 
 void MenuView::hide() {
-    if (window) {
-        // Отключаем все обработчики событий
-        if (newGameBtn) newGameBtn->callback(nullptr, nullptr);
-        if (aboutBtn) aboutBtn->callback(nullptr, nullptr);
-        if (exitBtn) exitBtn->callback(nullptr, nullptr);
-        
-        // Скрываем окно
-        window->hide();
+    // Сцена остается в окне и будет показана снова, поэтому обработчики кнопок сохраняются
+    if (scenes) {
+        scenes->hideScene(scene);
     }
 }
 
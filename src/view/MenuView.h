@@ -9,7 +9,7 @@ public:
     MenuView();
     ~MenuView();
     
-    void setupUI() override;
+    void setupUI(SceneManager& scenes) override;
     void show() override;
     void hide() override;
     void scheduleCallback(CallbackFunc callback) override;
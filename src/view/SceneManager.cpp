@@ -0,0 +1,109 @@
+#include "SceneManager.h"
+#include <FL/Fl.H>
+
+SceneManager::SceneManager() {
+    window = std::make_unique<SceneWindow>(400, 400, "Tanks Game");
+    window->end();
+    window->resizable(nullptr); // Размер задает сцена, а не пользователь
+    window->callback(windowCallback, this);
+}
+
+SceneManager::~SceneManager() {
+    // Сцены удаляются вместе с окном
+    window->hide();
+}
+
+void SceneManager::SceneWindow::draw() {
+    Fl_Double_Window::draw();
+    if (onFirstDraw) {
+        auto handler = std::move(onFirstDraw);
+        onFirstDraw = nullptr;
+        handler();
+    }
+}
+
+void SceneManager::setFirstDrawHandler(std::function<void()> handler) {
+    window->onFirstDraw = std::move(handler);
+}
+
+SceneManager::Scene* SceneManager::find(Fl_Group* scene) {
+    for (auto& entry : scenes) {
+        if (entry.group == scene) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void SceneManager::addScene(Fl_Group* scene, const char* title) {
+    if (!scene || find(scene)) {
+        return;
+    }
+    scene->resizable(nullptr); // Виджеты сцены не растягиваются вместе с ней
+    scene->hide();
+    window->add(scene);
+    scenes.push_back(Scene{scene, title ? title : "", nullptr});
+}
+
+void SceneManager::fitWindow(Fl_Group* scene) {
+    window->size_range(scene->w(), scene->h(), scene->w(), scene->h());
+    if (window->w() != scene->w() || window->h() != scene->h()) {
+        window->size(scene->w(), scene->h());
+    }
+}
+
+void SceneManager::showScene(Fl_Group* scene) {
+    Scene* entry = find(scene);
+    if (!entry) {
+        return;
+    }
+    if (current && current != scene) {
+        current->hide();
+    }
+    current = scene;
+    window->label(entry->title.c_str());
+    fitWindow(scene);
+    scene->show();
+    if (!window->shown()) {
+        window->show();
+    }
+    window->redraw();
+}
+
+void SceneManager::hideScene(Fl_Group* scene) {
+    if (scene) {
+        scene->hide();
+    }
+    if (current == scene) {
+        current = nullptr;
+    }
+}
+
+void SceneManager::resizeScene(Fl_Group* scene, int width, int height) {
+    if (!scene) {
+        return;
+    }
+    scene->resize(0, 0, width, height);
+    if (current == scene) {
+        fitWindow(scene);
+    }
+}
+
+void SceneManager::setEscapeHandler(Fl_Group* scene, EscapeHandler handler) {
+    if (Scene* entry = find(scene)) {
+        entry->onEscape = std::move(handler);
+    }
+}
+
+void SceneManager::windowCallback(Fl_Widget*, void* data) {
+    SceneManager* manager = static_cast<SceneManager*>(data);
+    // FLTK вызывает обработчик окна и по Esc, и по кнопке закрытия: Esc отдается сцене
+    if (Fl::event() == FL_SHORTCUT && Fl::event_key() == FL_Escape) {
+        Scene* entry = manager->current ? manager->find(manager->current) : nullptr;
+        if (entry && entry->onEscape) {
+            entry->onEscape();
+        }
+        return;
+    }
+    manager->window->hide(); // Закрытие окна завершает Fl::run()
+}
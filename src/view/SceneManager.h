@@ -0,0 +1,57 @@
+#pragma once
+#include <FL/Fl_Double_Window.H>
+#include <FL/Fl_Group.H>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Единственное окно приложения и сцены в нем. Сцена - Fl_Group во все окно
+// (меню, игра, "О программе"); переход между экранами скрывает одну группу и
+// показывает другую, окно при этом не пересоздается. Группы принадлежат окну
+class SceneManager {
+public:
+    using EscapeHandler = std::function<void()>;
+
+    SceneManager();
+    ~SceneManager();
+    SceneManager(const SceneManager&) = delete;
+    SceneManager& operator=(const SceneManager&) = delete;
+
+    // Передает окну созданную сцену (группу без родителя, уже закрытую end()).
+    // Окно принимает размер сцены, когда она показана
+    void addScene(Fl_Group* scene, const char* title);
+    void showScene(Fl_Group* scene);
+    void hideScene(Fl_Group* scene); // Окно остается; следующая сцена покажется в нем же
+    void resizeScene(Fl_Group* scene, int width, int height);
+    // Esc в окне: обработчик текущей сцены, без него клавиша игнорируется
+    void setEscapeHandler(Fl_Group* scene, EscapeHandler handler);
+    // Вызывается один раз после первой отрисовки окна (трасса запуска, отложенная инициализация)
+    void setFirstDrawHandler(std::function<void()> handler);
+
+    Fl_Group* getCurrentScene() const { return current; }
+    Fl_Double_Window* getWindow() const { return window.get(); }
+
+private:
+    // Окно сообщает о первой отрисовке
+    class SceneWindow : public Fl_Double_Window {
+    public:
+        SceneWindow(int w, int h, const char* title) : Fl_Double_Window(w, h, title) {}
+        void draw() override;
+        std::function<void()> onFirstDraw;
+    };
+
+    struct Scene {
+        Fl_Group* group;
+        std::string title;
+        EscapeHandler onEscape;
+    };
+
+    Scene* find(Fl_Group* scene);
+    void fitWindow(Fl_Group* scene);
+    static void windowCallback(Fl_Widget* widget, void* data);
+
+    std::unique_ptr<SceneWindow> window;
+    std::vector<Scene> scenes;
+    Fl_Group* current = nullptr;
+};
@@ -0,0 +1,56 @@
+// Пропускная способность пакетного API сред для обучения ботов на случайных действиях.
+// Использование: batch-env-benchmark [карта] [число сред] [шагов] [потоков]
+#include "server/BatchEnvironment.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+int main(int argc, char** argv) {
+    BatchEnvironmentConfig config;
+    config.mapFile = argc > 1 ? argv[1] : "../resources/map.txt";
+    config.envCount = argc > 2 ? std::atoi(argv[2]) : 256;
+    int steps = argc > 3 ? std::atoi(argv[3]) : 2000;
+    config.threads = argc > 4 ? std::atoi(argv[4]) : 0;
+    if (config.envCount <= 0 || steps <= 0) {
+        std::fprintf(stderr, "usage: %s [map] [envs] [steps] [threads]\n", argv[0]);
+        return 1;
+    }
+
+    BatchEnvironment batch;
+    if (!batch.init(config)) {
+        std::fprintf(stderr, "failed to load map %s\n", config.mapFile.c_str());
+        return 1;
+    }
+
+    // Буферы выделяются один раз, как это сделал бы цикл обучения
+    const size_t envs = static_cast<size_t>(batch.getEnvCount());
+    std::vector<uint8_t> observations(envs * batch.getObservationSize());
+    std::vector<uint8_t> actions(envs);
+    std::vector<float> rewards(envs);
+    std::vector<uint8_t> dones(envs);
+    std::mt19937 rng(1);
+
+    batch.reset(observations.data());
+    double totalReward = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int s = 0; s < steps; ++s) {
+        for (auto& action : actions) {
+            action = static_cast<uint8_t>(rng() % BatchEnvironment::ACTION_COUNT);
+        }
+        batch.step(actions.data(), observations.data(), rewards.data(), dones.data());
+        for (float reward : rewards) {
+            totalReward += reward;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%zu envs, %d steps, observation %zu bytes (%dx%d x %d channels)\n",
+                envs, steps, batch.getObservationSize(), batch.getViewSide(), batch.getViewSide(),
+                static_cast<int>(BatchEnvironment::CHANNELS));
+    std::printf("%.0f env-steps/s, %.1f us per batch step, %llu episodes, mean reward per step %.4f\n",
+                envs * steps / seconds, seconds * 1e6 / steps,
+                static_cast<unsigned long long>(batch.getEpisodeCount()), totalReward / (double(envs) * steps));
+    return 0;
+}
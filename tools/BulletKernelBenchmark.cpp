@@ -0,0 +1,231 @@
+// Бенчмарк ядер движения пуль, проверки стен и узкой фазы пуля-танк (скалярное, SSE2, AVX2)
+// в сравнении с прежней схемой: виртуальный update у каждого объекта, floor, деление и getTile,
+// попарная проверка боксов с dynamic_cast.
+// Использование: bullet-kernel-benchmark [число пуль] [шагов] [размер карты] [число танков]
+#include "model/BulletArray.h"
+#include "model/GameMap.h"
+#include "model/MapGenerator.h"
+#include "model/TankHitKernel.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+constexpr float TILE_SIZE = 40.0f;
+constexpr float TANK_SIZE = 36.0f;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Пуля как отдельный объект с виртуальным шагом - так пули хранились раньше
+struct ObjectBase {
+    virtual ~ObjectBase() = default;
+    virtual void update() = 0;
+    float x = 0;
+    float y = 0;
+    bool destroyed = false;
+};
+
+struct ObjectBullet : ObjectBase {
+    Direction direction = Direction::UP;
+    float speed = BulletArray::DEFAULT_SPEED;
+    void update() override {
+        switch (direction) {
+            case Direction::UP:    y -= speed; break;
+            case Direction::DOWN:  y += speed; break;
+            case Direction::LEFT:  x -= speed; break;
+            case Direction::RIGHT: x += speed; break;
+        }
+    }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int steps = argc > 2 ? std::atoi(argv[2]) : 200;
+    int mapSize = argc > 3 ? std::atoi(argv[3]) : 512;
+    int tankCount = argc > 4 ? std::atoi(argv[4]) : 64;
+    if (count <= 0 || steps <= 0 || mapSize < 8 || tankCount <= 0) {
+        std::fprintf(stderr, "usage: %s [bullets] [steps] [map size] [tanks]\n", argv[0]);
+        return 1;
+    }
+
+    MapGeneratorParams params;
+    params.width = mapSize;
+    params.height = mapSize;
+    params.wallDensity = 0.05;
+    std::istringstream mapText(MapGenerator::generate(params));
+    GameMap map;
+    if (!map.loadFromStream(mapText)) {
+        std::fprintf(stderr, "failed to build map\n");
+        return 1;
+    }
+
+    // Пули в случайных свободных тайлах со случайными направлениями
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> coordinate(0.0f, mapSize * TILE_SIZE);
+    BulletArray prototype;
+    prototype.reserve(count);
+    std::vector<std::unique_ptr<ObjectBullet>> objects;
+    objects.reserve(count);
+    while (static_cast<int>(prototype.size()) < count) {
+        float x = coordinate(rng);
+        float y = coordinate(rng);
+        if (map.getTile(static_cast<int>(x / TILE_SIZE), static_cast<int>(y / TILE_SIZE)) == TileType::Wall) {
+            continue;
+        }
+        Direction dir = static_cast<Direction>(rng() % 4);
+        prototype.add(static_cast<uint32_t>(prototype.size() + 1), x, y, dir, rng() % 2 == 0);
+        auto object = std::make_unique<ObjectBullet>();
+        object->x = x;
+        object->y = y;
+        object->direction = dir;
+        objects.push_back(std::move(object));
+    }
+    std::printf("%d bullets, %d steps, %dx%d map, best kernel: %s\n", count, steps, mapSize, mapSize,
+                BulletArray::getKernelName(BulletArray::getBestKernel()));
+
+    // Прежняя схема (уничтоженные пули не удаляются, чтобы объем работы был одинаковым)
+    std::vector<ObjectBase*> pointers;
+    for (auto& object : objects) {
+        pointers.push_back(object.get());
+    }
+    auto start = Clock::now();
+    for (int s = 0; s < steps; ++s) {
+        for (ObjectBase* object : pointers) {
+            object->update();
+        }
+        for (ObjectBase* object : pointers) {
+            int tileX = static_cast<int>(std::floor(object->x / TILE_SIZE));
+            int tileY = static_cast<int>(std::floor(object->y / TILE_SIZE));
+            if (tileX < 0 || tileX >= map.getWidth() || tileY < 0 || tileY >= map.getHeight() ||
+                map.getTile(tileX, tileY) == TileType::Wall) {
+                object->destroyed = true;
+            }
+        }
+    }
+    double objectSeconds = secondsSince(start);
+    size_t objectHits = 0;
+    for (auto& object : objects) {
+        objectHits += object->destroyed;
+    }
+    std::printf("%-8s %8.2f ns/bullet-step  %zu hit walls\n", "objects",
+                objectSeconds * 1e9 / (double(count) * steps), objectHits);
+
+    const BulletArray::Kernel kernels[] = {BulletArray::Kernel::Scalar, BulletArray::Kernel::SSE2,
+                                           BulletArray::Kernel::AVX2};
+    BulletArray reference;
+    bool haveReference = false;
+    for (BulletArray::Kernel kernel : kernels) {
+        if (static_cast<int>(kernel) > static_cast<int>(BulletArray::getBestKernel())) {
+            std::printf("%-8s not supported by this CPU\n", BulletArray::getKernelName(kernel));
+            continue;
+        }
+        BulletArray bullets = prototype;
+        bullets.setKernel(kernel);
+        start = Clock::now();
+        for (int s = 0; s < steps; ++s) {
+            bullets.integrate();
+            bullets.markWallHits(map.getTileData(), map.getWidth(), map.getHeight(), TILE_SIZE);
+        }
+        double seconds = secondsSince(start);
+        size_t hits = 0;
+        for (size_t i = 0; i < bullets.size(); ++i) {
+            hits += bullets.isDestroyed(i);
+        }
+
+        // Все ядра обязаны давать одно и то же
+        bool same = true;
+        if (haveReference) {
+            for (size_t i = 0; i < bullets.size() && same; ++i) {
+                same = bullets.getX(i) == reference.getX(i) && bullets.getY(i) == reference.getY(i) &&
+                       bullets.isDestroyed(i) == reference.isDestroyed(i);
+            }
+        } else {
+            reference = bullets;
+            haveReference = true;
+        }
+        std::printf("%-8s %8.2f ns/bullet-step  %zu hit walls  %.1fx vs objects%s\n",
+                    BulletArray::getKernelName(kernel), seconds * 1e9 / (double(count) * steps), hits,
+                    objectSeconds / seconds, same ? "" : "  MISMATCH");
+        if (!same) {
+            return 1;
+        }
+    }
+
+    // Узкая фаза: танки собраны в небольшой области, пули разбросаны по ней же,
+    // чтобы заметная часть проверок заканчивалась попаданием
+    const float arena = std::sqrt(static_cast<float>(tankCount)) * TANK_SIZE * 3.0f;
+    std::uniform_real_distribution<float> arenaCoordinate(0.0f, arena);
+    std::vector<std::unique_ptr<GameObject>> tankObjects;
+    std::vector<Tank*> candidates;
+    for (int i = 0; i < tankCount; ++i) {
+        auto tank = std::make_unique<Tank>(arenaCoordinate(rng), arenaCoordinate(rng), Direction::UP, i % 4 == 0);
+        candidates.push_back(tank.get());
+        tankObjects.push_back(std::move(tank));
+    }
+    std::vector<float> shotX(count);
+    std::vector<float> shotY(count);
+    std::vector<uint8_t> shotFromPlayer(count);
+    for (int i = 0; i < count; ++i) {
+        shotX[i] = arenaCoordinate(rng);
+        shotY[i] = arenaCoordinate(rng);
+        shotFromPlayer[i] = prototype.isFromPlayer(i);
+    }
+    std::printf("narrowphase: %d tanks in a %.0fx%.0f area\n", tankCount, arena, arena);
+
+    // Прежний цикл: все объекты, dynamic_cast, ветвление по стороне и четыре сравнения
+    std::vector<int> expected(count, -1);
+    start = Clock::now();
+    for (int i = 0; i < count; ++i) {
+        for (size_t t = 0; t < tankObjects.size(); ++t) {
+            Tank* tank = dynamic_cast<Tank*>(tankObjects[t].get());
+            if (!tank || tank->isDestroyed()) continue;
+            if ((shotFromPlayer[i] != 0) == tank->isPlayer()) continue;
+            if (shotX[i] + BulletArray::RADIUS > tank->getX() && shotX[i] - BulletArray::RADIUS < tank->getX() + TANK_SIZE &&
+                shotY[i] + BulletArray::RADIUS > tank->getY() && shotY[i] - BulletArray::RADIUS < tank->getY() + TANK_SIZE) {
+                expected[i] = static_cast<int>(t);
+                break;
+            }
+        }
+    }
+    double pairSeconds = secondsSince(start);
+    size_t expectedHits = 0;
+    for (int hit : expected) {
+        expectedHits += hit >= 0;
+    }
+    std::printf("%-8s %8.2f ns/bullet  %zu hits\n", "objects", pairSeconds * 1e9 / count, expectedHits);
+
+    TankHitKernel hits(TANK_SIZE);
+    hits.pack(candidates.data(), candidates.size());
+    for (BulletArray::Kernel kernel : kernels) {
+        if (static_cast<int>(kernel) > static_cast<int>(BulletArray::getBestKernel())) {
+            continue;
+        }
+        hits.setKernel(kernel);
+        bool same = true;
+        size_t hitCount = 0;
+        start = Clock::now();
+        for (int i = 0; i < count; ++i) {
+            int hit = hits.findHit(shotX[i], shotY[i], BulletArray::RADIUS, TankHitKernel::targetsOf(shotFromPlayer[i] != 0));
+            hitCount += hit >= 0;
+            same = same && hit == expected[i];
+        }
+        double seconds = secondsSince(start);
+        std::printf("%-8s %8.2f ns/bullet  %zu hits  %.1fx vs objects%s\n", BulletArray::getKernelName(kernel),
+                    seconds * 1e9 / count, hitCount, pairSeconds / seconds, same ? "" : "  MISMATCH");
+        if (!same) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Сервер матчей ИИ против ИИ без окна - для балансировки и длительных прогонов.
+// Пример: match-server --map big.txt --threads 8 --matches 1000 --results results.csv
+#include "server/MatchServer.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+void printUsage(const char* program) {
+    std::fprintf(stderr,
+        "usage: %s [options]\n"
+        "  --map FILE          map file (default ../resources/map.txt)\n"
+        "  --threads N         worker threads, 0 for one per core (default 0)\n"
+        "  --no-pin            do not pin worker threads to cores\n"
+        "  --per-thread N      concurrent matches per thread (default 4)\n"
+        "  --players N         AI-controlled players per match (default 2)\n"
+        "  --slice N           ticks of one match before switching to the next (default 60)\n"
+        "  --max-ticks N       end a match as a timeout after N ticks (default 10800)\n"
+        "  --budget MS         per-tick time budget in milliseconds (default 1.0)\n"
+        "  --seed N            seed of the first match (default 1)\n"
+        "  --matches N         stop after N matches, 0 for no limit (default 0)\n"
+        "  --duration S        stop after S seconds, 0 for no limit (default 30)\n"
+        "  --results FILE      write one CSV line per finished match\n",
+        program);
+}
+
+void printProgress(const MatchThroughput& report) {
+    std::printf("%6.1fs  matches %llu (%.2f/s)  ticks %.0f/s  over budget %llu\n",
+                report.seconds, static_cast<unsigned long long>(report.matchesCompleted),
+                report.matchesPerSecond(), report.ticksPerSecond(),
+                static_cast<unsigned long long>(report.budgetOverruns));
+    std::fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    MatchServerConfig config;
+    double duration = 30;
+    unsigned long long matchLimit = 0;
+    const char* resultsFile = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (!std::strcmp(arg, "--no-pin")) {
+            config.pinThreads = false;
+            continue;
+        }
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!value) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        ++i;
+        if (!std::strcmp(arg, "--map")) config.mapFile = value;
+        else if (!std::strcmp(arg, "--threads")) config.threads = std::atoi(value);
+        else if (!std::strcmp(arg, "--per-thread")) config.matchesPerThread = std::atoi(value);
+        else if (!std::strcmp(arg, "--players")) config.playersPerMatch = std::atoi(value);
+        else if (!std::strcmp(arg, "--slice")) config.ticksPerSlice = std::atoi(value);
+        else if (!std::strcmp(arg, "--max-ticks")) config.maxTicksPerMatch = std::strtoull(value, nullptr, 10);
+        else if (!std::strcmp(arg, "--budget")) config.tickBudgetMs = std::atof(value);
+        else if (!std::strcmp(arg, "--seed")) config.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        else if (!std::strcmp(arg, "--matches")) matchLimit = std::strtoull(value, nullptr, 10);
+        else if (!std::strcmp(arg, "--duration")) duration = std::atof(value);
+        else if (!std::strcmp(arg, "--results")) resultsFile = value;
+        else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (duration <= 0 && matchLimit == 0) {
+        std::fprintf(stderr, "either --duration or --matches must be set\n");
+        return 1;
+    }
+
+    MatchServer server;
+    if (!server.start(config)) {
+        std::fprintf(stderr, "failed to load map %s\n", config.mapFile.c_str());
+        return 1;
+    }
+
+    FILE* results = nullptr;
+    if (resultsFile) {
+        results = std::fopen(resultsFile, "w");
+        if (!results) {
+            std::fprintf(stderr, "failed to open %s\n", resultsFile);
+            return 1;
+        }
+        std::fprintf(results, "match,seed,worker,ticks,score,timed_out,avg_tick_ms,max_tick_ms,over_budget\n");
+        server.setResultCallback([results](const MatchResult& r) {
+            std::fprintf(results, "%llu,%u,%d,%llu,%d,%d,%.4f,%.4f,%llu\n",
+                         static_cast<unsigned long long>(r.matchIndex), r.seed, r.worker,
+                         static_cast<unsigned long long>(r.ticks), r.score, r.timedOut ? 1 : 0,
+                         r.ticks ? r.totalTickMs / r.ticks : 0.0, r.maxTickMs,
+                         static_cast<unsigned long long>(r.budgetOverruns));
+        });
+    }
+
+    std::printf("map %s (%dx%d, loaded once), %d threads x %d matches, %d players per match\n",
+                config.mapFile.c_str(), server.getLayout()->width, server.getLayout()->height,
+                server.getThreadCount(), std::max(1, config.matchesPerThread), config.playersPerMatch);
+    MatchThroughput report = server.run(duration, matchLimit, printProgress, 5.0);
+    if (results) {
+        std::fclose(results);
+    }
+
+    std::printf("\n%.1f s, %llu matches (%.2f matches/s), %llu ticks (%.0f ticks/s), %llu ticks over %.2f ms budget\n",
+                report.seconds, static_cast<unsigned long long>(report.matchesCompleted), report.matchesPerSecond(),
+                static_cast<unsigned long long>(report.ticks), report.ticksPerSecond(),
+                static_cast<unsigned long long>(report.budgetOverruns), config.tickBudgetMs);
+    std::printf("thread | pinned | ticks/s | busy\n");
+    for (size_t i = 0; i < report.ticksPerThread.size(); ++i) {
+        std::printf("%6zu | %6s | %7.0f | %3.0f%%\n", i, report.threadPinned[i] ? "yes" : "no",
+                    report.seconds > 0 ? report.ticksPerThread[i] / report.seconds : 0.0,
+                    report.seconds > 0 ? 100.0 * report.busySecondsPerThread[i] / report.seconds : 0.0);
+    }
+    return 0;
+}
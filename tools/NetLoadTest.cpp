@@ -0,0 +1,290 @@
+// Нагрузочный тест сетевой игры на одной машине: сервер и боты - отдельные процессы,
+// общающиеся через loopback. Для каждого числа игроков печатается трафик на клиента
+// и время тика сервера.
+// Пример: net-load-test --players 1,2,4,8 --duration 10
+// Режимы отдельных процессов (запускаются самим тестом):
+//   net-load-test --serve --port N --map FILE --duration S
+//   net-load-test --bot --port N --map FILE --duration S --seed N
+#include "model/GameMap.h"
+#include "model/MapGenerator.h"
+#include "net/GameClient.h"
+#include "net/GameServer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+namespace {
+
+struct Options {
+    enum class Mode { Orchestrate, Serve, Bot } mode = Mode::Orchestrate;
+    int port = 47100;
+    std::string mapFile;
+    double duration = 10.0;
+    unsigned seed = 1;
+    std::vector<int> playerCounts{1, 2, 4, 8};
+    int mapSize = 96;
+    int enemies = 40;
+};
+
+void printUsage(const char* program) {
+    std::fprintf(stderr,
+        "usage: %s [options]\n"
+        "  --players LIST   comma-separated player counts (default 1,2,4,8)\n"
+        "  --duration S     seconds per run (default 10)\n"
+        "  --port N         first UDP port (default 47100)\n"
+        "  --map FILE       map file (default: generated)\n"
+        "  --map-size N     side of the generated map in tiles (default 96)\n"
+        "  --enemies N      enemy spawns on the generated map (default 40)\n",
+        program);
+}
+
+// Ровно одна строка "RESULT ..." на stdout - ее читает оркестратор
+int runServer(const Options& options) {
+    GameServerConfig config;
+    config.port = static_cast<uint16_t>(options.port);
+    config.mapFile = options.mapFile;
+    config.maxClients = GameModel::MAX_PLAYERS;
+    GameServer server;
+    if (!server.start(config)) {
+        std::fprintf(stderr, "server: failed to start on port %d\n", options.port);
+        return 1;
+    }
+    server.run(options.duration);
+    const auto& stats = server.getStats();
+    std::printf("RESULT %llu %.4f %.4f %.4f %llu %zu\n",
+                static_cast<unsigned long long>(stats.ticks),
+                stats.ticks ? stats.totalTickMs / stats.ticks : 0.0,
+                server.getTickPercentile(0.99), stats.maxTickMs,
+                static_cast<unsigned long long>(stats.bytesSent), server.getClientStats().size());
+    server.stop();
+    return 0;
+}
+
+// Бот держит случайное управление по полсекунды и живет duration секунд
+int runBot(const Options& options) {
+    GameMap map;
+    NetAddress server;
+    if (!map.loadFromFile(options.mapFile) ||
+        !NetAddress::parse("127.0.0.1:" + std::to_string(options.port), server)) {
+        return 1;
+    }
+    GameClient client;
+    if (!client.connect(server, map, 5.0)) {
+        std::fprintf(stderr, "bot: failed to connect\n");
+        return 1;
+    }
+    std::mt19937 rng(options.seed);
+    PlayerInput input;
+    GameSnapshot state;
+    using Clock = std::chrono::steady_clock;
+    const auto tickLength = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / NetProtocol::TICK_RATE));
+    const auto start = Clock::now();
+    auto nextTick = start;
+    uint64_t connectedBytes = client.getStats().bytesReceived;
+    for (int tick = 0; Clock::now() - start < std::chrono::duration<double>(options.duration); ++tick) {
+        if (tick % (NetProtocol::TICK_RATE / 2) == 0) {
+            input.move = rng() % 4 != 0;
+            input.moveDirection = static_cast<Direction>(rng() % 4);
+            input.fire = rng() % 2 == 0;
+        }
+        client.sendInput(input);
+        client.poll();
+        if (!client.isConnected()) {
+            break;
+        }
+        client.getInterpolatedState(state);
+        nextTick += tickLength;
+        std::this_thread::sleep_until(nextTick);
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    const auto& stats = client.getStats();
+    std::printf("RESULT %.3f %llu %llu %llu %llu\n", seconds,
+                static_cast<unsigned long long>(stats.bytesReceived - connectedBytes),
+                static_cast<unsigned long long>(stats.bytesSent),
+                static_cast<unsigned long long>(stats.snapshotsReceived),
+                static_cast<unsigned long long>(stats.snapshotsDropped));
+    client.disconnect();
+    return 0;
+}
+
+std::string readResult(FILE* pipe) {
+    std::string result;
+    char line[512];
+    while (std::fgets(line, sizeof(line), pipe)) {
+        if (!std::strncmp(line, "RESULT ", 7)) {
+            result = line + 7;
+        }
+    }
+    return result;
+}
+
+// Сгенерированная карта живет только на время теста
+struct TemporaryFile {
+    std::string path;
+    ~TemporaryFile() {
+        if (!path.empty()) {
+            std::error_code error;
+            std::filesystem::remove(path, error);
+        }
+    }
+};
+
+int orchestrate(const Options& options, const char* program) {
+    Options run = options;
+    TemporaryFile generatedMap;
+    if (run.mapFile.empty()) {
+        MapGeneratorParams params;
+        params.width = options.mapSize;
+        params.height = options.mapSize;
+        params.roomCount = options.mapSize * options.mapSize / 400;
+        params.playerSpawns = GameModel::MAX_PLAYERS;
+        params.enemySpawns = options.enemies;
+        std::error_code error;
+        std::filesystem::path directory = std::filesystem::temp_directory_path(error);
+        if (error) {
+            directory = ".";
+        }
+        // Процессы сервера и ботов читают карту из файла; имя уникально для параллельных запусков
+        run.mapFile = (directory / ("net-load-test-map-" + std::to_string(std::random_device{}()) + ".txt")).string();
+        generatedMap.path = run.mapFile;
+        if (!MapGenerator::writeToFile(params, run.mapFile)) {
+            std::fprintf(stderr, "failed to write %s\n", run.mapFile.c_str());
+            return 1;
+        }
+    }
+
+    std::printf("map %s, %.0f s per run\n", run.mapFile.c_str(), run.duration);
+    std::printf("players | kbit/s per client (avg / max) | snapshots/s | dropped | tick avg / p99 / max, ms\n");
+    for (size_t i = 0; i < options.playerCounts.size(); ++i) {
+        int players = options.playerCounts[i];
+        int port = options.port + static_cast<int>(i);
+        std::string common = " --port " + std::to_string(port) + " --map \"" + run.mapFile + "\"";
+
+        // Сервер живет дольше ботов, чтобы все успели подключиться и отключиться
+        std::string serverCommand = std::string("\"") + program + "\" --serve" + common +
+                                    " --duration " + std::to_string(run.duration + 2.0);
+        FILE* serverPipe = popen(serverCommand.c_str(), "r");
+        if (!serverPipe) {
+            std::fprintf(stderr, "failed to start server process\n");
+            return 1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+        std::vector<FILE*> botPipes;
+        for (int bot = 0; bot < players; ++bot) {
+            std::string botCommand = std::string("\"") + program + "\" --bot" + common +
+                                     " --duration " + std::to_string(run.duration) +
+                                     " --seed " + std::to_string(bot + 1);
+            if (FILE* pipe = popen(botCommand.c_str(), "r")) {
+                botPipes.push_back(pipe);
+            }
+        }
+
+        double totalKbps = 0, maxKbps = 0, totalSnapshotRate = 0;
+        unsigned long long totalDropped = 0;
+        int reported = 0;
+        for (FILE* pipe : botPipes) {
+            std::istringstream result(readResult(pipe));
+            pclose(pipe);
+            double seconds = 0;
+            unsigned long long received = 0, sent = 0, snapshots = 0, dropped = 0;
+            if (!(result >> seconds >> received >> sent >> snapshots >> dropped) || seconds <= 0) {
+                continue;
+            }
+            double kbps = received * 8.0 / 1000.0 / seconds;
+            totalKbps += kbps;
+            maxKbps = std::max(maxKbps, kbps);
+            totalSnapshotRate += snapshots / seconds;
+            totalDropped += dropped;
+            ++reported;
+        }
+
+        std::istringstream serverResult(readResult(serverPipe));
+        pclose(serverPipe);
+        unsigned long long ticks = 0, bytesSent = 0;
+        double tickAvg = 0, tickP99 = 0, tickMax = 0;
+        size_t clients = 0;
+        serverResult >> ticks >> tickAvg >> tickP99 >> tickMax >> bytesSent >> clients;
+
+        if (reported == 0) {
+            std::printf("%7d | no bots reported\n", players);
+            continue;
+        }
+        std::printf("%7d | %14.1f / %-12.1f | %11.1f | %7llu | %.3f / %.3f / %.3f%s\n",
+                    players, totalKbps / reported, maxKbps, totalSnapshotRate / reported, totalDropped,
+                    tickAvg, tickP99, tickMax,
+                    reported < players ? "  (some bots failed)" : "");
+        std::fflush(stdout);
+    }
+    return 0;
+}
+
+bool parsePlayerCounts(const char* text, std::vector<int>& out) {
+    out.clear();
+    std::istringstream input(text);
+    std::string item;
+    while (std::getline(input, item, ',')) {
+        int count = std::atoi(item.c_str());
+        if (count < 1 || count > GameModel::MAX_PLAYERS) {
+            return false;
+        }
+        out.push_back(count);
+    }
+    return !out.empty();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (!std::strcmp(arg, "--serve")) { options.mode = Options::Mode::Serve; continue; }
+        if (!std::strcmp(arg, "--bot")) { options.mode = Options::Mode::Bot; continue; }
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!value) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        ++i;
+        if (!std::strcmp(arg, "--port")) options.port = std::atoi(value);
+        else if (!std::strcmp(arg, "--map")) options.mapFile = value;
+        else if (!std::strcmp(arg, "--duration")) options.duration = std::atof(value);
+        else if (!std::strcmp(arg, "--seed")) options.seed = static_cast<unsigned>(std::atoi(value));
+        else if (!std::strcmp(arg, "--map-size")) options.mapSize = std::atoi(value);
+        else if (!std::strcmp(arg, "--enemies")) options.enemies = std::atoi(value);
+        else if (!std::strcmp(arg, "--players")) {
+            if (!parsePlayerCounts(value, options.playerCounts)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.duration <= 0 || options.mapSize < 16) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    switch (options.mode) {
+        case Options::Mode::Serve: return runServer(options);
+        case Options::Mode::Bot: return runBot(options);
+        default: return orchestrate(options, argv[0]);
+    }
+}
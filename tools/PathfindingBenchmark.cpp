@@ -0,0 +1,208 @@
+// Бенчмарк иерархического поиска пути на больших картах.
+// Использование: pathfinding-benchmark [ширина] [высота] [плотность стен] [число запросов] [размер кластера]
+#include "model/GameMap.h"
+#include "model/HierarchicalPathfinder.h"
+#include "model/MapGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using TilePos = HierarchicalPathfinder::TilePos;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Обычный A* по всей сетке - для сравнения
+bool flatAStar(const GameMap& map, TilePos start, TilePos goal, size_t& outLength) {
+    const int w = map.getWidth();
+    const int h = map.getHeight();
+    std::vector<int> cost(static_cast<size_t>(w) * h, -1);
+    using Item = std::pair<int, int>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<>> open;
+    auto heuristic = [&](int x, int y) { return std::abs(x - goal.first) + std::abs(y - goal.second); };
+
+    int startIdx = start.second * w + start.first;
+    cost[startIdx] = 0;
+    open.push({heuristic(start.first, start.second), startIdx});
+    static constexpr int DX[4] = {1, -1, 0, 0};
+    static constexpr int DY[4] = {0, 0, 1, -1};
+    while (!open.empty()) {
+        auto [f, idx] = open.top();
+        open.pop();
+        int x = idx % w;
+        int y = idx / w;
+        if (f != cost[idx] + heuristic(x, y)) continue;
+        if (x == goal.first && y == goal.second) {
+            outLength = static_cast<size_t>(cost[idx]) + 1;
+            return true;
+        }
+        for (int k = 0; k < 4; ++k) {
+            int nx = x + DX[k];
+            int ny = y + DY[k];
+            if (map.getTile(nx, ny) == TileType::Wall) continue;
+            int next = ny * w + nx;
+            if (cost[next] >= 0 && cost[next] <= cost[idx] + 1) continue;
+            cost[next] = cost[idx] + 1;
+            open.push({cost[next] + heuristic(nx, ny), next});
+        }
+    }
+    return false;
+}
+
+// Путь начинается в start, кончается в goal, и каждый шаг - на соседний проходимый тайл
+bool isValidPath(const GameMap& map, const HierarchicalPathfinder::Path& path, TilePos start, TilePos goal) {
+    if (path.empty() || path.front() != start || path.back() != goal) {
+        return false;
+    }
+    for (size_t i = 0; i < path.size(); ++i) {
+        if (map.getTile(path[i].first, path[i].second) == TileType::Wall) {
+            return false;
+        }
+        if (i > 0 && std::abs(path[i].first - path[i - 1].first) + std::abs(path[i].second - path[i - 1].second) != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int width = argc > 1 ? std::atoi(argv[1]) : 1024;
+    int height = argc > 2 ? std::atoi(argv[2]) : 1024;
+    double density = argc > 3 ? std::atof(argv[3]) : 0.2;
+    int queries = argc > 4 ? std::atoi(argv[4]) : 2000;
+    int clusterSize = argc > 5 ? std::atoi(argv[5]) : 16;
+    if (width < 4 || height < 4 || queries <= 0 || clusterSize < 2) {
+        std::fprintf(stderr, "usage: %s [width] [height] [wall density] [queries] [cluster size]\n", argv[0]);
+        return 1;
+    }
+
+    MapGeneratorParams params;
+    params.width = width;
+    params.height = height;
+    params.wallDensity = density;
+    params.seed = 12345;
+    std::mt19937 rng(12345);
+    std::istringstream mapText(MapGenerator::generate(params));
+    GameMap map;
+    if (!map.loadFromStream(mapText)) {
+        std::fprintf(stderr, "failed to build map\n");
+        return 1;
+    }
+
+    HierarchicalPathfinder pathfinder(clusterSize);
+    auto buildStart = Clock::now();
+    pathfinder.build(map);
+    pathfinder.prepare(); // Иначе граф построился бы внутри первого запроса
+    std::printf("map %dx%d, density %.2f\n", width, height, density);
+    std::printf("build: %.1f ms, %d clusters, %d portals\n",
+                secondsSince(buildStart) * 1000.0, pathfinder.getClusterCount(), pathfinder.getPortalCount());
+
+    // Пары случайных проходимых тайлов
+    std::uniform_int_distribution<int> randX(1, width - 2);
+    std::uniform_int_distribution<int> randY(1, height - 2);
+    auto randomFree = [&]() {
+        while (true) {
+            TilePos p{randX(rng), randY(rng)};
+            if (map.getTile(p.first, p.second) != TileType::Wall) return p;
+        }
+    };
+    std::vector<std::pair<TilePos, TilePos>> pairs(queries);
+    for (auto& pair : pairs) {
+        pair = {randomFree(), randomFree()};
+    }
+
+    HierarchicalPathfinder::Path path;
+    int found = 0;
+    size_t totalLength = 0;
+    auto coldStart = Clock::now();
+    for (const auto& pair : pairs) {
+        if (pathfinder.findPath(pair.first, pair.second, path)) {
+            ++found;
+            totalLength += path.size();
+        }
+    }
+    double coldTime = secondsSince(coldStart);
+    std::printf("uncached: %.0f queries/s (%d/%d found, avg length %.1f)\n",
+                queries / coldTime, found, queries, found ? double(totalLength) / found : 0.0);
+
+    // Проверка путей и сравнение с обычным A* - на той же карте, до правок ниже.
+    // Пути берутся повторным проходом, чтобы проверка не входила в замер
+    const int flatQueries = std::min(queries, 200);
+    int invalidPaths = 0;
+    std::vector<size_t> hierLength(pairs.size(), 0); // 0 - путь не найден
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        if (pathfinder.findPath(pairs[i].first, pairs[i].second, path)) {
+            hierLength[i] = path.size();
+            if (!isValidPath(map, path, pairs[i].first, pairs[i].second)) ++invalidPaths;
+        }
+    }
+    std::printf("validated: %d/%d paths with broken steps or endpoints\n", invalidPaths, found);
+
+    int flatFound = 0;
+    int agreement = 0;
+    int compared = 0;
+    int longer = 0;
+    double ratioSum = 0.0;
+    double maxRatio = 1.0;
+    std::vector<size_t> flatLength(flatQueries, 0);
+    auto flatStart = Clock::now();
+    for (int i = 0; i < flatQueries; ++i) {
+        if (flatAStar(map, pairs[i].first, pairs[i].second, flatLength[i])) ++flatFound;
+    }
+    double flatTime = secondsSince(flatStart);
+    for (int i = 0; i < flatQueries; ++i) {
+        const bool flatReached = flatLength[i] > 0;
+        if (flatReached == (hierLength[i] > 0)) ++agreement;
+        if (flatReached && hierLength[i] > 0) {
+            double ratio = double(hierLength[i]) / double(flatLength[i]);
+            ++compared;
+            ratioSum += ratio;
+            maxRatio = std::max(maxRatio, ratio);
+            if (hierLength[i] > flatLength[i]) ++longer;
+        }
+    }
+    std::printf("flat A*: %.0f queries/s (%d/%d found)\n", flatQueries / flatTime, flatFound, flatQueries);
+    std::printf("vs flat A*: reachability agrees %d/%d, length ratio mean %.3f max %.3f, %d/%d longer than shortest\n",
+                agreement, flatQueries, compared > 0 ? ratioSum / compared : 1.0, maxRatio, longer, compared);
+
+    // Повторные запросы по небольшому рабочему набору пар попадают в кэш
+    const int hotSet = std::min(128, queries);
+    for (int i = 0; i < hotSet; ++i) {
+        pathfinder.findPath(pairs[i].first, pairs[i].second, path);
+    }
+    const size_t hitsBefore = pathfinder.getCacheHits();
+    const size_t missesBefore = pathfinder.getCacheMisses();
+    auto hotStart = Clock::now();
+    for (int i = 0; i < queries; ++i) {
+        const auto& pair = pairs[i % hotSet];
+        pathfinder.findPath(pair.first, pair.second, path);
+    }
+    double hotTime = secondsSince(hotStart);
+    std::printf("cached (%d-pair hot set): %.0f queries/s (hits %zu, misses %zu)\n",
+                hotSet, queries / hotTime, pathfinder.getCacheHits() - hitsBefore, pathfinder.getCacheMisses() - missesBefore);
+
+    // Точечные изменения карты с последующим запросом
+    const int edits = std::min(queries, 500);
+    auto editStart = Clock::now();
+    for (int i = 0; i < edits; ++i) {
+        TilePos p = randomFree();
+        map.setTile(p.first, p.second, TileType::Wall);
+        pathfinder.invalidateTile(p.first, p.second);
+        const auto& pair = pairs[i % pairs.size()];
+        pathfinder.findPath(pair.first, pair.second, path);
+    }
+    std::printf("edit + query: %.0f per second\n", edits / secondsSince(editStart));
+    return invalidPaths == 0 && agreement == flatQueries ? 0 : 1;
+}